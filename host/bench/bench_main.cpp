@@ -0,0 +1,313 @@
+// Host microbenchmarks for the firmware hot paths.
+//
+// Usage: program [--out results.json] [--fixture path] [--corpus dir] [--quick]
+//
+// Results are written as JSON ({"benchmarks":[{"name","value","unit","iterations"}]})
+// so two runs can be diffed with host/bench/compare.py.
+
+#include <Arduino.h>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <dirent.h>
+#include <ArduinoJson.h>
+
+#include "DMT_Display.h"
+#include "Mezzo_Controller.h"
+
+struct BenchResult {
+    std::string name;
+    double value;
+    const char* unit;
+    unsigned long iterations;
+};
+
+static std::vector<BenchResult> results;
+static volatile uint32_t benchSink = 0; // Keeps results observable so the optimizer cannot drop the work
+static int benchRounds = 5;
+
+static double nowSeconds() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Run fn(i) for i in [0, iterations) several times and keep the median time per call
+template <typename Fn>
+static double medianNsPerOp(unsigned long iterations, Fn fn) {
+    std::vector<double> samples;
+    for (int round = 0; round < benchRounds; round++) {
+        double start = nowSeconds();
+        for (unsigned long i = 0; i < iterations; i++) {
+            fn(i);
+        }
+        samples.push_back((nowSeconds() - start) * 1e9 / iterations);
+    }
+    std::sort(samples.begin(), samples.end());
+    return samples[samples.size() / 2];
+}
+
+static void report(const char* name, double value, const char* unit, unsigned long iterations) {
+    results.push_back({name, value, unit, iterations});
+    fprintf(stderr, "%-34s %14.2f %-8s (%lu iterations)\n", name, value, unit, iterations);
+}
+
+// ---------------------------------------------------------------------------
+// DMT_Display::handleIncomingData
+// ---------------------------------------------------------------------------
+
+static unsigned long framesSeen = 0;
+
+static void onBenchVPData(uint8_t panel, uint16_t vpAddress, uint16_t vpData) {
+    (void)panel;
+    framesSeen++;
+    benchSink += vpAddress ^ vpData;
+}
+
+// Synthetic panel traffic: slider auto-uploads, write acks and line noise
+static std::vector<uint8_t> buildFrameStream(size_t targetBytes) {
+    std::vector<uint8_t> stream;
+    uint32_t seed = 12345;
+    while (stream.size() < targetBytes) {
+        seed = seed * 1103515245u + 12345u;
+        uint8_t kind = (seed >> 16) % 10;
+        uint16_t vp = 0x1100 + (((seed >> 8) % 4) << 8);
+        uint8_t volume = (seed >> 4) % 101;
+        if (kind < 8) {
+            // 0x83 auto-upload: 5A A5 06 83 VP_H VP_L 01 VV 00
+            const uint8_t frame[] = {DMT_HEADER_1, DMT_HEADER_2, 0x06, DMT_CMD_READ_VP,
+                                     (uint8_t)(vp >> 8), (uint8_t)(vp & 0xFF), 0x01, volume, 0x00};
+            stream.insert(stream.end(), frame, frame + sizeof(frame));
+        } else if (kind == 8) {
+            // Write acknowledgement: 5A A5 03 82 4F 4B ("OK")
+            const uint8_t ack[] = {DMT_HEADER_1, DMT_HEADER_2, 0x03, DMT_CMD_WRITE_VP, 0x4F, 0x4B};
+            stream.insert(stream.end(), ack, ack + sizeof(ack));
+        } else {
+            stream.push_back((uint8_t)(seed >> 24));
+        }
+    }
+    return stream;
+}
+
+// Median bytes/s of feeding the stream through DMT_Display in driver-sized reads
+static double measureDMTStream(const std::vector<uint8_t>& stream) {
+    HardwareSerial benchSerial(1);
+    benchSerial.setRxBufferSize(4096);
+    DMT_Display display(&benchSerial);
+    display.begin(115200);
+    display.setVPDataCallback(onBenchVPData);
+
+    const size_t chunk = 4096;
+    std::vector<double> samples;
+    for (int round = 0; round < benchRounds; round++) {
+        framesSeen = 0;
+        double start = nowSeconds();
+        for (size_t offset = 0; offset < stream.size(); offset += chunk) {
+            size_t len = std::min(chunk, stream.size() - offset);
+            benchSerial.hostInjectRx(&stream[offset], len);
+            display.handleIncomingData();
+        }
+        samples.push_back(stream.size() / (nowSeconds() - start));
+    }
+    std::sort(samples.begin(), samples.end());
+    return samples[samples.size() / 2];
+}
+
+static void benchDMTReceive(bool quick) {
+    std::vector<uint8_t> stream = buildFrameStream(quick ? 64 * 1024 : 1024 * 1024);
+    double bytesPerSecond = measureDMTStream(stream);
+    report("dmt_rx_throughput", bytesPerSecond, "bytes/s", stream.size());
+    report("dmt_rx_frames", bytesPerSecond * framesSeen / stream.size(), "frames/s", framesSeen);
+}
+
+// The fuzzing seed corpus (host/fuzz/corpus) back to back: real frames plus
+// the malformed ones, so parser hardening shows up here if it costs speed
+static bool benchDMTCorpus(bool quick, const char* corpusDir) {
+    std::vector<std::string> files;
+    DIR* dir = opendir(corpusDir);
+    if (dir == nullptr) {
+        fprintf(stderr, "Cannot open corpus %s\n", corpusDir);
+        return false;
+    }
+    while (struct dirent* entry = readdir(dir)) {
+        if (entry->d_name[0] != '.') files.push_back(std::string(corpusDir) + "/" + entry->d_name);
+    }
+    closedir(dir);
+    std::sort(files.begin(), files.end());
+
+    std::vector<uint8_t> corpus;
+    for (size_t i = 0; i < files.size(); i++) {
+        FILE* f = fopen(files[i].c_str(), "rb");
+        if (f == nullptr) continue;
+        uint8_t buf[512];
+        size_t n;
+        while ((n = fread(buf, 1, sizeof(buf), f)) > 0) corpus.insert(corpus.end(), buf, buf + n);
+        fclose(f);
+    }
+    if (corpus.empty()) return false;
+
+    std::vector<uint8_t> stream;
+    size_t targetBytes = quick ? 64 * 1024 : 1024 * 1024;
+    while (stream.size() < targetBytes) stream.insert(stream.end(), corpus.begin(), corpus.end());
+    report("dmt_rx_corpus_throughput", measureDMTStream(stream), "bytes/s", stream.size());
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// Gain mapping
+// ---------------------------------------------------------------------------
+
+static void benchGainMapping(unsigned long iterations) {
+    Mezzo_Controller mezzo("127.0.0.1");
+    HardwareSerial benchSerial(1);
+    DMT_Display display(&benchSerial);
+
+    double ns = medianNsPerOp(iterations, [&](unsigned long i) {
+        uint16_t vpData = 0x0100 | (uint16_t)(i % 101);
+        benchSink += mezzo.calculateGainFromVPData(vpData);
+    });
+    report("calculate_gain_from_vp_data", ns, "ns/op", iterations);
+
+    // Gains along the real curve: (2^(v/10))/1000 for v = 0..100
+    FixedGain gains[101];
+    for (int v = 0; v <= 100; v++) {
+        gains[v] = mezzo.calculateGainFromVPData(0x0100 | v);
+    }
+
+    ns = medianNsPerOp(iterations, [&](unsigned long i) {
+        benchSink += mezzo.mapGainToVP(gains[i % 101]);
+    });
+    report("mezzo_map_gain_to_vp", ns, "ns/op", iterations);
+
+    ns = medianNsPerOp(iterations, [&](unsigned long i) {
+        benchSink += display.mapGainToVP(gains[i % 101]);
+    });
+    report("dmt_map_gain_to_vp", ns, "ns/op", iterations);
+}
+
+// ---------------------------------------------------------------------------
+// JSON payloads
+// ---------------------------------------------------------------------------
+
+static ZoneInfo benchZones[] = {
+    {0x1100, 1868704443, 5, "Zone 1"},
+    {0x1200, 4127125796, 6, "Zone 2"},
+    {0x1300, 2170320302, 7, "Zone 3"},
+    {0x1400, 2525320065, 8, "Zone 4"}
+};
+
+static String loadFixture(const char* path) {
+    FILE* f = fopen(path, "rb");
+    if (f == nullptr) return String();
+    String content;
+    char buf[512];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), f)) > 0) {
+        content.concat(buf, (unsigned int)n);
+    }
+    fclose(f);
+    return content;
+}
+
+static bool benchJson(unsigned long iterations, const char* fixturePath) {
+    Mezzo_Controller mezzo("127.0.0.1");
+    mezzo.setZones(benchZones, 4);
+
+    String payload;
+    double ns = medianNsPerOp(iterations, [&](unsigned long i) {
+        FixedGain gain = mezzo.calculateGainFromVPData(0x0100 | (uint16_t)(i % 101));
+        mezzo.buildGainPayload(i % 4, gain, payload);
+        benchSink += payload.length();
+    });
+    report("build_gain_payload", ns, "ns/op", iterations);
+
+    String response = loadFixture(fixturePath);
+    if (response.length() == 0) {
+        fprintf(stderr, "Cannot read fixture %s\n", fixturePath);
+        return false;
+    }
+
+    ns = medianNsPerOp(iterations, [&](unsigned long) {
+        JsonDocument doc;
+        DeserializationError err = deserializeJson(doc, response);
+        benchSink += err ? 1 : doc["Code"].as<int>();
+    });
+    report("deserialize_zone_controls", ns, "ns/op", iterations);
+
+    ns = medianNsPerOp(iterations, [&](unsigned long) {
+        benchSink += mezzo.parseGainResponse(response);
+    });
+    report("parse_gain_response", ns, "ns/op", iterations);
+    return true;
+}
+
+// ---------------------------------------------------------------------------
+// Zone lookup
+// ---------------------------------------------------------------------------
+
+static void benchFindZoneIndex(unsigned long iterations, int numZones) {
+    std::vector<ZoneInfo> zones;
+    for (int i = 0; i < numZones; i++) {
+        zones.push_back({(uint16_t)(0x1100 + i * 0x10), 1000000000u + i, 5 + i, "Zone"});
+    }
+    Mezzo_Controller mezzo("127.0.0.1");
+    mezzo.setZones(zones.data(), numZones);
+
+    // Uniform touches across all zones: the average case of the linear scan
+    double ns = medianNsPerOp(iterations, [&](unsigned long i) {
+        benchSink += mezzo.findZoneIndex(zones[i % numZones].vpAddr);
+    });
+    char name[32];
+    snprintf(name, sizeof(name), "find_zone_index_%d", numZones);
+    report(name, ns, "ns/op", iterations);
+}
+
+// ---------------------------------------------------------------------------
+
+static bool writeResults(const char* path) {
+    FILE* f = path ? fopen(path, "w") : stdout;
+    if (f == nullptr) return false;
+    fprintf(f, "{\n  \"benchmarks\": [\n");
+    for (size_t i = 0; i < results.size(); i++) {
+        fprintf(f, "    {\"name\": \"%s\", \"value\": %.4f, \"unit\": \"%s\", \"iterations\": %lu}%s\n",
+                results[i].name.c_str(), results[i].value, results[i].unit, results[i].iterations,
+                i + 1 < results.size() ? "," : "");
+    }
+    fprintf(f, "  ]\n}\n");
+    if (f != stdout) fclose(f);
+    return true;
+}
+
+int main(int argc, char** argv) {
+    const char* outPath = nullptr;
+    const char* fixturePath = "host/fixtures/zone-controls-5.json";
+    const char* corpusDir = "host/fuzz/corpus";
+    bool quick = false;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--out") == 0 && i + 1 < argc) {
+            outPath = argv[++i];
+        } else if (strcmp(argv[i], "--fixture") == 0 && i + 1 < argc) {
+            fixturePath = argv[++i];
+        } else if (strcmp(argv[i], "--corpus") == 0 && i + 1 < argc) {
+            corpusDir = argv[++i];
+        } else if (strcmp(argv[i], "--quick") == 0) {
+            quick = true;
+        } else {
+            fprintf(stderr, "Usage: %s [--out results.json] [--fixture path] [--corpus dir] [--quick]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    if (quick) benchRounds = 3;
+    unsigned long iterations = quick ? 20000 : 200000;
+
+    benchDMTReceive(quick);
+    if (!benchDMTCorpus(quick, corpusDir)) return 1;
+    benchGainMapping(iterations);
+    if (!benchJson(iterations / 4, fixturePath)) return 1;
+    benchFindZoneIndex(iterations, 4);
+    benchFindZoneIndex(iterations, 64);
+    benchFindZoneIndex(iterations, 256);
+
+    return writeResults(outPath) ? 0 : 1;
+}
@@ -0,0 +1,54 @@
+#!/usr/bin/env python3
+"""Compare two benchmark result files written by the bench environment.
+
+Usage: compare.py baseline.json current.json [--threshold PERCENT]
+
+Units ending in "/s" are throughputs (higher is better); everything else
+is a cost (lower is better). Exits with status 1 if any benchmark regressed
+by more than the threshold (default 10%).
+"""
+import argparse
+import json
+import sys
+
+
+def load(path):
+    with open(path) as f:
+        return {b["name"]: b for b in json.load(f)["benchmarks"]}
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    parser.add_argument("baseline")
+    parser.add_argument("current")
+    parser.add_argument("--threshold", type=float, default=10.0)
+    args = parser.parse_args()
+
+    base = load(args.baseline)
+    cur = load(args.current)
+    regressions = 0
+
+    print(f"{'benchmark':34} {'baseline':>14} {'current':>14} {'change':>9}")
+    for name, c in cur.items():
+        b = base.get(name)
+        if b is None or b["value"] == 0:
+            print(f"{name:34} {'-':>14} {c['value']:14.2f} {'new':>9}")
+            continue
+        change = (c["value"] - b["value"]) / b["value"] * 100.0
+        higher_is_better = c["unit"].endswith("/s")
+        worse = -change if higher_is_better else change
+        flag = ""
+        if worse > args.threshold:
+            flag = "  REGRESSION"
+            regressions += 1
+        print(f"{name:34} {b['value']:14.2f} {c['value']:14.2f} {change:+8.1f}%{flag}")
+
+    for name in base:
+        if name not in cur:
+            print(f"{name:34} {base[name]['value']:14.2f} {'-':>14} {'removed':>9}")
+
+    return 1 if regressions else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
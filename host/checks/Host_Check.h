@@ -0,0 +1,26 @@
+#ifndef HOST_CHECK_H
+#define HOST_CHECK_H
+
+#include <Arduino.h>
+#include "Mezzo_Controller.h"
+
+// Zones the suites hand to their controllers, the firmware's included
+#define CHECK_ZONE_COUNT 2
+extern ZoneInfo checkZones[CHECK_ZONE_COUNT];
+
+// Counts a failed check and prints it; passing checks only with --verbose
+void check(bool ok, const char* what, const char* detail);
+bool checkVerbose();
+int checkFailures();
+
+// Loopback port of this process only, so runs can go side by side
+uint16_t checkPort(int index);
+
+// Suites, one file each
+void runGainChecks();       // gain_checks.cpp: fixed-point gain round trip
+void runUdpChecks();        // udp_checks.cpp: OSC and panel sync listeners
+void runMirrorChecks();     // mirror_checks.cpp: slider mirroring between panels
+void runZoneApiChecks();    // zone_api_checks.cpp: zone PUT on the JSON arena
+void runCaptureChecks();    // capture_checks.cpp: DGUS capture ring and dump
+
+#endif // HOST_CHECK_H
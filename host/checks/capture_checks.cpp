@@ -0,0 +1,80 @@
+// DGUS capture ring (lib/DMT_Capture).
+//
+// A text write is up to 258 bytes on the wire. Frames of every length up to
+// that go through the ring, past its end so the oldest are overwritten, and
+// must come back whole and in order from the dump.
+
+#include <Arduino.h>
+#include <string>
+#include <vector>
+
+#include "DMT_Capture.h"
+#include "Host_Check.h"
+
+// Print sink for the dump
+class StringPrint : public Print {
+public:
+    std::string text;
+
+    size_t write(uint8_t c) override {
+        text += (char)c;
+        return 1;
+    }
+};
+
+// Frame bytes of the "<R|T> <delta us> <hex>" lines, in order
+static std::vector<std::string> dumpedFrames(const std::string& text) {
+    std::vector<std::string> frames;
+    size_t start = 0;
+    while (start < text.size()) {
+        size_t end = text.find('\n', start);
+        if (end == std::string::npos) end = text.size();
+        std::string line = text.substr(start, end - start);
+        start = end + 1;
+        if (line.size() < 2 || (line[0] != 'R' && line[0] != 'T') || line[1] != ' ') continue;
+        size_t hex = line.find(' ', 2);
+        std::string bytes;
+        for (size_t i = hex + 1; i + 1 < line.size(); i += 2) {
+            bytes += (char)strtoul(line.substr(i, 2).c_str(), nullptr, 16);
+        }
+        frames.push_back(bytes);
+    }
+    return frames;
+}
+
+static std::string testFrame(size_t length, int seed) {
+    std::string frame;
+    for (size_t i = 0; i < length; i++) frame += (char)(seed * 31 + i);
+    return frame;
+}
+
+void runCaptureChecks() {
+    static DMT_Capture capture;
+    std::vector<std::string> recorded;
+    uint32_t atUs = 0;
+    for (size_t length = 1; length <= DMT_CAPTURE_MAX_FRAME; length++) {
+        std::string frame = testFrame(length, (int)length);
+        atUs += 1000;
+        capture.append(length % 2 ? DMT_CAPTURE_RX : DMT_CAPTURE_TX, (const uint8_t*)frame.data(),
+                       frame.size(), atUs);
+        recorded.push_back(frame);
+    }
+
+    StringPrint out;
+    capture.dump(out);
+    std::vector<std::string> frames = dumpedFrames(out.text);
+
+    // The ring keeps the newest records
+    size_t kept = capture.getRecordCount();
+    size_t first = recorded.size() - kept;
+    bool whole = frames.size() == kept;
+    for (size_t i = 0; whole && i < kept; i++) whole = frames[i] == recorded[first + i];
+
+    char detail[64];
+    snprintf(detail, sizeof(detail), "%u frames, %lu kept, %lu overwritten", (unsigned)recorded.size(),
+             (unsigned long)kept, (unsigned long)capture.getOverwritten());
+    check(capture.getOverwritten() > 0, "capture ring wrapped", detail);
+    check(whole && kept > 0, "capture frames dumped whole", detail);
+    check(frames.empty() || frames.back().size() == DMT_CAPTURE_MAX_FRAME, "capture longest frame", detail);
+    printf("  %s\n", detail);
+}
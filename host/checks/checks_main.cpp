@@ -0,0 +1,88 @@
+// Host checks for the firmware: src/main.cpp and the libraries, linked
+// without booting.
+//
+// Usage: program [--verbose] [gain|udp|mirror|zone_api|capture ...]
+//
+// Runs the named suites, all of them by default. Exits non-zero when a check
+// fails and prints PASS or FAIL last.
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include <WiFiServer.h>
+#include <unistd.h>
+
+#include "Host_Check.h"
+
+ZoneInfo checkZones[CHECK_ZONE_COUNT] = {
+    {0x1100, 1868704443, 1, "Zone 1"},
+    {0x1110, 1868704444, 2, "Zone 2"}
+};
+
+static int failures = 0;
+static bool verbose = false;
+
+void check(bool ok, const char* what, const char* detail) {
+    if (ok) {
+        if (verbose) printf("  ok   %s: %s\n", what, detail);
+        return;
+    }
+    failures++;
+    printf("  FAIL %s: %s\n", what, detail);
+}
+
+bool checkVerbose() {
+    return verbose;
+}
+
+int checkFailures() {
+    return failures;
+}
+
+uint16_t checkPort(int index) {
+    return (uint16_t)(40000 + (getpid() % 5000) * 4 + index);
+}
+
+static const struct {
+    const char* name;
+    void (*run)();
+} suites[] = {
+    {"gain", runGainChecks},
+    {"udp", runUdpChecks},
+    {"mirror", runMirrorChecks},
+    {"zone_api", runZoneApiChecks},
+    {"capture", runCaptureChecks}
+};
+
+static const size_t numSuites = sizeof(suites) / sizeof(suites[0]);
+
+int main(int argc, char** argv) {
+    bool selected[numSuites] = {};
+    bool any = false;
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--verbose") == 0) {
+            verbose = true;
+            continue;
+        }
+        size_t s = 0;
+        while (s < numSuites && strcmp(argv[i], suites[s].name) != 0) s++;
+        if (s == numSuites) {
+            fprintf(stderr, "Usage: %s [--verbose] [gain|udp|mirror|zone_api|capture ...]\n", argv[0]);
+            return 2;
+        }
+        selected[s] = true;
+        any = true;
+    }
+
+    // Loopback network for the udp and zone_api suites
+    WiFiServer::hostSetListening(true);
+    WiFi.begin("host_checks");
+    WiFi.status();
+
+    for (size_t s = 0; s < numSuites; s++) {
+        if (any && !selected[s]) continue;
+        printf("%s\n", suites[s].name);
+        suites[s].run();
+    }
+    printf("%s\n", failures == 0 ? "PASS" : "FAIL");
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,162 @@
+// Fixed-point gain pipeline (lib/Gain_Fixed).
+//
+// Every panel volume 0-100 goes volume -> gain -> PUT text -> GET text -> gain
+// -> volume through the firmware's own functions and must land on the volume
+// the previous float implementation (pow/log2f) produced.
+
+#include <Arduino.h>
+#include <cmath>
+
+#include "Gain_Fixed.h"
+#include "Mezzo_Controller.h"
+#include "DMT_Display.h"
+#include "Host_Check.h"
+
+// Thousands of steps: only failures are printed, --verbose adds a table
+static void checkVolume(bool ok, const char* what, int volume, const char* detail) {
+    if (ok) return;
+    char label[64];
+    snprintf(label, sizeof(label), "volume %3d %s", volume, what);
+    check(false, label, detail);
+}
+
+// The float mapping the firmware used before fixed point
+static float referenceGain(int volume) {
+    if (volume <= 0) return 0.0f;
+    if (volume >= 100) return 1.0f;
+    float gain = pow(2.0f, (float)volume / 10.0f) / 1000.0f;
+    return gain > 1.0f ? 1.0f : gain;
+}
+
+static int referenceVolume(float gain) {
+    if (gain <= 0.0f) return 0;
+    if (gain >= 1.0f) return 100;
+    float volume = 10.0f * log2f(gain * 1000.0f);
+    if (volume < 0.0f) volume = 0.0f;
+    if (volume > 100.0f) volume = 100.0f;
+    return (int)round(volume);
+}
+
+// Gain text of a zone-controls PUT body
+static const char* payloadGain(const String& payload) {
+    const char* gain = strstr(payload.c_str(), "\"Gain\":");
+    return gain != nullptr ? gain + strlen("\"Gain\":") : "";
+}
+
+static void checkVolumes() {
+    Mezzo_Controller mezzo("127.0.0.1");
+    mezzo.setZones(checkZones, 1);
+    HardwareSerial checkSerial(1);
+    DMT_Display display(&checkSerial);
+    char detail[96];
+
+    for (int volume = 0; volume <= GAIN_MAX_VOLUME; volume++) {
+        float expectedGain = referenceGain(volume);
+        int expectedVolume = referenceVolume(expectedGain);
+
+        // Panel frame to gain, within half a millionth of the float value
+        FixedGain gain = mezzo.calculateGainFromVPData(0x0100 | volume);
+        snprintf(detail, sizeof(detail), "%lu vs %.3f", (unsigned long)gain, expectedGain * 1e6);
+        checkVolume(fabs(gain - expectedGain * 1e6) <= 0.6, "gain", volume, detail);
+
+        // PUT body text reads back as the same number
+        String payload;
+        mezzo.buildGainPayload(0, gain, payload);
+        const char* text = payloadGain(payload);
+        double sent = strtod(text, nullptr);
+        snprintf(detail, sizeof(detail), "%s", payload.c_str());
+        checkVolume(lround(sent * 1e6) == (long)gain, "payload", volume, detail);
+
+        // GET response in both shapes the Mezzo uses
+        char gainText[GAIN_TEXT_SIZE];
+        formatGain(gain, gainText);
+        char response[160];
+        snprintf(response, sizeof(response),
+                 "{\"Code\":0,\"Message\":\"OK\",\"Result\":{\"Name\":\"Zone 1\",\"Gain\":"
+                 "{\"Value\":%s,\"Min\":0.0,\"Max\":1.0}}}", gainText);
+        FixedGain readBack = mezzo.parseGainResponse(String(response));
+        snprintf(detail, sizeof(detail), "%lu from %s", (unsigned long)readBack, gainText);
+        checkVolume(readBack == gain, "Result.Gain.Value", volume, detail);
+
+        snprintf(response, sizeof(response), "{\"Code\":0,\"Result\":{\"Zones\":[{\"Id\":1,\"Gain\":%s}]}}",
+                 gainText);
+        readBack = mezzo.parseGainResponse(String(response));
+        checkVolume(readBack == gain, "Result.Zones[0].Gain", volume, detail);
+
+        // The amplifier echoes float text with more digits (%.6g, like the simulator);
+        // up to 10 characters ("0.00107177"), longer than GAIN_TEXT_SIZE
+        char echoedText[16];
+        snprintf(echoedText, sizeof(echoedText), "%.6g", expectedGain);
+        FixedGain echoed = 0;
+        checkVolume(parseGain(echoedText, echoed) != nullptr, "parse", volume, echoedText);
+
+        // Back to the panel's volume
+        int returned = volumeFromGain(readBack);
+        snprintf(detail, sizeof(detail), "%d, float path %d", returned, expectedVolume);
+        checkVolume(returned == expectedVolume, "round trip", volume, detail);
+        checkVolume(volumeFromGain(echoed) == expectedVolume, "echoed round trip", volume, detail);
+        checkVolume(mezzo.mapGainToVP(readBack) == expectedVolume << 8, "Mezzo_Controller::mapGainToVP",
+                    volume, detail);
+        checkVolume(display.mapGainToVP(readBack) == expectedVolume << 8, "DMT_Display::mapGainToVP",
+                    volume, detail);
+
+        if (checkVerbose()) {
+            printf("  %3d %-9s %.8f -> %d\n", volume, gainText, expectedGain, returned);
+        }
+    }
+    printf("  volumes 0-%d checked\n", GAIN_MAX_VOLUME);
+}
+
+// Every representable gain against the float rounding. Gains within a few
+// millionths of the half-step boundary may round either way in float, so only
+// the count of those is reported.
+static void checkAllGains() {
+    unsigned long nearBoundary = 0;
+    char detail[64];
+    for (FixedGain gain = 0; gain <= GAIN_UNITY; gain++) {
+        int expected = referenceVolume(gain / 1e6f);
+        int actual = volumeFromGain(gain);
+        if (actual == expected) continue;
+        float exact = 10.0f * log2f(gain / 1e3f);
+        bool boundary = fabs(exact - floor(exact) - 0.5) < 0.002 && abs(actual - expected) == 1;
+        if (boundary) {
+            nearBoundary++;
+            continue;
+        }
+        snprintf(detail, sizeof(detail), "gain %lu gives %d, float path %d", (unsigned long)gain, actual, expected);
+        checkVolume(false, "sweep", expected, detail);
+    }
+    printf("  gains 0-%lu checked, %lu within float error of a half step\n", (unsigned long)GAIN_UNITY, nearBoundary);
+}
+
+// Number forms the JSON grammar allows
+static void checkParser() {
+    static const struct {
+        const char* text;
+        long gain;          // -1: not a number
+        size_t length;
+    } cases[] = {
+        {"0", 0, 1}, {"1", 1000000, 1}, {"1.0", 1000000, 3}, {"0.128", 128000, 5},
+        {"0.00107177", 1072, 10}, {"0.0000005", 1, 9}, {"0.0000004", 0, 9},
+        {"1e-3", 1000, 4}, {"2.5E-1", 250000, 6}, {"5e+5", 1000000, 4}, {"1.5", 1000000, 3},
+        {"-0.25", 0, 5}, {"0.128,", 128000, 5}, {"0.5}", 500000, 3},
+        {"123456789012345678901234e-24", 123457, 28},
+        {"abc", -1, 0}, {"1.", -1, 0}, {".5", -1, 0}, {"-", -1, 0}, {"1e", -1, 0}, {"", -1, 0}
+    };
+    char detail[64];
+    for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) {
+        FixedGain gain = 0;
+        const char* end = parseGain(cases[i].text, gain);
+        bool ok = cases[i].gain < 0 ? end == nullptr
+                                    : end == cases[i].text + cases[i].length && (long)gain == cases[i].gain;
+        snprintf(detail, sizeof(detail), "\"%s\" gave %ld", cases[i].text, end ? (long)gain : -1L);
+        check(ok, "parseGain", detail);
+    }
+    printf("  %zu parser cases checked\n", sizeof(cases) / sizeof(cases[0]));
+}
+
+void runGainChecks() {
+    checkVolumes();
+    checkAllGains();
+    checkParser();
+}
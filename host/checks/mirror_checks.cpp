@@ -0,0 +1,85 @@
+// Slider mirroring between two panels (src/main.cpp, DMT_Panels).
+//
+// Wires two panels into the firmware's DMT_Panels the way setup() does with
+// DMT_SECOND_PANEL. The second panel sits on UART 2 here, as the host's
+// UART 0 is the console. A slider upload injected on one panel's UART goes
+// through DMT_Display's parser and the firmware's VP callback; the other
+// panel must receive exactly one 0x82 write of the slider word
+// (5A A5 05 82 VPH VPL VV 00) and the touched panel nothing.
+
+#include <Arduino.h>
+#include <HardwareSerial.h>
+#include <vector>
+
+#include "DMT_Display.h"
+#include "DMT_Panels.h"
+#include "Mezzo_Controller.h"
+#include "Host_Check.h"
+
+// Firmware objects from src/main.cpp
+extern HardwareSerial DMTSerial;
+extern DMT_Display dmtDisplay;
+extern DMT_Panels dmtPanels;
+extern Mezzo_Controller mezzoController;
+void onVPDataReceived(uint8_t panel, uint16_t vpAddress, uint16_t vpData);
+
+static HardwareSerial secondSerial(2);
+static DMT_Display secondDisplay(&secondSerial);
+static HardwareSerial* const serials[2] = {&DMTSerial, &secondSerial};
+
+static void formatBytes(const std::vector<uint8_t>& bytes, char* out, size_t size) {
+    size_t used = 0;
+    out[0] = '\0';
+    for (size_t i = 0; i < bytes.size() && used + 4 < size; i++) {
+        used += snprintf(out + used, size - used, "%s%02X", i > 0 ? " " : "", bytes[i]);
+    }
+}
+
+// Slider upload on one panel: 5A A5 06 83 VPH VPL 01 VV 00
+static void checkMirror(int fromPanel, uint16_t vpAddress, uint8_t volume) {
+    std::vector<uint8_t> drained;
+    for (int i = 0; i < 2; i++) serials[i]->hostTakeTx(drained);
+
+    const uint8_t upload[] = {0x5A, 0xA5, 0x06, 0x83, (uint8_t)(vpAddress >> 8), (uint8_t)(vpAddress & 0xFF),
+                              0x01, volume, 0x00};
+    serials[fromPanel]->hostInjectRx(upload, sizeof(upload));
+    dmtPanels.handleIncomingData();
+
+    std::vector<uint8_t> touched;
+    std::vector<uint8_t> mirrored;
+    serials[fromPanel]->hostTakeTx(touched);
+    serials[1 - fromPanel]->hostTakeTx(mirrored);
+    const std::vector<uint8_t> expected = {0x5A, 0xA5, 0x05, 0x82, (uint8_t)(vpAddress >> 8),
+                                           (uint8_t)(vpAddress & 0xFF), volume, 0x00};
+
+    char what[64];
+    char got[64];
+    char detail[96];
+    snprintf(what, sizeof(what), "panel %d VP 0x%04X volume %3u", fromPanel, vpAddress, volume);
+    formatBytes(mirrored, got, sizeof(got));
+    snprintf(detail, sizeof(detail), "panel %d got [%s]", 1 - fromPanel, got);
+    check(mirrored == expected, what, detail);
+
+    formatBytes(touched, got, sizeof(got));
+    snprintf(detail, sizeof(detail), "panel %d got [%s]", fromPanel, got);
+    check(touched.empty(), "nothing written back to the touched panel", detail);
+}
+
+void runMirrorChecks() {
+    dmtPanels.add(&dmtDisplay);
+    dmtPanels.add(&secondDisplay);
+    dmtPanels.setVPDataCallback(onVPDataReceived);
+    mezzoController.setZones(checkZones, CHECK_ZONE_COUNT);
+
+    static const uint8_t volumes[] = {0, 1, 42, 99, 100};
+    int checks = 0;
+    for (int from = 0; from < 2; from++) {
+        for (size_t z = 0; z < CHECK_ZONE_COUNT; z++) {
+            for (size_t v = 0; v < sizeof(volumes); v++) {
+                checkMirror(from, checkZones[z].vpAddr, volumes[v]);
+                checks++;
+            }
+        }
+    }
+    printf("  %d touches mirrored\n", checks);
+}
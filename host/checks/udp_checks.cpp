@@ -0,0 +1,187 @@
+// UDP listeners (lib/Osc_Input, lib/Panel_Sync) over loopback.
+//
+// The Native_HAL WiFiUDP keeps a datagram until it is read or flushed, like
+// the ESP32 core, so a listener that skips a datagram without flushing it
+// stops receiving. Each listener gets an oversized datagram followed by a
+// valid one and must take the valid one. Panel sync must also take a peer's
+// packets again after the peer restarted, its first packet lost.
+
+#include <Arduino.h>
+#include <WiFiServer.h>
+#include <WiFiUdp.h>
+#include <unistd.h>
+
+#include "Osc_Input.h"
+#include "Panel_Sync.h"
+#include "Host_Check.h"
+
+static bool sendDatagram(uint16_t port, const uint8_t* data, size_t length) {
+    WiFiUDP sender;
+    if (!sender.beginPacket("127.0.0.1", WiFiServer::hostMapPort(port))) return false;
+    sender.write(data, length);
+    return sender.endPacket() == 1;
+}
+
+// Calls poll until it reports done or about 100 ms pass
+static bool waitFor(bool (*poll)()) {
+    for (int i = 0; i < 100; i++) {
+        if (poll()) return true;
+        usleep(1000);
+    }
+    return false;
+}
+
+// ---------------------------------------------------------------------------
+// OSC
+// ---------------------------------------------------------------------------
+
+static Osc_Input* osc = nullptr;
+static int oscZone = -1;
+static float oscValue = -1.0f;
+
+static bool onOscZone(int zoneNumber, OscZoneParam param, float value) {
+    (void)param;
+    oscZone = zoneNumber;
+    oscValue = value;
+    return true;
+}
+
+static bool pollOsc() {
+    osc->handlePackets();
+    return oscZone >= 0;
+}
+
+// "/zone/3/gain" ,f 0.25
+static size_t oscGainMessage(uint8_t* out) {
+    static const char address[] = "/zone/3/gain";      // 12 characters, padded to 16
+    memset(out, 0, 24);
+    memcpy(out, address, sizeof(address) - 1);
+    memcpy(out + 16, ",f", 2);
+    float value = 0.25f;
+    uint32_t bits;
+    memcpy(&bits, &value, 4);
+    for (int i = 0; i < 4; i++) out[20 + i] = (uint8_t)(bits >> (24 - 8 * i));
+    return 24;
+}
+
+static void checkOscOversized() {
+    Osc_Input input(checkPort(0));
+    osc = &input;
+    input.setZoneCallback(onOscZone);
+    input.begin();
+
+    static uint8_t large[OSC_INPUT_PACKET_SIZE + 100];
+    memset(large, 'x', sizeof(large));
+    uint8_t message[24];
+    size_t length = oscGainMessage(message);
+    bool sent = sendDatagram(checkPort(0), large, sizeof(large)) &&
+                sendDatagram(checkPort(0), message, length);
+    check(sent, "osc send", "sendto failed");
+
+    bool received = waitFor(pollOsc);
+    char detail[64];
+    snprintf(detail, sizeof(detail), "zone %d, value %.3f, %lu rejected", oscZone, oscValue,
+             (unsigned long)input.getRejected());
+    check(received && oscZone == 3 && oscValue == 0.25f, "osc message after an oversized datagram", detail);
+    check(input.getRejected() == 1, "osc oversized datagram rejected", detail);
+    osc = nullptr;
+}
+
+// ---------------------------------------------------------------------------
+// Panel sync
+// ---------------------------------------------------------------------------
+
+static Panel_Sync* activeSync = nullptr;
+static int syncZone = -1;
+static FixedGain syncGain = 0;
+
+static void onSyncZone(int zoneNumber, FixedGain gain) {
+    syncZone = zoneNumber;
+    syncGain = gain;
+}
+
+static bool pollSync() {
+    activeSync->handle();
+    return syncZone >= 0;
+}
+
+// Version 3 zones packet from node 7: one zone
+static size_t syncZonesPacket(uint8_t* out, uint32_t bootId, uint32_t sequence, uint16_t zoneNumber,
+                              FixedGain gain) {
+    const uint32_t fields[] = {7, bootId, sequence};
+    out[0] = 'P';
+    out[1] = 'S';
+    out[2] = 3;
+    out[3] = PANEL_SYNC_ZONES;
+    for (int f = 0; f < 3; f++) {
+        for (int i = 0; i < 4; i++) out[4 + f * 4 + i] = (uint8_t)(fields[f] >> (24 - 8 * i));
+    }
+    uint8_t* entry = out + PANEL_SYNC_HEADER_SIZE;
+    entry[0] = 1;
+    entry[1] = (uint8_t)(zoneNumber >> 8);
+    entry[2] = (uint8_t)zoneNumber;
+    for (int i = 0; i < 4; i++) entry[3 + i] = (uint8_t)(gain >> (24 - 8 * i));
+    return PANEL_SYNC_HEADER_SIZE + 1 + PANEL_SYNC_ENTRY_SIZE;
+}
+
+// The group's port also takes unicast, which keeps the check off multicast routing
+static void checkSyncOversized() {
+    Panel_Sync panelSync(IPAddress(239, 255, 77, 77), checkPort(1));
+    activeSync = &panelSync;
+    panelSync.setZoneCallback(onSyncZone);
+    panelSync.begin(1);
+
+    static uint8_t large[PANEL_SYNC_PACKET_SIZE + 100];
+    memset(large, 'x', sizeof(large));
+    uint8_t packet[32];
+    size_t length = syncZonesPacket(packet, 0x1234, 1, 5, 250000);
+    bool sent = sendDatagram(checkPort(1), large, sizeof(large)) &&
+                sendDatagram(checkPort(1), packet, length);
+    check(sent, "sync send", "sendto failed");
+
+    bool received = waitFor(pollSync);
+    char detail[64];
+    snprintf(detail, sizeof(detail), "zone %d, gain %lu, %lu rejected", syncZone, (unsigned long)syncGain,
+             (unsigned long)panelSync.getRejected());
+    check(received && syncZone == 5 && syncGain == 250000, "sync zones after an oversized datagram", detail);
+    check(panelSync.getRejected() == 1, "sync oversized datagram rejected", detail);
+    activeSync = nullptr;
+}
+
+// A peer restarts and its first packet is lost: the next one, with a new boot
+// id and a lower sequence number, must still be taken
+static void checkSyncRestart() {
+    Panel_Sync panelSync(IPAddress(239, 255, 77, 77), checkPort(3));
+    activeSync = &panelSync;
+    panelSync.setZoneCallback(onSyncZone);
+    panelSync.begin(1);
+
+    uint8_t before[32];
+    uint8_t repeated[32];
+    uint8_t after[32];
+    size_t length = syncZonesPacket(before, 0xA, 5, 5, 250000);
+    syncZonesPacket(repeated, 0xA, 5, 5, 250000);
+    syncZonesPacket(after, 0xB, 2, 6, 500000);
+    syncZone = -1;
+    bool sent = sendDatagram(checkPort(3), before, length);
+    bool received = waitFor(pollSync);
+    syncZone = -1;
+    sent = sent && sendDatagram(checkPort(3), repeated, length) && sendDatagram(checkPort(3), after, length);
+    check(sent, "sync send", "sendto failed");
+    received = received && waitFor(pollSync);
+
+    char detail[64];
+    snprintf(detail, sizeof(detail), "zone %d, %lu duplicates, %lu restarts", syncZone,
+             (unsigned long)panelSync.getDuplicates(), (unsigned long)panelSync.getRestarts());
+    check(received && syncZone == 6 && syncGain == 500000, "sync zones after a peer restart", detail);
+    check(panelSync.getDuplicates() == 1 && panelSync.getRestarts() == 1, "sync duplicate and restart counted",
+          detail);
+    activeSync = nullptr;
+}
+
+void runUdpChecks() {
+    checkOscOversized();
+    checkSyncOversized();
+    checkSyncRestart();
+    printf("  2 listeners checked\n");
+}
@@ -0,0 +1,86 @@
+// Zone REST API on the JSON arena (src/main.cpp, lib/Json_Arena).
+//
+// Serves the firmware's PUT /api/zones/* and GET /metrics handlers over
+// loopback. Each PUT body is parsed by ArduinoJson into a document on the
+// fixed Json_Arena; the request must succeed and queue the gain, and the
+// arena's high-water mark, read back from /metrics, must leave
+// JSON_ARENA_SIZE at least half free. The peak depends on ArduinoJson's slot
+// pools (ARDUINOJSON_POOL_CAPACITY) and string nodes.
+
+#include <Arduino.h>
+#include <WiFiClient.h>
+#include <WiFiServer.h>
+
+#include "Http_Server.h"
+#include "Json_Arena.h"
+#include "Mezzo_Controller.h"
+#include "Host_Check.h"
+
+// Firmware objects and handlers from src/main.cpp
+extern Mezzo_Controller mezzoController;
+void handleZonePutRequest(const HttpRequest& request, Http_Response& response);
+void handleMetricsRequest(const HttpRequest& request, Http_Response& response);
+
+static Http_Server server(checkPort(2));
+
+// Sends one request and serves it; returns the status, 0 without a reply
+static int exchange(const char* method, const char* path, const char* body, String& reply) {
+    WiFiClient client;
+    reply = "";
+    if (!client.connect("127.0.0.1", WiFiServer::hostMapPort(checkPort(2)))) return 0;
+    client.printf("%s %s HTTP/1.1\r\nHost: panel\r\n", method, path);
+    client.printf("Content-Type: application/json\r\nContent-Length: %u\r\n\r\n", (unsigned)strlen(body));
+    client.print(body);
+
+    // The server closes the connection after the body (HTTP/1.0)
+    unsigned long start = millis();
+    while (millis() - start < 1000) {
+        server.handleClient();
+        while (client.available()) reply += (char)client.read();
+        if (!client.connected() && !client.available()) break;
+        delay(1);
+    }
+    client.stop();
+    return reply.startsWith("HTTP/1.") ? atoi(reply.c_str() + 9) : 0;
+}
+
+static long arenaPeak() {
+    String reply;
+    if (exchange("GET", "/metrics", "", reply) != 200) return -1;
+    int at = reply.indexOf("panel_json_arena_peak_bytes ");
+    return at < 0 ? -1 : atol(reply.c_str() + at + strlen("panel_json_arena_peak_bytes "));
+}
+
+static void checkPut(int zoneNumber, const char* body, FixedGain expected) {
+    char path[32];
+    char what[64];
+    char detail[96];
+    snprintf(path, sizeof(path), "/api/zones/%d", zoneNumber);
+    snprintf(what, sizeof(what), "PUT %s %s", path, body);
+
+    String reply;
+    int status = exchange("PUT", path, body, reply);
+    snprintf(detail, sizeof(detail), "status %d", status);
+    check(status >= 200 && status < 300, what, detail);
+
+    const ZoneInfo& zone = mezzoController.getZone(mezzoController.findZoneByNumber(zoneNumber));
+    snprintf(detail, sizeof(detail), "pending %d, gain %lu", zone.writePending ? 1 : 0,
+             (unsigned long)zone.pendingGain);
+    check(zone.writePending && zone.pendingGain == expected, "queued gain", detail);
+
+    long peak = arenaPeak();
+    snprintf(detail, sizeof(detail), "%ld of %lu bytes", peak, (unsigned long)Json_Arena::getSize());
+    check(peak > 0, "document on the arena", detail);
+    check(peak >= 0 && (size_t)peak <= Json_Arena::getSize() / 2, "arena headroom", detail);
+    printf("  %-32s arena peak %s\n", body, detail);
+}
+
+void runZoneApiChecks() {
+    mezzoController.setZones(checkZones, CHECK_ZONE_COUNT);
+    server.on("PUT", "/api/zones/*", handleZonePutRequest);
+    server.on("GET", "/metrics", handleMetricsRequest);
+    server.begin();
+
+    checkPut(1, "{\"gain\":0.25}", 250000);
+    checkPut(2, "{\"volume\":42}", gainFromVolume(42));
+}
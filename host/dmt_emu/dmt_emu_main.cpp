@@ -0,0 +1,101 @@
+// DGUS panel emulator on a Linux pseudo-terminal.
+//
+// Usage: program [--script file]... [--start-delay ms] [--duration s] [--ack] [--record frames.csv]
+//
+// Prints the pty slave path; run the native firmware against it with
+//   NATIVE_UART1=<slave path> .pio/build/native/program
+// On exit (duration elapsed or Ctrl-C) prints frame rates in both directions.
+
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "DMT_Emulator.h"
+
+static volatile sig_atomic_t stopRequested = 0;
+
+static void onSignal(int) {
+    stopRequested = 1;
+}
+
+static uint64_t nowUs() {
+    return (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+int main(int argc, char** argv) {
+    std::vector<const char*> scripts;
+    unsigned long startDelayMs = 5000;
+    double durationSeconds = 0.0;
+    const char* recordPath = nullptr;
+    bool ackWrites = false;
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+        if (strcmp(arg, "--ack") == 0) {
+            ackWrites = true;
+        } else if (value && strcmp(arg, "--script") == 0) {
+            scripts.push_back(value); i++;
+        } else if (value && strcmp(arg, "--start-delay") == 0) {
+            startDelayMs = strtoul(value, nullptr, 10); i++;
+        } else if (value && strcmp(arg, "--duration") == 0) {
+            durationSeconds = atof(value); i++;
+        } else if (value && strcmp(arg, "--record") == 0) {
+            recordPath = value; i++;
+        } else {
+            fprintf(stderr, "Usage: %s [--script file]... [--start-delay ms] [--duration s] [--ack] [--record frames.csv]\n",
+                    argv[0]);
+            return 2;
+        }
+    }
+
+    DMT_Emulator emu;
+    emu.setAckWrites(ackWrites);
+    emu.setRecording(recordPath != nullptr);
+
+    uint64_t startUs = nowUs();
+    for (size_t i = 0; i < scripts.size(); i++) {
+        if (!emu.loadScript(scripts[i], startUs + startDelayMs * 1000ULL)) return 1;
+    }
+
+    DMT_Emulator_Pty pty(emu);
+    if (!pty.open()) return 1;
+    printf("DMT emulator on %s (%zu scripted touches, first after %lu ms)\n",
+           pty.getSlavePath(), emu.scriptRemaining(), startDelayMs);
+    fflush(stdout);
+
+    signal(SIGINT, onSignal);
+    signal(SIGTERM, onSignal);
+    uint64_t endUs = durationSeconds > 0.0 ? startUs + (uint64_t)(durationSeconds * 1e6) : UINT64_MAX;
+    while (!stopRequested) {
+        uint64_t now = nowUs();
+        if (now >= endUs) break;
+        // Sleep until input arrives or the next touch is due
+        uint64_t next = emu.nextEventUs();
+        int waitMs = next == UINT64_MAX ? 50 : (next > now ? (int)((next - now) / 1000) : 0);
+        if (waitMs > 50) waitMs = 50;
+        pty.service(now, waitMs);
+    }
+
+    double elapsed = (nowUs() - startUs) / 1e6;
+    DMTEmuStats s = emu.getStats();
+    printf("elapsed=%.2fs\n", elapsed);
+    printf("from controller: frames=%lu (%.1f/s) bytes=%lu vp_writes=%lu vp_reads=%lu reg_writes=%lu reg_reads=%lu malformed=%lu\n",
+           s.framesReceived, s.framesReceived / elapsed, s.bytesReceived, s.vpWrites, s.vpReads,
+           s.regWrites, s.regReads, s.malformedFrames);
+    printf("to controller:   frames=%lu (%.1f/s) bytes=%lu touches=%lu\n",
+           s.framesSent, s.framesSent / elapsed, s.bytesSent, s.touchesSent);
+
+    if (recordPath) {
+        if (!emu.writeLogCSV(recordPath)) {
+            fprintf(stderr, "Cannot write %s\n", recordPath);
+            return 1;
+        }
+        printf("recorded %zu frames to %s\n", emu.getLog().size(), recordPath);
+    }
+    return 0;
+}
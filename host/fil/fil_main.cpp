@@ -0,0 +1,402 @@
+// Firmware-in-the-loop runner: boots the real firmware (src/main.cpp) on
+// virtual time against the in-process panel emulator and Mezzo simulator,
+// plays a scenario and checks its budgets.
+//
+// Usage: program [--console] [--capture frames.txt] [--trace trace.json] scenario.scn
+//
+// --capture turns on the firmware's DGUS capture after setup() and writes the
+// dump (last DMT_CAPTURE_BUFFER_SIZE bytes of frames) for host/uart_replay.
+// --trace does the same for the trace ring (last PERF_TRACE_BUFFER_EVENTS
+// events), as Chrome trace-event JSON on the virtual clock.
+//
+// Scenario format, one directive per line ('#' starts a comment, times in ms
+// since the end of setup(), VPs in hex or decimal):
+//   duration <ms>
+//   zones <count>                        replace the firmware's 4 zones (VP 0x1100 + i*0x10)
+//   tick <us>                            idle time between two loop() calls (default 1000)
+//   panel fixed-baud                     the panel ignores UART rate changes
+//   mezzo latency <ms> [<jitter_ms>] | failure <rate> | close <rate> | seed <n>
+//   at <ms> touch <vp> <value>
+//   at <ms> drag <vp> <from> <to> <dur_ms> <rate_hz>
+//   at <ms> storm <dur_ms> <rate_hz>     every zone dragged end to end, out of phase
+//   at <ms> wifi up|down
+//   at <ms> amp online|offline
+//   at <ms> mezzo latency <ms> [<jitter_ms>] | failure <rate> | close <rate>
+//   budget <metric> <max>                latency_p50_ms, latency_p95_ms, latency_p99_ms,
+//                                        latency_max_ms, confirm_p95_ms, dropped_updates,
+//                                        final_mismatches, max_loop_ms, uart_overruns,
+//                                        lag_max_ms, uart_rx_peak_bytes, backlog_peak,
+//                                        heap_peak_bytes, stack_used_bytes, uart_line_errors,
+//                                        alloc_free_violations (allocations in regions
+//                                        lib/Alloc_Trace marks allocation-free)
+//   budget <metric> <min>                touch_rate_hz, heap_min_free_bytes, uart_baud (floors;
+//                                        uart_baud is 0 while the two ends disagree)
+//
+// Exits 0 when every budget holds, 1 when one is exceeded, 2 on usage errors.
+
+#include <Arduino.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <string>
+#include <vector>
+
+#include "harness/Firmware_Harness.h"
+#include "DMT_Capture.h"
+#include "Perf_Trace.h"
+#include "Alloc_Trace.h"
+
+enum GestureKind { GESTURE_TOUCH, GESTURE_DRAG, GESTURE_STORM };
+
+struct Gesture {
+    GestureKind kind;
+    unsigned long atMs;
+    uint16_t vpAddress;
+    int fromValue;
+    int toValue;
+    unsigned long durationMs;
+    unsigned long rateHz;
+};
+
+struct TimedEvent {
+    unsigned long atMs;
+    void (*action)(Firmware_Harness& harness, long arg);
+    long arg;
+};
+
+struct Budget {
+    std::string metric;
+    double limit;
+};
+
+struct Scenario {
+    unsigned long durationMs = 60000;
+    HarnessConfig config;
+    std::vector<Gesture> gestures;
+    std::vector<TimedEvent> events;
+    std::vector<Budget> budgets;
+};
+
+// ---------------------------------------------------------------------------
+// Scheduled actions
+// ---------------------------------------------------------------------------
+
+static void actionWiFi(Firmware_Harness& harness, long up) {
+    harness.setWiFiLink(up != 0);
+}
+
+static void actionAmp(Firmware_Harness& harness, long online) {
+    harness.setAmpOnline(online != 0);
+}
+
+// Latency and jitter packed as (latency << 16) | jitter
+static void actionLatency(Firmware_Harness& harness, long packed) {
+    harness.mezzo().setLatency((unsigned long)(packed >> 16), (unsigned long)(packed & 0xFFFF));
+}
+
+// Rates carried in parts per million
+static void actionFailureRate(Firmware_Harness& harness, long ppm) {
+    harness.mezzo().setFailureRate(ppm / 1e6f);
+}
+
+static void actionCloseRate(Firmware_Harness& harness, long ppm) {
+    harness.mezzo().setCloseRate(ppm / 1e6f);
+}
+
+// ---------------------------------------------------------------------------
+// Parsing
+// ---------------------------------------------------------------------------
+
+static bool parseMezzo(std::vector<std::string>& words, size_t pos, Scenario& scn, bool timed,
+                       unsigned long atMs) {
+    if (pos + 1 >= words.size()) return false;
+    const std::string& key = words[pos];
+    double value = atof(words[pos + 1].c_str());
+
+    if (key == "latency") {
+        unsigned long latency = (unsigned long)value;
+        unsigned long jitter = pos + 2 < words.size() ? strtoul(words[pos + 2].c_str(), nullptr, 0)
+                                                      : scn.config.mezzo.jitterMs;
+        if (timed) {
+            scn.events.push_back({atMs, actionLatency, (long)((latency << 16) | (jitter & 0xFFFF))});
+        } else {
+            scn.config.mezzo.latencyMs = latency;
+            scn.config.mezzo.jitterMs = jitter;
+        }
+    } else if (key == "failure" || key == "close") {
+        if (timed) {
+            scn.events.push_back({atMs, key == "failure" ? actionFailureRate : actionCloseRate,
+                                  (long)(value * 1e6)});
+        } else if (key == "failure") {
+            scn.config.mezzo.failureRate = (float)value;
+        } else {
+            scn.config.mezzo.closeRate = (float)value;
+        }
+    } else if (key == "seed" && !timed) {
+        scn.config.mezzo.seed = (uint32_t)value;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+static bool parseTimed(std::vector<std::string>& words, Scenario& scn) {
+    if (words.size() < 3) return false;
+    unsigned long atMs = strtoul(words[1].c_str(), nullptr, 0);
+    const std::string& what = words[2];
+
+    if (what == "touch" && words.size() == 5) {
+        Gesture g = {GESTURE_TOUCH, atMs, (uint16_t)strtoul(words[3].c_str(), nullptr, 0),
+                     atoi(words[4].c_str()), 0, 0, 0};
+        scn.gestures.push_back(g);
+    } else if (what == "drag" && words.size() == 8) {
+        Gesture g = {GESTURE_DRAG, atMs, (uint16_t)strtoul(words[3].c_str(), nullptr, 0),
+                     atoi(words[4].c_str()), atoi(words[5].c_str()),
+                     strtoul(words[6].c_str(), nullptr, 0), strtoul(words[7].c_str(), nullptr, 0)};
+        scn.gestures.push_back(g);
+    } else if (what == "storm" && words.size() == 5) {
+        Gesture g = {GESTURE_STORM, atMs, 0, 0, 100,
+                     strtoul(words[3].c_str(), nullptr, 0), strtoul(words[4].c_str(), nullptr, 0)};
+        scn.gestures.push_back(g);
+    } else if (what == "wifi" && words.size() == 4 && (words[3] == "up" || words[3] == "down")) {
+        scn.events.push_back({atMs, actionWiFi, words[3] == "up"});
+    } else if (what == "amp" && words.size() == 4 && (words[3] == "online" || words[3] == "offline")) {
+        scn.events.push_back({atMs, actionAmp, words[3] == "online"});
+    } else if (what == "mezzo") {
+        return parseMezzo(words, 3, scn, true, atMs);
+    } else {
+        return false;
+    }
+    return true;
+}
+
+static bool loadScenario(const char* path, Scenario& scn) {
+    FILE* f = fopen(path, "r");
+    if (f == nullptr) {
+        fprintf(stderr, "Cannot open scenario %s\n", path);
+        return false;
+    }
+
+    char line[256];
+    int lineNumber = 0;
+    bool ok = true;
+    while (ok && fgets(line, sizeof(line), f) != nullptr) {
+        lineNumber++;
+        char* comment = strchr(line, '#');
+        if (comment) *comment = '\0';
+
+        std::vector<std::string> words;
+        for (char* tok = strtok(line, " \t\r\n"); tok; tok = strtok(nullptr, " \t\r\n")) {
+            words.push_back(tok);
+        }
+        if (words.empty()) continue;
+
+        const std::string& key = words[0];
+        if (key == "duration" && words.size() == 2) {
+            scn.durationMs = strtoul(words[1].c_str(), nullptr, 0);
+        } else if (key == "zones" && words.size() == 2) {
+            scn.config.numZones = atoi(words[1].c_str());
+        } else if (key == "panel" && words.size() == 2 && words[1] == "fixed-baud") {
+            scn.config.panelBaudFixed = true;
+        } else if (key == "tick" && words.size() == 2) {
+            scn.config.tickUs = strtoull(words[1].c_str(), nullptr, 0);
+        } else if (key == "mezzo") {
+            ok = parseMezzo(words, 1, scn, false, 0);
+        } else if (key == "at") {
+            ok = parseTimed(words, scn);
+        } else if (key == "budget" && words.size() == 3) {
+            scn.budgets.push_back({words[1], atof(words[2].c_str())});
+        } else {
+            ok = false;
+        }
+        if (!ok) fprintf(stderr, "%s:%d: cannot parse directive\n", path, lineNumber);
+    }
+    fclose(f);
+    return ok;
+}
+
+// ---------------------------------------------------------------------------
+// Running
+// ---------------------------------------------------------------------------
+
+static void scheduleGestures(Firmware_Harness& harness, const Scenario& scn) {
+    DMT_Emulator& panel = harness.panel();
+    uint64_t start = harness.startUs();
+
+    for (size_t i = 0; i < scn.gestures.size(); i++) {
+        const Gesture& g = scn.gestures[i];
+        uint64_t atUs = start + (uint64_t)g.atMs * 1000;
+
+        if (g.kind == GESTURE_TOUCH) {
+            panel.addTouch(atUs, g.vpAddress, (uint8_t)g.fromValue);
+        } else if (g.kind == GESTURE_DRAG) {
+            panel.addDrag(atUs, g.vpAddress, (uint8_t)g.fromValue, (uint8_t)g.toValue, g.durationMs, g.rateHz);
+        } else {
+            // Back-and-forth sweeps of 2 s on every zone, offset so frames interleave
+            const unsigned long sweepMs = 2000;
+            const std::vector<HarnessZone>& zones = harness.zones();
+            for (size_t z = 0; z < zones.size(); z++) {
+                uint64_t offsetUs = (uint64_t)(z * 37 % sweepMs) * 1000;
+                bool up = (z % 2) == 0;
+                for (unsigned long t = 0; t + sweepMs <= g.durationMs; t += sweepMs) {
+                    panel.addDrag(atUs + offsetUs + (uint64_t)t * 1000, zones[z].vpAddr,
+                                  up ? 0 : 100, up ? 100 : 0, sweepMs, g.rateHz);
+                    up = !up;
+                }
+            }
+        }
+    }
+
+    for (size_t i = 0; i < scn.events.size(); i++) {
+        harness.schedule((uint64_t)scn.events[i].atMs * 1000, scn.events[i].action, scn.events[i].arg);
+    }
+}
+
+// Floors are met when the value is at least the budget, every other metric
+// when it is at most the budget
+static bool metricValue(const HarnessResult& r, const std::string& metric, double& value, bool& floor) {
+    floor = metric == "touch_rate_hz" || metric == "heap_min_free_bytes" || metric == "uart_baud";
+    if (metric == "latency_p50_ms") value = r.ampLatency.p50Us / 1000.0;
+    else if (metric == "latency_p95_ms") value = r.ampLatency.p95Us / 1000.0;
+    else if (metric == "latency_p99_ms") value = r.ampLatency.p99Us / 1000.0;
+    else if (metric == "latency_max_ms") value = r.ampLatency.maxUs / 1000.0;
+    else if (metric == "confirm_p95_ms") value = r.confirmLatency.p95Us / 1000.0;
+    else if (metric == "dropped_updates") value = r.dropped;
+    else if (metric == "final_mismatches") value = r.finalMismatches;
+    else if (metric == "max_loop_ms") value = r.maxLoopUs / 1000.0;
+    else if (metric == "uart_overruns") value = r.uartOverruns;
+    else if (metric == "lag_max_ms") value = r.maxLagUs / 1000.0;
+    else if (metric == "uart_rx_peak_bytes") value = r.uartRxPeak;
+    else if (metric == "uart_line_errors") value = r.uartLineErrors;
+    else if (metric == "uart_baud") value = r.uartBaud == r.panelBaud ? r.uartBaud : 0;
+    else if (metric == "backlog_peak") value = r.backlogPeak;
+    else if (metric == "heap_peak_bytes") value = r.heapPeak;
+    else if (metric == "heap_min_free_bytes") value = (double)ESP.getHeapSize() - r.heapPeak;
+    else if (metric == "stack_used_bytes") value = r.stackUsed;
+    else if (metric == "alloc_free_violations") value = r.allocViolations;
+    else if (metric == "touch_rate_hz") value = r.touchRateHz;
+    else return false;
+    return true;
+}
+
+static void printResult(const HarnessResult& r, unsigned long durationMs) {
+    printf("Simulated %.1f s, %lu loop() calls\n", durationMs / 1000.0, r.loopIterations);
+    printf("  touches           %lu (%lu delivered, %lu with own value, %lu dropped)\n",
+           r.touches, r.delivered, r.direct, r.dropped);
+    printf("  touch rate        %.1f frames/s from the first to the last touch\n", r.touchRateHz);
+    printf("  to amplifier      p50 %.1f ms, p95 %.1f ms, p99 %.1f ms, max %.1f ms\n",
+           r.ampLatency.p50Us / 1000.0, r.ampLatency.p95Us / 1000.0, r.ampLatency.p99Us / 1000.0,
+           r.ampLatency.maxUs / 1000.0);
+    printf("  to confirmation   p50 %.1f ms, p95 %.1f ms, p99 %.1f ms, max %.1f ms (%lu touches)\n",
+           r.confirmLatency.p50Us / 1000.0, r.confirmLatency.p95Us / 1000.0,
+           r.confirmLatency.p99Us / 1000.0, r.confirmLatency.maxUs / 1000.0, r.confirmLatency.count);
+    printf("  worst lag         %.1f ms behind the panel\n", r.maxLagUs / 1000.0);
+    printf("  final mismatches  %lu\n", r.finalMismatches);
+    printf("  longest loop()    %.1f ms\n", r.maxLoopUs / 1000.0);
+    printf("  UART overruns     %lu bytes (RX buffer peak %lu bytes)\n", r.uartOverruns, r.uartRxPeak);
+    printf("  UART rate         %lu baud, panel %lu baud, %lu bytes lost to a mismatch\n",
+           r.uartBaud, r.panelBaud, r.uartLineErrors);
+    printf("  touch backlog     %lu waiting for the amp at most\n", r.backlogPeak);
+    printf("  firmware heap     peak %zu bytes, %zu held at the end\n", r.heapPeak, r.heapInUse);
+    printf("  firmware stack    %zu bytes deepest\n", r.stackUsed);
+    printf("  allocations       %lu in loop(), %lu in allocation-free regions\n",
+           (unsigned long)allocTrace.getRegion(ALLOC_REGION_LOOP).allocations, r.allocViolations);
+    printf("  Mezzo requests    %lu (%lu GET, %lu PUT, %lu failed, %lu dropped, %lu refused)\n",
+           r.mezzo.requests, r.mezzo.gets, r.mezzo.puts, r.mezzo.failures, r.mezzo.drops,
+           r.mezzo.refused);
+}
+
+// Print sink for the capture dump
+class FilePrint : public Print {
+private:
+    FILE* _file;
+
+public:
+    FilePrint(FILE* file) : _file(file) {}
+    size_t write(uint8_t c) override { return fputc(c, _file) == EOF ? 0 : 1; }
+    size_t write(const uint8_t* buffer, size_t size) override { return fwrite(buffer, 1, size, _file); }
+};
+
+static bool writeCapture(const char* path) {
+    FILE* f = fopen(path, "w");
+    if (f == nullptr) {
+        fprintf(stderr, "Cannot write capture %s\n", path);
+        return false;
+    }
+    FilePrint out(f);
+    dmtCapture.dump(out);
+    fclose(f);
+    return true;
+}
+
+static bool writeTrace(const char* path) {
+    FILE* f = fopen(path, "w");
+    if (f == nullptr) {
+        fprintf(stderr, "Cannot write trace %s\n", path);
+        return false;
+    }
+    FilePrint out(f);
+    perfTrace.dump(out);
+    fclose(f);
+    return true;
+}
+
+int main(int argc, char** argv) {
+    const char* scenarioPath = nullptr;
+    const char* capturePath = nullptr;
+    const char* tracePath = nullptr;
+    bool console = false;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--console") == 0) {
+            console = true;
+        } else if (strcmp(argv[i], "--capture") == 0 && i + 1 < argc) {
+            capturePath = argv[++i];
+        } else if (strcmp(argv[i], "--trace") == 0 && i + 1 < argc) {
+            tracePath = argv[++i];
+        } else if (argv[i][0] != '-' && scenarioPath == nullptr) {
+            scenarioPath = argv[i];
+        } else {
+            scenarioPath = nullptr;
+            break;
+        }
+    }
+    if (scenarioPath == nullptr) {
+        fprintf(stderr, "Usage: %s [--console] [--capture frames.txt] [--trace trace.json] scenario.scn\n", argv[0]);
+        return 2;
+    }
+
+    Scenario scn;
+    if (!loadScenario(scenarioPath, scn)) return 2;
+    scn.config.console = console;
+
+    Firmware_Harness harness;
+    harness.begin(scn.config);
+    if (capturePath != nullptr) dmtCapture.setEnabled(true);
+    if (tracePath != nullptr) perfTrace.setEnabled(true);
+    scheduleGestures(harness, scn);
+    harness.runUntil((uint64_t)scn.durationMs * 1000);
+    if (capturePath != nullptr && !writeCapture(capturePath)) return 2;
+    if (tracePath != nullptr && !writeTrace(tracePath)) return 2;
+
+    HarnessResult r = harness.result();
+    printf("Scenario %s\n", scenarioPath);
+    printResult(r, scn.durationMs);
+
+    bool passed = true;
+    for (size_t i = 0; i < scn.budgets.size(); i++) {
+        const Budget& b = scn.budgets[i];
+        double value;
+        bool floor;
+        if (!metricValue(r, b.metric, value, floor)) {
+            fprintf(stderr, "Unknown budget metric %s\n", b.metric.c_str());
+            return 2;
+        }
+        bool ok = floor ? value >= b.limit : value <= b.limit;
+        printf("  %s %-19s %10.1f %s %.1f\n", ok ? "PASS" : "FAIL", b.metric.c_str(), value,
+               floor ? ">=" : "<=", b.limit);
+        passed = passed && ok;
+    }
+    printf("%s\n", passed ? "PASS" : "FAIL");
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,373 @@
+#include "Firmware_Harness.h"
+#include "Heap_Tracker.h"
+#include "Alloc_Trace.h"
+#include <HardwareSerial.h>
+#include <WiFi.h>
+#include <algorithm>
+#include <math.h>
+
+// Firmware objects from src/main.cpp
+extern HardwareSerial DMTSerial;
+extern Mezzo_Controller mezzoController;
+
+void setup();
+void loop();
+
+// Callbacks are plain function pointers, so the running harness is a singleton
+static Firmware_Harness* activeHarness = nullptr;
+
+static const char* const harnessNetworks[] = {"Floor 9", "Roll", "Vinternal"};
+
+// Fill byte of the firmware stack; the deepest overwritten byte is the high-water mark
+#define HARNESS_STACK_PAINT 0xA5
+
+Firmware_Harness::Firmware_Harness()
+    : _mezzo(nullptr), _nextAction(0), _startUs(0), _maxLoopUs(0), _loopIterations(0),
+      _backlog(0), _backlogPeak(0), _lineErrors(0), _stack(nullptr), _entry(nullptr) {
+}
+
+Firmware_Harness::~Firmware_Harness() {
+    if (activeHarness == this) {
+        hostSetTimeHook(nullptr);
+        HTTPClient::hostSetTransport(nullptr);
+        WiFiClient::hostSetConnectHook(nullptr);
+        activeHarness = nullptr;
+    }
+    delete _mezzo;
+    delete[] _stack;
+}
+
+bool Firmware_Harness::begin(const HarnessConfig& config) {
+    if (activeHarness != nullptr) return false;
+    activeHarness = this;
+    _config = config;
+
+    // The simulator must know every zone number the firmware may address
+    int zoneCount = config.numZones > 0 ? config.numZones : 8;
+    if (_config.mezzo.zonesPerDevice < zoneCount) _config.mezzo.zonesPerDevice = zoneCount;
+    _config.mezzo.numDevices = 1;
+    _mezzo = new Mezzo_Simulator(_config.mezzo);
+    _mezzo->setEventCallback(onMezzoEvent);
+
+    _panel.setFrameCallback(onPanelFrame);
+    _panel.setBaudFixed(config.panelBaudFixed);
+
+    hostUseVirtualTime(true);
+    hostSetTimeHook(onTimeAdvance);
+    HTTPClient::hostSetTransport(mezzoTransport);
+    WiFiClient::hostSetConnectHook(mezzoConnect);
+    WiFi.hostSetVisibleNetworks(harnessNetworks, 3);
+    WiFi.hostSetLinkUp(true);
+    WiFiServer::hostSetListening(false);   // Runs stay hermetic and can run side by side
+    Serial.hostSetConsole(config.console ? stdout : nullptr);
+    allocTrace.setTracing(true);           // Heap_Tracker reports firmware blocks
+
+    _stack = new uint8_t[HARNESS_STACK_SIZE];
+    memset(_stack, HARNESS_STACK_PAINT, HARNESS_STACK_SIZE);
+    callFirmware(setup);
+
+    // Larger installations replace the firmware table once it has booted
+    if (config.numZones > 0) {
+        _zoneTable.clear();
+        for (int i = 0; i < config.numZones; i++) {
+            int zoneNumber = i + 1;
+            _zoneTable.push_back({(uint16_t)(0x1100 + i * 0x10), mezzoSimDefaultZoneId(0, zoneNumber),
+                                  zoneNumber, "Zone"});
+        }
+        mezzoController.setZones(_zoneTable.data(), config.numZones);
+    }
+
+    _zones.clear();
+    for (int i = 0; i < mezzoController.getNumZones(); i++) {
+        const ZoneInfo& zone = mezzoController.getZone(i);
+        _zones.push_back({zone.vpAddr, zone.zoneNumber, {}, 0, 0, -1});
+    }
+
+    _startUs = hostMicros64();
+    return true;
+}
+
+void Firmware_Harness::schedule(uint64_t sinceStartUs, void (*action)(Firmware_Harness& harness, long arg), long arg) {
+    TimedAction timed = {_startUs + sinceStartUs, action, arg};
+    auto pos = std::upper_bound(_actions.begin() + _nextAction, _actions.end(), timed,
+                                [](const TimedAction& a, const TimedAction& b) { return a.atUs < b.atUs; });
+    _actions.insert(pos, timed);
+}
+
+void Firmware_Harness::runUntil(uint64_t sinceStartUs) {
+    uint64_t endUs = _startUs + sinceStartUs;
+    while (hostMicros64() < endUs) {
+        uint64_t loopStart = hostMicros64();
+        callFirmware(loop);
+        uint64_t spent = hostMicros64() - loopStart;
+        if (spent > _maxLoopUs) _maxLoopUs = spent;
+        _loopIterations++;
+
+        // Idle until the next tick; the time hook moves UART bytes meanwhile
+        hostAdvanceTime(_config.tickUs);
+    }
+}
+
+void Firmware_Harness::firmwareEntry() {
+    bool previous = heapTrackerSetFirmware(true);
+    activeHarness->_entry();
+    heapTrackerSetFirmware(previous);
+}
+
+// Runs one firmware entry point to completion on the firmware stack
+void Firmware_Harness::callFirmware(void (*entry)()) {
+    _entry = entry;
+    getcontext(&_firmwareContext);
+    _firmwareContext.uc_stack.ss_sp = _stack;
+    _firmwareContext.uc_stack.ss_size = HARNESS_STACK_SIZE;
+    _firmwareContext.uc_link = &_harnessContext;
+    makecontext(&_firmwareContext, firmwareEntry, 0);
+    swapcontext(&_harnessContext, &_firmwareContext);
+}
+
+// The stack grows down from the end of the buffer
+size_t Firmware_Harness::stackUsed() const {
+    if (_stack == nullptr) return 0;
+    size_t untouched = 0;
+    while (untouched < HARNESS_STACK_SIZE && _stack[untouched] == HARNESS_STACK_PAINT) untouched++;
+    return HARNESS_STACK_SIZE - untouched;
+}
+
+void Firmware_Harness::setWiFiLink(bool up) {
+    WiFi.hostSetLinkUp(up);
+}
+
+void Firmware_Harness::setAmpOnline(bool online) {
+    _mezzo->setOnline(0, online);
+}
+
+// Move bytes between the firmware UART and the panel, then run due actions.
+// Bytes sent while the two ends run at different rates are lost.
+// Runs inside firmware calls, so its allocations are kept off the firmware's tally.
+void Firmware_Harness::pump(uint64_t nowUs) {
+    bool firmware = heapTrackerSetFirmware(false);
+    bool sameRate = DMTSerial.baudRate() == _panel.getBaudRate();
+    std::vector<uint8_t> bytes;
+    if (DMTSerial.hostTakeTx(bytes) > 0) {
+        if (sameRate) _panel.receive(bytes.data(), bytes.size(), nowUs);
+        else _lineErrors += bytes.size();
+    }
+    bytes.clear();
+    if (_panel.pollOutput(nowUs, bytes) > 0) {
+        if (sameRate) DMTSerial.hostInjectRx(bytes.data(), bytes.size());
+        else _lineErrors += bytes.size();
+    }
+
+    while (_nextAction < _actions.size() && _actions[_nextAction].atUs <= nowUs) {
+        TimedAction timed = _actions[_nextAction++];
+        timed.action(*this, timed.arg);
+    }
+    heapTrackerSetFirmware(firmware);
+}
+
+void Firmware_Harness::onTimeAdvance(uint64_t nowUs) {
+    if (activeHarness != nullptr) activeHarness->pump(nowUs);
+}
+
+HarnessZone* Firmware_Harness::findZone(uint16_t vpAddr) {
+    for (size_t i = 0; i < _zones.size(); i++) {
+        if (_zones[i].vpAddr == vpAddr) return &_zones[i];
+    }
+    return nullptr;
+}
+
+HarnessZone* Firmware_Harness::findZoneByNumber(int zoneNumber) {
+    for (size_t i = 0; i < _zones.size(); i++) {
+        if (_zones[i].zoneNumber == zoneNumber) return &_zones[i];
+    }
+    return nullptr;
+}
+
+// Slider auto-uploads from the panel (5A A5 06 83 VP_H VP_L 01 VV 00) start a
+// touch; VP writes from the firmware (5A A5 05 82 VP_H VP_L VV 00) confirm one
+void Firmware_Harness::onPanelFrame(const DMTEmuFrame& frame) {
+    if (activeHarness == nullptr) return;
+    const std::vector<uint8_t>& b = frame.bytes;
+
+    if (frame.fromPanel) {
+        if (b.size() != 9 || b[3] != DMT_EMU_CMD_READ_VP || b[6] != 0x01) return;
+        HarnessZone* zone = activeHarness->findZone((uint16_t)((b[4] << 8) | b[5]));
+        if (zone == nullptr) return;
+        zone->touches.push_back({frame.timestampUs, b[7], -1, false, -1, false});
+        zone->lastValue = b[7];
+        if (++activeHarness->_backlog > activeHarness->_backlogPeak) {
+            activeHarness->_backlogPeak = activeHarness->_backlog;
+        }
+    } else {
+        if (b.size() != 8 || b[3] != DMT_EMU_CMD_WRITE_VP) return;
+        HarnessZone* zone = activeHarness->findZone((uint16_t)((b[4] << 8) | b[5]));
+        if (zone == nullptr) return;
+        activeHarness->confirmWrite(*zone, b[6], frame.timestampUs);
+    }
+}
+
+// Writes the amplifier accepted; delivered once the transport knows the delay
+void Firmware_Harness::onMezzoEvent(const MezzoSimEvent& event) {
+    if (activeHarness == nullptr || !event.isWrite || event.status != 200) return;
+    activeHarness->_acceptedWrites.push_back(event);
+}
+
+// A delivered write covers the matching touch and supersedes older pending ones
+void Firmware_Harness::deliverWrite(HarnessZone& zone, int volume, uint64_t nowUs) {
+    size_t match = zone.touches.size();
+    for (size_t i = zone.touches.size(); i > zone.firstPending; i--) {
+        if (zone.touches[i - 1].value == volume) {
+            match = i - 1;
+            break;
+        }
+    }
+    if (match == zone.touches.size()) return;
+
+    for (size_t i = zone.firstPending; i <= match; i++) {
+        zone.touches[i].deliveredUs = (int64_t)nowUs;
+        zone.touches[i].direct = (i == match);
+    }
+    _backlog -= match + 1 - zone.firstPending;
+    zone.firstPending = match + 1;
+}
+
+// Same for the value written back to the panel, among delivered touches
+void Firmware_Harness::confirmWrite(HarnessZone& zone, int volume, uint64_t nowUs) {
+    size_t match = zone.firstPending;
+    for (size_t i = zone.firstPending; i > zone.firstUnconfirmed; i--) {
+        if (zone.touches[i - 1].value == volume) {
+            match = i - 1;
+            break;
+        }
+    }
+    if (match == zone.firstPending) return;
+
+    for (size_t i = zone.firstUnconfirmed; i <= match; i++) {
+        zone.touches[i].confirmedUs = (int64_t)nowUs;
+        zone.touches[i].confirmedDirect = (i == match);
+    }
+    zone.firstUnconfirmed = match + 1;
+}
+
+// The firmware connects before each request; an offline amp costs the full timeout.
+// Connect time of an online amp is part of the simulated response delay.
+int Firmware_Harness::mezzoConnect(const char* host, uint16_t port, int32_t timeoutMs) {
+    if (!activeHarness->_mezzo->isOnline(0)) {
+        hostAdvanceTime((uint64_t)timeoutMs * 1000);
+        return 0;
+    }
+    return 1;
+}
+
+int Firmware_Harness::mezzoTransport(const HostHTTPRequest& request, HostHTTPResponse& response) {
+    MezzoSimRequest simRequest = {0, request.method, request.path.c_str(), request.body.c_str()};
+    MezzoSimResponse simResponse;
+    uint64_t sentUs = hostMicros64();
+    bool firmware = heapTrackerSetFirmware(false);
+    activeHarness->_mezzo->handleRequest(simRequest, simResponse, sentUs);
+
+    // The request reaches the amp after half of the response time
+    for (size_t i = 0; i < activeHarness->_acceptedWrites.size(); i++) {
+        const MezzoSimEvent& event = activeHarness->_acceptedWrites[i];
+        HarnessZone* zone = activeHarness->findZoneByNumber(event.zoneNumber);
+        if (zone == nullptr) continue;
+        activeHarness->deliverWrite(*zone, gainToVolume(event.gain), sentUs + simResponse.delayMs * 500);
+    }
+    activeHarness->_acceptedWrites.clear();
+    heapTrackerSetFirmware(firmware);
+
+    if (simResponse.status < 0) {
+        hostAdvanceTime((uint64_t)request.connectTimeoutMs * 1000);
+        return HTTPC_ERROR_CONNECTION_REFUSED;
+    }
+    if (simResponse.delayMs > request.timeoutMs) {
+        hostAdvanceTime((uint64_t)request.timeoutMs * 1000);
+        return HTTPC_ERROR_READ_TIMEOUT;
+    }
+    hostAdvanceTime((uint64_t)simResponse.delayMs * 1000);
+    if (simResponse.dropConnection) return HTTPC_ERROR_CONNECTION_LOST;
+
+    response.body = simResponse.body.c_str();
+    response.contentType = "application/json";
+    return simResponse.status;
+}
+
+// Inverse of the firmware gain curve: gain = 2^(v/10) / 1000
+int Firmware_Harness::gainToVolume(float gain) {
+    if (gain <= 0.0f) return 0;
+    return (int)lroundf(10.0f * log2f(gain * 1000.0f));
+}
+
+uint64_t Firmware_Harness::percentile(std::vector<uint64_t>& samples, double p) {
+    if (samples.empty()) return 0;
+    std::sort(samples.begin(), samples.end());
+    size_t rank = (size_t)ceil(p * samples.size());
+    if (rank == 0) rank = 1;
+    return samples[std::min(rank, samples.size()) - 1];
+}
+
+LatencySummary Firmware_Harness::summarize(std::vector<uint64_t>& samples) {
+    LatencySummary summary = {};
+    summary.count = samples.size();
+    summary.p50Us = percentile(samples, 0.50);
+    summary.p95Us = percentile(samples, 0.95);
+    summary.p99Us = percentile(samples, 0.99);
+    summary.maxUs = samples.empty() ? 0 : samples.back();
+    return summary;
+}
+
+HarnessResult Firmware_Harness::result(uint64_t fromUs, uint64_t toUs) {
+    HarnessResult r = {};
+    uint64_t nowUs = hostMicros64();
+    uint64_t firstTouchUs = UINT64_MAX;
+    uint64_t lastTouchUs = 0;
+    std::vector<uint64_t> ampSamples;
+    std::vector<uint64_t> confirmSamples;
+
+    for (size_t z = 0; z < _zones.size(); z++) {
+        const HarnessZone& zone = _zones[z];
+        for (size_t i = 0; i < zone.touches.size(); i++) {
+            const TouchRecord& touch = zone.touches[i];
+            uint64_t sinceStart = touch.touchUs - _startUs;
+            if (touch.touchUs < _startUs || sinceStart < fromUs || sinceStart >= toUs) continue;
+
+            r.touches++;
+            firstTouchUs = std::min(firstTouchUs, touch.touchUs);
+            lastTouchUs = std::max(lastTouchUs, touch.touchUs);
+            if (touch.deliveredUs < 0) {
+                r.dropped++;
+                r.maxLagUs = std::max(r.maxLagUs, nowUs - touch.touchUs);
+                continue;
+            }
+            r.delivered++;
+            if (touch.direct) r.direct++;
+            ampSamples.push_back((uint64_t)touch.deliveredUs - touch.touchUs);
+            r.maxLagUs = std::max(r.maxLagUs, ampSamples.back());
+            if (touch.confirmedDirect) {
+                confirmSamples.push_back((uint64_t)touch.confirmedUs - touch.touchUs);
+            }
+        }
+        if (zone.lastValue >= 0 &&
+            gainToVolume(_mezzo->getZoneGain(0, zone.zoneNumber)) != zone.lastValue) {
+            r.finalMismatches++;
+        }
+    }
+
+    if (lastTouchUs > firstTouchUs) r.touchRateHz = (r.touches - 1) * 1e6 / (lastTouchUs - firstTouchUs);
+    r.uartOverruns = DMTSerial.hostRxOverruns();
+    r.uartRxPeak = DMTSerial.hostRxPeak();
+    r.uartLineErrors = _lineErrors;
+    r.uartBaud = DMTSerial.baudRate();
+    r.panelBaud = _panel.getBaudRate();
+    r.backlogPeak = _backlogPeak;
+    r.loopIterations = _loopIterations;
+    r.maxLoopUs = _maxLoopUs;
+    r.heapPeak = heapTrackerPeak();
+    r.heapInUse = heapTrackerInUse();
+    r.allocViolations = allocTrace.getViolations();
+    r.stackUsed = stackUsed();
+    r.ampLatency = summarize(ampSamples);
+    r.confirmLatency = summarize(confirmSamples);
+    r.mezzo = _mezzo->getStats();
+    return r;
+}
@@ -0,0 +1,159 @@
+#ifndef FIRMWARE_HARNESS_H
+#define FIRMWARE_HARNESS_H
+
+#include <Arduino.h>
+#include <HTTPClient.h>
+#include <stdint.h>
+#include <ucontext.h>
+#include <vector>
+
+#include "DMT_Emulator.h"
+#include "Mezzo_Controller.h"
+#include "Mezzo_Simulator.h"
+
+// Firmware-in-the-loop harness: runs setup()/loop() from src/main.cpp on
+// virtual time, with the DGUS panel emulator on the DMT UART and the Mezzo
+// simulator behind HTTPClient, both in-process. Every touch emitted by the
+// panel is tracked until the amplifier holds its value (or a newer one).
+//
+// setup() and loop() run on a painted stack of their own and their heap
+// blocks are tallied apart from the harness (Heap_Tracker), so a run also
+// reports the firmware's stack and heap high-water marks. Both are host
+// figures: x86-64 frames and glibc blocks, compare them between runs.
+
+// Firmware stack size on the host; the device loop task has 8 KB
+#define HARNESS_STACK_SIZE (256 * 1024)
+
+struct HarnessConfig {
+    int numZones = 0;              // 0 keeps the firmware's own zone table
+    MezzoSimConfig mezzo;
+    uint64_t tickUs = 1000;        // Idle time between two loop() calls
+    bool console = false;          // Show the firmware's Serial output
+    bool panelBaudFixed = false;   // The panel ignores requests to change its UART rate
+};
+
+// One slider frame from the panel, when the amplifier received its value (or
+// a newer one) and when the firmware wrote the confirmed value back to the panel
+struct TouchRecord {
+    uint64_t touchUs;
+    uint8_t value;
+    int64_t deliveredUs;           // -1 while the amp has neither this value nor a newer one
+    bool direct;                   // Delivered with its own value, not superseded
+    int64_t confirmedUs;           // -1 until the panel shows the amp's value
+    bool confirmedDirect;          // Confirmed with its own value
+};
+
+struct HarnessZone {
+    uint16_t vpAddr;
+    int zoneNumber;
+    std::vector<TouchRecord> touches;
+    size_t firstPending;           // First touch not yet delivered
+    size_t firstUnconfirmed;       // First touch not yet confirmed on the panel
+    int lastValue;                 // Last value touched on the panel, -1 if none
+};
+
+struct LatencySummary {
+    unsigned long count;
+    uint64_t p50Us;
+    uint64_t p95Us;
+    uint64_t p99Us;
+    uint64_t maxUs;
+};
+
+struct HarnessResult {
+    unsigned long touches;
+    double touchRateHz;            // Panel frames per second between the first and the last touch
+    unsigned long delivered;
+    unsigned long direct;
+    unsigned long dropped;         // Never reached the amp, not even superseded
+    unsigned long finalMismatches; // Zones where the amp ends on another value than the panel
+    unsigned long uartOverruns;
+    unsigned long uartRxPeak;      // Most bytes waiting in the DMT UART RX buffer
+    unsigned long uartLineErrors;  // Bytes lost while the two ends ran at different rates
+    unsigned long uartBaud;        // Final rate of the firmware's DMT UART
+    unsigned long panelBaud;       // ... and of the panel's
+    unsigned long backlogPeak;     // Most touches waiting for the amp at once
+    uint64_t maxLagUs;             // Longest the amp lagged behind a touch, pending ones included
+    unsigned long loopIterations;
+    uint64_t maxLoopUs;
+    size_t heapPeak;               // Firmware heap high-water mark since setup() began
+    size_t heapInUse;              // Firmware heap still held at the end
+    unsigned long allocViolations; // Firmware allocations inside allocation-free regions
+    size_t stackUsed;              // Deepest firmware stack use
+    LatencySummary ampLatency;     // Panel frame to PUT arrival, superseded touches included
+    LatencySummary confirmLatency; // Panel frame to confirmed write-back, own value only
+    MezzoSimStats mezzo;
+};
+
+class Firmware_Harness {
+private:
+    struct TimedAction {
+        uint64_t atUs;
+        void (*action)(Firmware_Harness& harness, long arg);
+        long arg;
+    };
+
+    HarnessConfig _config;
+    DMT_Emulator _panel;
+    Mezzo_Simulator* _mezzo;
+    std::vector<HarnessZone> _zones;
+    std::vector<ZoneInfo> _zoneTable;
+    std::vector<TimedAction> _actions;
+    std::vector<MezzoSimEvent> _acceptedWrites;   // Written by the request in flight
+    size_t _nextAction;
+    uint64_t _startUs;
+    uint64_t _maxLoopUs;
+    unsigned long _loopIterations;
+    unsigned long _backlog;
+    unsigned long _backlogPeak;
+    unsigned long _lineErrors;
+    uint8_t* _stack;
+    void (*_entry)();                   // setup() or loop(), for firmwareEntry()
+    ucontext_t _harnessContext;
+    ucontext_t _firmwareContext;
+
+    static void onTimeAdvance(uint64_t nowUs);
+    static void onPanelFrame(const DMTEmuFrame& frame);
+    static void onMezzoEvent(const MezzoSimEvent& event);
+    static int mezzoConnect(const char* host, uint16_t port, int32_t timeoutMs);
+    static int mezzoTransport(const HostHTTPRequest& request, HostHTTPResponse& response);
+
+    static void firmwareEntry();
+    void callFirmware(void (*entry)());
+    size_t stackUsed() const;
+    void pump(uint64_t nowUs);
+    HarnessZone* findZone(uint16_t vpAddr);
+    HarnessZone* findZoneByNumber(int zoneNumber);
+    void deliverWrite(HarnessZone& zone, int volume, uint64_t nowUs);
+    void confirmWrite(HarnessZone& zone, int volume, uint64_t nowUs);
+
+public:
+    Firmware_Harness();
+    ~Firmware_Harness();
+
+    // Boot the firmware (setup()) on virtual time zero
+    bool begin(const HarnessConfig& config);
+
+    // Run loop() until the given time since the end of setup()
+    void runUntil(uint64_t sinceStartUs);
+
+    // Schedule a fault or change at a time since the end of setup()
+    void schedule(uint64_t sinceStartUs, void (*action)(Firmware_Harness& harness, long arg), long arg);
+
+    // Environment
+    DMT_Emulator& panel() { return _panel; }
+    Mezzo_Simulator& mezzo() { return *_mezzo; }
+    const std::vector<HarnessZone>& zones() const { return _zones; }
+    uint64_t startUs() const { return _startUs; }
+    uint64_t nowUs() const { return hostMicros64(); }
+    void setWiFiLink(bool up);
+    void setAmpOnline(bool online);
+
+    // Measurements, over the touches made in [fromUs, toUs) since the end of setup()
+    HarnessResult result(uint64_t fromUs = 0, uint64_t toUs = UINT64_MAX);
+    static uint64_t percentile(std::vector<uint64_t>& samples, double p);
+    static LatencySummary summarize(std::vector<uint64_t>& samples);
+    static int gainToVolume(float gain);
+};
+
+#endif // FIRMWARE_HARNESS_H
@@ -0,0 +1,162 @@
+#include "Heap_Tracker.h"
+#include "Alloc_Trace.h"
+#include <errno.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+
+// glibc's own allocator entry points, behind the replacements below
+extern "C" {
+void* __libc_malloc(size_t size);
+void* __libc_realloc(void* ptr, size_t size);
+void* __libc_memalign(size_t alignment, size_t size);
+void __libc_free(void* ptr);
+}
+
+// Every block carries a header just below the pointer handed out; offset
+// leads back to the start of the underlying glibc block
+struct HeapBlockHeader {
+    size_t size;
+    uint32_t offset;
+    uint32_t firmware;
+};
+
+#define HEAP_HEADER_SIZE sizeof(HeapBlockHeader)
+
+// Only the harness thread runs firmware code; counters are updated for
+// firmware blocks only, so other threads never touch them
+static thread_local bool firmwareActive = false;
+static size_t inUseBytes = 0;
+static size_t peakBytes = 0;
+static unsigned long allocationCount = 0;
+
+static HeapBlockHeader* headerOf(void* ptr) {
+    return (HeapBlockHeader*)((uint8_t*)ptr - HEAP_HEADER_SIZE);
+}
+
+static void* placeBlock(void* base, size_t offset, size_t size, bool firmware) {
+    if (base == nullptr) return nullptr;
+    void* ptr = (uint8_t*)base + offset;
+    HeapBlockHeader* header = headerOf(ptr);
+    header->size = size;
+    header->offset = (uint32_t)offset;
+    header->firmware = firmware;
+    if (firmware) {
+        inUseBytes += size;
+        if (inUseBytes > peakBytes) peakBytes = inUseBytes;
+        allocationCount++;
+        allocTrace.onAllocate(size);
+    }
+    return ptr;
+}
+
+static void releaseBlock(void* ptr) {
+    HeapBlockHeader* header = headerOf(ptr);
+    if (header->firmware) {
+        inUseBytes -= header->size;
+        allocTrace.onFree();
+    }
+}
+
+// Tracker interface
+bool heapTrackerSetFirmware(bool active) {
+    bool previous = firmwareActive;
+    firmwareActive = active;
+    return previous;
+}
+
+size_t heapTrackerInUse() {
+    return inUseBytes;
+}
+
+size_t heapTrackerPeak() {
+    return peakBytes;
+}
+
+unsigned long heapTrackerAllocations() {
+    return allocationCount;
+}
+
+void heapTrackerResetPeak() {
+    peakBytes = inUseBytes;
+}
+
+// Allocator replacements (glibc looks these up in the executable first)
+extern "C" {
+
+void* malloc(size_t size) {
+    if (size > SIZE_MAX - HEAP_HEADER_SIZE) return nullptr;
+    return placeBlock(__libc_malloc(size + HEAP_HEADER_SIZE), HEAP_HEADER_SIZE, size, firmwareActive);
+}
+
+void free(void* ptr) {
+    if (ptr == nullptr) return;
+    releaseBlock(ptr);
+    __libc_free((uint8_t*)ptr - headerOf(ptr)->offset);
+}
+
+void* calloc(size_t count, size_t size) {
+    if (size != 0 && count > SIZE_MAX / size) return nullptr;
+    void* ptr = malloc(count * size);
+    if (ptr != nullptr) memset(ptr, 0, count * size);
+    return ptr;
+}
+
+void* memalign(size_t alignment, size_t size) {
+    if (alignment <= HEAP_HEADER_SIZE) return malloc(size);
+    if (size > SIZE_MAX - alignment) return nullptr;
+    return placeBlock(__libc_memalign(alignment, size + alignment), alignment, size, firmwareActive);
+}
+
+// A block keeps its owner when it is resized
+void* realloc(void* ptr, size_t size) {
+    if (ptr == nullptr) return malloc(size);
+    if (size == 0) {
+        free(ptr);
+        return nullptr;
+    }
+    HeapBlockHeader* header = headerOf(ptr);
+    bool firmware = header->firmware != 0;
+    if (header->offset != HEAP_HEADER_SIZE) {
+        bool previous = heapTrackerSetFirmware(firmware);
+        void* moved = malloc(size);
+        heapTrackerSetFirmware(previous);
+        if (moved == nullptr) return nullptr;
+        memcpy(moved, ptr, header->size < size ? header->size : size);
+        free(ptr);
+        return moved;
+    }
+    if (size > SIZE_MAX - HEAP_HEADER_SIZE) return nullptr;
+    size_t oldSize = header->size;
+    void* base = __libc_realloc((uint8_t*)ptr - HEAP_HEADER_SIZE, size + HEAP_HEADER_SIZE);
+    if (base == nullptr) return nullptr;
+    if (firmware) inUseBytes -= oldSize;
+    return placeBlock(base, HEAP_HEADER_SIZE, size, firmware);
+}
+
+int posix_memalign(void** result, size_t alignment, size_t size) {
+    if (alignment % sizeof(void*) != 0 || (alignment & (alignment - 1)) != 0) return EINVAL;
+    void* ptr = memalign(alignment, size);
+    if (ptr == nullptr) return ENOMEM;
+    *result = ptr;
+    return 0;
+}
+
+void* aligned_alloc(size_t alignment, size_t size) {
+    return memalign(alignment, size);
+}
+
+void* valloc(size_t size) {
+    return memalign((size_t)sysconf(_SC_PAGESIZE), size);
+}
+
+void* pvalloc(size_t size) {
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    return memalign(page, (size + page - 1) / page * page);
+}
+
+size_t malloc_usable_size(void* ptr) {
+    return ptr == nullptr ? 0 : headerOf(ptr)->size;
+}
+
+} // extern "C"
@@ -0,0 +1,23 @@
+#ifndef HEAP_TRACKER_H
+#define HEAP_TRACKER_H
+
+#include <stddef.h>
+
+// Heap accounting for the firmware under test. The harness replaces the
+// process allocator (malloc and friends, which operator new uses too) and
+// charges every block allocated while the firmware context is active to the
+// firmware until it is freed, whoever frees it. Harness, emulator and
+// simulator allocations made from hooks inside firmware calls are excluded by
+// switching the context off around them. Firmware blocks are also reported
+// to allocTrace (lib/Alloc_Trace), which charges them to the code region the
+// firmware is in.
+
+// Returns the previous state so hooks can restore it
+bool heapTrackerSetFirmware(bool active);
+
+size_t heapTrackerInUse();        // Bytes currently held by firmware allocations
+size_t heapTrackerPeak();         // Most bytes held at once
+unsigned long heapTrackerAllocations();
+void heapTrackerResetPeak();
+
+#endif // HEAP_TRACKER_H
@@ -0,0 +1,223 @@
+// Fuzz target for the DGUS frame parser (DMT_Display::handleIncomingData
+// and processDMTFrame) fed through an in-memory UART.
+//
+// libFuzzer (clang, coverage-guided):
+//   pio run -e fuzz_libfuzzer && .pio/build/fuzz_libfuzzer/program -max_len=512 host/fuzz/corpus
+// Standalone (gcc, random mutations of the corpus):
+//   pio run -e fuzz && .pio/build/fuzz/program [--iterations n] [--seed s] [--max-len n] host/fuzz/corpus
+//
+// Both builds run under AddressSanitizer and UndefinedBehaviorSanitizer, so
+// any out-of-bounds access or UB aborts with a report and a non-zero exit.
+
+#include <Arduino.h>
+#include <HardwareSerial.h>
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+#include "DMT_Display.h"
+
+static volatile uint32_t fuzzSink = 0; // Keeps callback reads observable
+
+static void onFuzzVPData(uint8_t panel, uint16_t vpAddress, uint16_t vpData) {
+    fuzzSink += panel + (vpAddress ^ vpData);
+}
+
+// Touch every byte so the sanitizers check the whole range the parser hands out
+static void onFuzzRTCData(uint8_t* rtcData, int length) {
+    for (int i = 0; i < length; i++) fuzzSink += rtcData[i];
+}
+
+// Fresh parser per pass so runs are deterministic
+static void feedStream(const uint8_t* data, size_t size, size_t chunk) {
+    HardwareSerial serial(1);
+    DMT_Display display(&serial);
+    display.begin(115200);
+    display.setVPDataCallback(onFuzzVPData);
+    display.setRTCDataCallback(onFuzzRTCData);
+
+    for (size_t offset = 0; offset < size; offset += chunk) {
+        size_t len = std::min(chunk, size - offset);
+        serial.hostInjectRx(data + offset, len);
+        display.handleIncomingData();
+    }
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    // Full driver-sized reads, then one byte per call: the parser must not
+    // depend on how the UART splits the stream
+    feedStream(data, size, 256);
+    feedStream(data, size, 1);
+
+    // processDMTFrame is public and trusts its length argument; an exact-size
+    // heap copy lets ASan catch any read past what the caller passed
+    if (size > 0 && size <= DMT_BUFFER_SIZE) {
+        std::unique_ptr<uint8_t[]> frame(new uint8_t[size]);
+        memcpy(frame.get(), data, size);
+        HardwareSerial serial(1);
+        DMT_Display display(&serial);
+        display.setVPDataCallback(onFuzzVPData);
+        display.setRTCDataCallback(onFuzzRTCData);
+        display.processDMTFrame(frame.get(), (int)size);
+    }
+    return 0;
+}
+
+#ifndef DGUS_FUZZ_LIBFUZZER
+
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <dirent.h>
+#include <string>
+#include <sys/stat.h>
+
+typedef std::vector<uint8_t> FuzzInput;
+
+static uint32_t rngState = 1;
+
+static uint32_t nextRandom() {
+    // xorshift32
+    rngState ^= rngState << 13;
+    rngState ^= rngState >> 17;
+    rngState ^= rngState << 5;
+    return rngState;
+}
+
+static bool readFile(const std::string& path, FuzzInput& out) {
+    FILE* f = fopen(path.c_str(), "rb");
+    if (f == nullptr) return false;
+    uint8_t buf[4096];
+    size_t n;
+    out.clear();
+    while ((n = fread(buf, 1, sizeof(buf), f)) > 0) out.insert(out.end(), buf, buf + n);
+    fclose(f);
+    return true;
+}
+
+// A directory contributes every regular file in it, in name order
+static bool loadCorpus(const char* path, std::vector<FuzzInput>& corpus) {
+    struct stat st;
+    if (stat(path, &st) != 0) return false;
+    std::vector<std::string> files;
+    if (S_ISDIR(st.st_mode)) {
+        DIR* dir = opendir(path);
+        if (dir == nullptr) return false;
+        while (struct dirent* entry = readdir(dir)) {
+            std::string file = std::string(path) + "/" + entry->d_name;
+            if (entry->d_name[0] != '.' && stat(file.c_str(), &st) == 0 && S_ISREG(st.st_mode)) {
+                files.push_back(file);
+            }
+        }
+        closedir(dir);
+        std::sort(files.begin(), files.end());
+    } else {
+        files.push_back(path);
+    }
+    for (size_t i = 0; i < files.size(); i++) {
+        FuzzInput input;
+        if (!readFile(files[i], input)) return false;
+        corpus.push_back(input);
+    }
+    return true;
+}
+
+// Byte-level mutations plus DGUS-aware ones (header insertion, length byte edits)
+static void mutate(FuzzInput& input, const std::vector<FuzzInput>& corpus, size_t maxLen) {
+    int rounds = 1 + nextRandom() % 4;
+    for (int r = 0; r < rounds; r++) {
+        size_t pos = input.empty() ? 0 : nextRandom() % input.size();
+        switch (nextRandom() % 7) {
+            case 0:
+                if (!input.empty()) input[pos] ^= (uint8_t)(1u << (nextRandom() % 8));
+                break;
+            case 1:
+                if (!input.empty()) input[pos] = (uint8_t)nextRandom();
+                break;
+            case 2:
+                input.insert(input.begin() + pos, (uint8_t)nextRandom());
+                break;
+            case 3:
+                if (!input.empty()) input.erase(input.begin() + pos);
+                break;
+            case 4: {
+                const uint8_t header[] = {DMT_HEADER_1, DMT_HEADER_2, (uint8_t)nextRandom()};
+                input.insert(input.begin() + pos, header, header + 1 + nextRandom() % 3);
+                break;
+            }
+            case 5: {
+                // Splice in part of another corpus entry
+                const FuzzInput& other = corpus[nextRandom() % corpus.size()];
+                if (other.empty()) break;
+                size_t from = nextRandom() % other.size();
+                size_t len = 1 + nextRandom() % (other.size() - from);
+                input.insert(input.begin() + pos, other.begin() + from, other.begin() + from + len);
+                break;
+            }
+            case 6: {
+                // Rewrite a length byte (the byte after a header) to an edge value
+                static const uint8_t edges[] = {0x00, 0x01, 0x03, 0x04, 0x05, 0x3C, 0x3D, 0x3E, 0xFD, 0xFF};
+                for (size_t i = pos; i + 2 < input.size(); i++) {
+                    if (input[i] == DMT_HEADER_1 && input[i + 1] == DMT_HEADER_2) {
+                        input[i + 2] = edges[nextRandom() % sizeof(edges)];
+                        break;
+                    }
+                }
+                break;
+            }
+        }
+    }
+    if (input.size() > maxLen) input.resize(maxLen);
+}
+
+static double nowSeconds() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+int main(int argc, char** argv) {
+    unsigned long iterations = 100000;
+    size_t maxLen = 512;
+    std::vector<FuzzInput> corpus;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--iterations") == 0 && i + 1 < argc) {
+            iterations = strtoul(argv[++i], nullptr, 10);
+        } else if (strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            rngState = (uint32_t)strtoul(argv[++i], nullptr, 10);
+            if (rngState == 0) rngState = 1;
+        } else if (strcmp(argv[i], "--max-len") == 0 && i + 1 < argc) {
+            maxLen = strtoul(argv[++i], nullptr, 10);
+        } else if (argv[i][0] == '-') {
+            fprintf(stderr, "Usage: %s [--iterations n] [--seed s] [--max-len n] corpus...\n", argv[0]);
+            return 2;
+        } else if (!loadCorpus(argv[i], corpus)) {
+            fprintf(stderr, "Cannot read corpus %s\n", argv[i]);
+            return 2;
+        }
+    }
+    Serial.hostSetConsole(nullptr);
+    size_t seedCount = corpus.size();
+
+    // Every seed input must pass on its own first
+    for (size_t i = 0; i < corpus.size(); i++) {
+        LLVMFuzzerTestOneInput(corpus[i].data(), corpus[i].size());
+    }
+    if (corpus.empty()) corpus.push_back(FuzzInput());
+
+    uint64_t bytes = 0;
+    double start = nowSeconds();
+    for (unsigned long n = 0; n < iterations; n++) {
+        FuzzInput input = corpus[nextRandom() % corpus.size()];
+        mutate(input, corpus, maxLen);
+        bytes += input.size();
+        LLVMFuzzerTestOneInput(input.data(), input.size());
+    }
+    double elapsed = nowSeconds() - start;
+
+    printf("%zu seed inputs, %lu mutated runs in %.2f s (%.0f execs/s, %.2f MB/s)\n",
+           seedCount, iterations, elapsed, elapsed > 0 ? iterations / elapsed : 0.0,
+           elapsed > 0 ? bytes / elapsed / 1e6 : 0.0);
+    return 0;
+}
+
+#endif // DGUS_FUZZ_LIBFUZZER
@@ -0,0 +1,13 @@
+# Pre-build script for the fuzz environments: sanitizer flags go to every
+# translation unit (libraries included) and to the linker. With
+# custom_fuzz_engine = libfuzzer the build switches to clang and links libFuzzer.
+Import("env")
+
+sanitizers = "-fsanitize=address,undefined"
+if env.GetProjectOption("custom_fuzz_engine", "") == "libfuzzer":
+    env.Replace(CC="clang", CXX="clang++", LINK="clang++")
+    sanitizers = "-fsanitize=fuzzer,address,undefined"
+    env.Append(CPPDEFINES=["DGUS_FUZZ_LIBFUZZER"])
+
+flags = [sanitizers, "-fno-sanitize-recover=undefined", "-fno-omit-frame-pointer"]
+env.Append(CCFLAGS=flags + ["-g", "-O1"], LINKFLAGS=flags)
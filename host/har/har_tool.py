@@ -0,0 +1,352 @@
+#!/usr/bin/env python3
+"""Turn browser HAR captures of the Mezzo web app into simulator fixtures and
+request replay scripts, and compare request patterns between two captures.
+
+Usage:
+  har_tool.py fixture capture.har [-o fixture.json]
+  har_tool.py script capture.har [-o script.txt]
+  har_tool.py replay script.txt [--base http://127.0.0.1:8080] [--speed 1] [--out results.json]
+  har_tool.py compare web.har controller.har [--labels web,controller]
+
+fixture  zone IDs and last known gains of every zone-controls request, plus
+         latency/jitter from the server wait times, for mezzo_sim --fixture.
+script   one line per Mezzo API request: "<offset ms> <METHOD> <path> <body|->".
+replay   sends a script with its original pacing (--speed 0: back to back),
+         one connection per request like the firmware, and reports latency
+         per operation; --out writes bench JSON for host/bench/compare.py.
+compare  request counts, rates, connection reuse, payload sizes and latency
+         per operation for two captures side by side. mezzo_sim --har records
+         what the firmware sends, so the web app and the controller can be
+         compared for the same gestures.
+"""
+import argparse
+import base64
+import datetime
+import http.client
+import json
+import math
+import re
+import sys
+import time
+import urllib.parse
+
+ZONE_PATH = re.compile(r"^/iv/views/web/(\d+)/zone-controls/(\d+)$")
+VIEW_PATH = re.compile(r"^/iv/views/web/(\d+)$")
+
+
+def load_entries(path):
+    with open(path, encoding="utf-8") as f:
+        entries = json.load(f)["log"]["entries"]
+    return sorted(entries, key=lambda e: started(e))
+
+
+def started(entry):
+    text = entry["startedDateTime"].replace("Z", "+00:00")
+    return datetime.datetime.fromisoformat(text).timestamp()
+
+
+def request_path(entry):
+    return urllib.parse.urlsplit(entry["request"]["url"]).path
+
+
+def operation(entry):
+    """Classify a request, e.g. "PUT zone", "GET view"; None for non-API traffic."""
+    path = request_path(entry)
+    method = entry["request"]["method"]
+    if ZONE_PATH.match(path):
+        return f"{method} zone"
+    if VIEW_PATH.match(path):
+        return f"{method} view"
+    if path.startswith("/iv/"):
+        return f"{method} other"
+    return None
+
+
+def request_body(entry):
+    return entry["request"].get("postData", {}).get("text", "")
+
+
+def response_text(entry):
+    content = entry["response"].get("content", {})
+    text = content.get("text", "")
+    if content.get("encoding") == "base64":
+        text = base64.b64decode(text).decode("utf-8", "replace")
+    return text
+
+
+def server_ms(entry):
+    """Time the device took to answer: HAR wait time, else the whole request."""
+    wait = entry.get("timings", {}).get("wait", -1)
+    return wait if wait is not None and wait >= 0 else entry.get("time", 0)
+
+
+def percentile(values, p):
+    if not values:
+        return 0.0
+    ordered = sorted(values)
+    rank = max(1, min(len(ordered), math.ceil(p * len(ordered))))
+    return ordered[rank - 1]
+
+
+# ---------------------------------------------------------------------------
+# fixture
+# ---------------------------------------------------------------------------
+
+def cmd_fixture(args):
+    entries = load_entries(args.har)
+    hosts = []
+    zones = {}          # (device, number) -> {"number", "id", "gain"}
+    ids = {}            # (device, id) -> number
+    waits = []
+
+    for entry in entries:
+        url = urllib.parse.urlsplit(entry["request"]["url"])
+        match = ZONE_PATH.match(url.path)
+        if not match:
+            continue
+        if url.netloc not in hosts:
+            hosts.append(url.netloc)
+        device = hosts.index(url.netloc)
+        number = int(match.group(2))
+        zone = zones.setdefault((device, number), {"number": number})
+        status = entry["response"]["status"]
+        if 200 <= status < 300:
+            waits.append(server_ms(entry))
+
+        if entry["request"]["method"] == "GET" and status == 200:
+            try:
+                result = json.loads(response_text(entry))["Result"]
+            except (ValueError, KeyError, TypeError):
+                continue
+            if "Id" in result:
+                zone["id"] = result["Id"]
+                ids[(device, result["Id"])] = number
+            gain = result.get("Gain", {})
+            if isinstance(gain, dict) and "Value" in gain:
+                zone["gain"] = gain["Value"]
+        elif entry["request"]["method"] == "PUT":
+            try:
+                written = json.loads(request_body(entry))["Zones"]
+            except (ValueError, KeyError, TypeError):
+                continue
+            for item in written:
+                # The body addresses zones by Id; the URL names one of them
+                target = ids.get((device, item.get("Id")), number if len(written) == 1 else None)
+                if target is None:
+                    continue
+                written_zone = zones.setdefault((device, target), {"number": target})
+                written_zone["id"] = item["Id"]
+                ids[(device, item["Id"])] = target
+                if "Gain" in item:
+                    written_zone["gain"] = item["Gain"]
+
+    if not zones:
+        print(f"No zone-controls requests in {args.har}", file=sys.stderr)
+        return 1
+
+    p50 = percentile(waits, 0.50)
+    fixture = {
+        "source": args.har,
+        "hosts": hosts,
+        "latencyMs": round(p50),
+        "jitterMs": max(0, round(percentile(waits, 0.90) - p50)),
+        "devices": [
+            {"zones": [zones[key] for key in sorted(zones) if key[0] == device]}
+            for device in range(len(hosts))
+        ],
+    }
+    text = json.dumps(fixture, indent=2) + "\n"
+    if args.output:
+        with open(args.output, "w", encoding="utf-8") as f:
+            f.write(text)
+    else:
+        sys.stdout.write(text)
+    missing = sum(1 for z in zones.values() if "id" not in z)
+    if missing:
+        print(f"{missing} zone(s) without a known Id keep the simulator default", file=sys.stderr)
+    return 0
+
+
+# ---------------------------------------------------------------------------
+# script
+# ---------------------------------------------------------------------------
+
+def cmd_script(args):
+    entries = [e for e in load_entries(args.har) if args.all or operation(e)]
+    if not entries:
+        print(f"No Mezzo API requests in {args.har}", file=sys.stderr)
+        return 1
+    t0 = started(entries[0])
+    lines = [f"# {args.har}: {len(entries)} requests over {started(entries[-1]) - t0:.1f} s"]
+    for entry in entries:
+        url = urllib.parse.urlsplit(entry["request"]["url"])
+        path = url.path + (f"?{url.query}" if url.query else "")
+        body = request_body(entry).replace("\n", " ") or "-"
+        lines.append(f"{(started(entry) - t0) * 1000:.0f} {entry['request']['method']} {path} {body}")
+    text = "\n".join(lines) + "\n"
+    if args.output:
+        with open(args.output, "w", encoding="utf-8") as f:
+            f.write(text)
+    else:
+        sys.stdout.write(text)
+    return 0
+
+
+# ---------------------------------------------------------------------------
+# replay
+# ---------------------------------------------------------------------------
+
+def load_script(path):
+    steps = []
+    with open(path, encoding="utf-8") as f:
+        for line in f:
+            line = line.strip()
+            if not line or line.startswith("#"):
+                continue
+            offset, method, target, body = (line.split(" ", 3) + ["-"])[:4]
+            steps.append((float(offset), method, target, "" if body == "-" else body))
+    return steps
+
+
+def cmd_replay(args):
+    steps = load_script(args.script)
+    base = urllib.parse.urlsplit(args.base)
+    latencies = {}
+    errors = {}
+    start = time.monotonic()
+
+    for offset, method, target, body in steps:
+        if args.speed > 0:
+            delay = start + offset / 1000.0 / args.speed - time.monotonic()
+            if delay > 0:
+                time.sleep(delay)
+        op = operation({"request": {"method": method, "url": "http://x" + target}}) or f"{method} other"
+        t0 = time.monotonic()
+        try:
+            conn = http.client.HTTPConnection(base.hostname, base.port or 80, timeout=args.timeout)
+            headers = {"Accept": "application/json, text/plain, */*"}
+            if body:
+                headers["Content-Type"] = "application/json"
+            conn.request(method, target, body=body.encode() if body else None, headers=headers)
+            status = conn.getresponse().status
+            conn.close()
+        except OSError:
+            status = 0
+        elapsed = (time.monotonic() - t0) * 1000.0
+        if 200 <= status < 300:
+            latencies.setdefault(op, []).append(elapsed)
+        else:
+            errors[op] = errors.get(op, 0) + 1
+
+    results = []
+    print(f"{'operation':12} {'count':>6} {'errors':>6} {'p50 ms':>8} {'p95 ms':>8} {'max ms':>8}")
+    for op in sorted(set(latencies) | set(errors)):
+        values = latencies.get(op, [])
+        p50, p95 = percentile(values, 0.50), percentile(values, 0.95)
+        worst = max(values) if values else 0.0
+        print(f"{op:12} {len(values):6} {errors.get(op, 0):6} {p50:8.1f} {p95:8.1f} {worst:8.1f}")
+        key = op.lower().replace(" ", "_")
+        for name, value in (("p50", p50), ("p95", p95), ("max", worst)):
+            results.append({"name": f"har_{key}_{name}", "value": value, "unit": "ms",
+                            "iterations": len(values)})
+    if args.out:
+        with open(args.out, "w", encoding="utf-8") as f:
+            json.dump({"benchmarks": results}, f, indent=2)
+            f.write("\n")
+    return 1 if errors else 0
+
+
+# ---------------------------------------------------------------------------
+# compare
+# ---------------------------------------------------------------------------
+
+def profile(path):
+    entries = [e for e in load_entries(path) if operation(e)]
+    rows = {}
+    if not entries:
+        return rows
+    span = max(started(entries[-1]) - started(entries[0]), 1e-3)
+    rows["requests"] = len(entries)
+    rows["span s"] = span
+    rows["requests/s"] = len(entries) / span
+    connections = {e.get("connection") for e in entries if e.get("connection")}
+    if connections:
+        rows["requests/connection"] = len(entries) / len(connections)
+    rows["failed"] = sum(1 for e in entries if not 200 <= e["response"]["status"] < 300)
+
+    by_op = {}
+    for entry in entries:
+        by_op.setdefault(operation(entry), []).append(entry)
+    for op, items in sorted(by_op.items()):
+        rows[f"{op}: count"] = len(items)
+        waits = [server_ms(e) for e in items]
+        totals = [e.get("time", 0) for e in items]
+        rows[f"{op}: wait p50 ms"] = percentile(waits, 0.50)
+        rows[f"{op}: wait p95 ms"] = percentile(waits, 0.95)
+        rows[f"{op}: total p95 ms"] = percentile(totals, 0.95)
+        sizes = [len(request_body(e)) for e in items if request_body(e)]
+        if sizes:
+            rows[f"{op}: body bytes p50"] = percentile(sizes, 0.50)
+
+    # How often one zone is written while a slider moves
+    gaps = []
+    last_put = {}
+    for entry in by_op.get("PUT zone", []):
+        path = request_path(entry)
+        if path in last_put:
+            gaps.append((started(entry) - last_put[path]) * 1000.0)
+        last_put[path] = started(entry)
+    if gaps:
+        rows["PUT zone: gap p50 ms"] = percentile(gaps, 0.50)
+        rows["PUT zone: gap min ms"] = min(gaps)
+    return rows
+
+
+def cmd_compare(args):
+    labels = args.labels.split(",") if args.labels else [args.first, args.second]
+    first, second = profile(args.first), profile(args.second)
+    if not first or not second:
+        print("Both captures need Mezzo API requests", file=sys.stderr)
+        return 1
+    print(f"{'':30} {labels[0][:14]:>14} {labels[1][:14]:>14}")
+    for key in list(first) + [k for k in second if k not in first]:
+        cells = [f"{p[key]:14.1f}" if key in p else f"{'-':>14}" for p in (first, second)]
+        print(f"{key:30} {cells[0]} {cells[1]}")
+    return 0
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.splitlines()[0])
+    sub = parser.add_subparsers(dest="command", required=True)
+
+    p = sub.add_parser("fixture", help="simulator fixture from a HAR")
+    p.add_argument("har")
+    p.add_argument("-o", "--output")
+    p.set_defaults(run=cmd_fixture)
+
+    p = sub.add_parser("script", help="replay script from a HAR")
+    p.add_argument("har")
+    p.add_argument("-o", "--output")
+    p.add_argument("--all", action="store_true", help="keep non-API requests too")
+    p.set_defaults(run=cmd_script)
+
+    p = sub.add_parser("replay", help="send a replay script to a Mezzo or mezzo_sim")
+    p.add_argument("script")
+    p.add_argument("--base", default="http://127.0.0.1:8080")
+    p.add_argument("--speed", type=float, default=1.0)
+    p.add_argument("--timeout", type=float, default=2.0)
+    p.add_argument("--out")
+    p.set_defaults(run=cmd_replay)
+
+    p = sub.add_parser("compare", help="request pattern of two HARs side by side")
+    p.add_argument("first")
+    p.add_argument("second")
+    p.add_argument("--labels")
+    p.set_defaults(run=cmd_compare)
+
+    args = parser.parse_args()
+    return args.run(args)
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,140 @@
+// End-to-end touch latency benchmark: the real firmware on virtual time,
+// measured from the panel's 0x83 slider frame to the matching gain PUT at the
+// Mezzo stand-in, and from there to the confirmed value written back to the
+// panel.
+//
+// Usage: program [--out results.json] [--quick] [--latency ms] [--jitter ms]
+//
+// Three phases run back to back on one firmware instance:
+//   touch      single touches on rotating zones, a few seconds apart
+//   drag       one zone dragged end to end at the panel's upload rate
+//   multizone  all zones dragged at the same time
+// Results use the host/bench JSON format, so host/bench/compare.py diffs them.
+
+#include <Arduino.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <string>
+#include <vector>
+
+#include "../fil/harness/Firmware_Harness.h"
+
+#define DRAG_DURATION_MS 2000
+#define DRAG_RATE_HZ 30
+#define GESTURE_SPACING_MS 10000
+
+struct LatencyResult {
+    std::string name;
+    double value;
+    unsigned long samples;
+};
+
+static std::vector<LatencyResult> results;
+
+static void reportSummary(const char* phase, const char* leg, const LatencySummary& summary) {
+    const char* labels[] = {"p50", "p95", "p99", "max"};
+    const uint64_t values[] = {summary.p50Us, summary.p95Us, summary.p99Us, summary.maxUs};
+    for (int i = 0; i < 4; i++) {
+        std::string name = std::string("e2e_") + phase + "_" + leg + "_" + labels[i];
+        results.push_back({name, values[i] / 1000.0, summary.count});
+    }
+    fprintf(stderr, "%-10s %-8s p50 %8.1f  p95 %8.1f  p99 %8.1f  max %8.1f ms  (%lu samples)\n",
+            phase, leg, summary.p50Us / 1000.0, summary.p95Us / 1000.0, summary.p99Us / 1000.0,
+            summary.maxUs / 1000.0, summary.count);
+}
+
+static void reportPhase(Firmware_Harness& harness, const char* phase, uint64_t fromMs, uint64_t toMs) {
+    HarnessResult r = harness.result(fromMs * 1000, toMs * 1000);
+    reportSummary(phase, "amp", r.ampLatency);
+    reportSummary(phase, "confirm", r.confirmLatency);
+    if (r.dropped > 0) {
+        fprintf(stderr, "%-10s %lu of %lu touches never reached the amplifier\n", phase, r.dropped, r.touches);
+    }
+}
+
+static bool writeResults(const char* path) {
+    FILE* f = path ? fopen(path, "w") : stdout;
+    if (f == nullptr) return false;
+    fprintf(f, "{\n  \"benchmarks\": [\n");
+    for (size_t i = 0; i < results.size(); i++) {
+        fprintf(f, "    {\"name\": \"%s\", \"value\": %.4f, \"unit\": \"ms\", \"iterations\": %lu}%s\n",
+                results[i].name.c_str(), results[i].value, results[i].samples,
+                i + 1 < results.size() ? "," : "");
+    }
+    fprintf(f, "  ]\n}\n");
+    if (f != stdout) fclose(f);
+    return true;
+}
+
+int main(int argc, char** argv) {
+    const char* outPath = nullptr;
+    int gestures = 50;
+    HarnessConfig config;
+    config.mezzo.latencyMs = 15;
+    config.mezzo.jitterMs = 5;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--out") == 0 && i + 1 < argc) {
+            outPath = argv[++i];
+        } else if (strcmp(argv[i], "--quick") == 0) {
+            gestures = 10;
+        } else if (strcmp(argv[i], "--latency") == 0 && i + 1 < argc) {
+            config.mezzo.latencyMs = strtoul(argv[++i], nullptr, 0);
+        } else if (strcmp(argv[i], "--jitter") == 0 && i + 1 < argc) {
+            config.mezzo.jitterMs = strtoul(argv[++i], nullptr, 0);
+        } else {
+            fprintf(stderr, "Usage: %s [--out results.json] [--quick] [--latency ms] [--jitter ms]\n", argv[0]);
+            return 2;
+        }
+    }
+
+    Firmware_Harness harness;
+    harness.begin(config);
+    DMT_Emulator& panel = harness.panel();
+    const std::vector<HarnessZone>& zones = harness.zones();
+    uint64_t start = harness.startUs();
+    uint32_t seed = 2024;
+
+    // Single touches, far enough apart for the 2 s readback to confirm each
+    uint64_t touchFrom = 1000;
+    uint64_t t = touchFrom;
+    for (int i = 0; i < gestures; i++) {
+        seed = seed * 1103515245u + 12345u;
+        uint8_t value = (uint8_t)(10 + (seed >> 16) % 81);
+        t += 4000 + (seed >> 8) % 1000;
+        panel.addTouch(start + t * 1000, zones[i % zones.size()].vpAddr, value);
+    }
+    uint64_t dragFrom = t + GESTURE_SPACING_MS;
+
+    // One zone at a time, alternating direction
+    t = dragFrom;
+    for (int i = 0; i < gestures; i++) {
+        bool up = (i % 2) == 0;
+        panel.addDrag(start + t * 1000, zones[i % zones.size()].vpAddr, up ? 0 : 100, up ? 100 : 0,
+                      DRAG_DURATION_MS, DRAG_RATE_HZ);
+        t += GESTURE_SPACING_MS;
+    }
+    uint64_t multiFrom = t;
+
+    // Every zone at once, slightly out of phase as with several fingers
+    for (int i = 0; i < gestures; i++) {
+        bool up = (i % 2) == 0;
+        for (size_t z = 0; z < zones.size(); z++) {
+            panel.addDrag(start + (t + z * 7) * 1000, zones[z].vpAddr, up ? 0 : 100, up ? 100 : 0,
+                          DRAG_DURATION_MS, DRAG_RATE_HZ);
+        }
+        t += GESTURE_SPACING_MS;
+    }
+    uint64_t endMs = t + GESTURE_SPACING_MS;
+
+    harness.runUntil(endMs * 1000);
+
+    fprintf(stderr, "Mezzo latency %lu ms + up to %lu ms jitter, %d gestures per phase\n",
+            config.mezzo.latencyMs, config.mezzo.jitterMs, gestures);
+    reportPhase(harness, "touch", touchFrom, dragFrom);
+    reportPhase(harness, "drag", dragFrom, multiFrom);
+    reportPhase(harness, "multizone", multiFrom, endMs);
+
+    return writeResults(outPath) ? 0 : 1;
+}
@@ -0,0 +1,209 @@
+// Local stand-in for one or more Mezzo 604A amplifiers.
+//
+// Usage: program [--port 8080] [--devices 1] [--zones 8] [--latency 15] [--jitter 5]
+//                [--failure-rate 0.0] [--close-rate 0.0] [--keep-alive] [--seed 1] [--verbose]
+//                [--fixture fixture.json] [--har served.har]
+//
+// Device d listens on 127.0.0.1:(port + d). Point the native firmware at it with
+//   NATIVE_HTTP_REMAP=192.168.101.30=127.0.0.1:8080 .pio/build/native/program
+//
+// --fixture loads zone IDs, gains and latency extracted from a browser HAR
+// (host/har/har_tool.py fixture); --har writes every served request as a
+// HAR 1.2 file on exit, for host/har/har_tool.py compare.
+
+#include <chrono>
+#include <csignal>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Mezzo_Simulator.h"
+
+static volatile sig_atomic_t stopRequested = 0;
+static bool verbose = false;
+
+static void onSignal(int) {
+    stopRequested = 1;
+}
+
+static void onEvent(const MezzoSimEvent& event) {
+    if (!verbose) return;
+    printf("%llu dev=%d zone=%d %s gain=%.4f status=%d\n", (unsigned long long)event.timestampUs,
+           event.device, event.zoneNumber, event.isWrite ? "PUT" : "GET", event.gain, event.status);
+    fflush(stdout);
+}
+
+static std::mutex harMutex;
+static std::vector<MezzoSimExchange> harExchanges;
+
+static void onExchange(const MezzoSimExchange& exchange) {
+    std::lock_guard<std::mutex> lock(harMutex);
+    harExchanges.push_back(exchange);
+}
+
+static std::string jsonString(const std::string& text) {
+    std::string out = "\"";
+    for (size_t i = 0; i < text.size(); i++) {
+        unsigned char c = (unsigned char)text[i];
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += (char)c;
+        } else if (c < 0x20) {
+            char buf[8];
+            snprintf(buf, sizeof(buf), "\\u%04x", c);
+            out += buf;
+        } else {
+            out += (char)c;
+        }
+    }
+    return out + "\"";
+}
+
+static bool readFile(const char* path, std::string& out) {
+    FILE* f = fopen(path, "rb");
+    if (f == nullptr) return false;
+    char buf[4096];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), f)) > 0) out.append(buf, n);
+    fclose(f);
+    return true;
+}
+
+// Exchanges carry steady-clock times; wallOffsetUs maps them to UTC
+static bool writeHar(const char* path, int port, int64_t wallOffsetUs) {
+    FILE* f = fopen(path, "w");
+    if (f == nullptr) return false;
+    std::lock_guard<std::mutex> lock(harMutex);
+    fprintf(f, "{\"log\":{\"version\":\"1.2\",\"creator\":{\"name\":\"mezzo_sim\",\"version\":\"1\"},\"entries\":[\n");
+    for (size_t i = 0; i < harExchanges.size(); i++) {
+        const MezzoSimExchange& e = harExchanges[i];
+        int64_t wallUs = (int64_t)e.startUs + wallOffsetUs;
+        time_t seconds = (time_t)(wallUs / 1000000);
+        struct tm utc;
+        gmtime_r(&seconds, &utc);
+        char started[40];
+        size_t len = strftime(started, sizeof(started), "%Y-%m-%dT%H:%M:%S", &utc);
+        snprintf(started + len, sizeof(started) - len, ".%03dZ", (int)(wallUs / 1000 % 1000));
+        double waitMs = (e.endUs - e.startUs) / 1000.0;
+
+        fprintf(f, "{\"startedDateTime\":\"%s\",\"time\":%.3f,\"connection\":\"%lu\",", started, waitMs,
+                e.connectionId);
+        fprintf(f, "\"request\":{\"method\":%s,\"url\":%s,\"httpVersion\":\"HTTP/1.1\",\"headers\":[],"
+                   "\"queryString\":[],\"cookies\":[],\"headersSize\":-1,\"bodySize\":%zu",
+                jsonString(e.method).c_str(),
+                jsonString("http://127.0.0.1:" + std::to_string(port + e.device) + e.path).c_str(),
+                e.requestBody.size());
+        if (!e.requestBody.empty()) {
+            fprintf(f, ",\"postData\":{\"mimeType\":\"application/json\",\"text\":%s}",
+                    jsonString(e.requestBody).c_str());
+        }
+        fprintf(f, "},\"response\":{\"status\":%d,\"statusText\":\"\",\"httpVersion\":\"HTTP/1.1\","
+                   "\"headers\":[],\"cookies\":[],\"content\":{\"size\":%zu,\"mimeType\":\"application/json\","
+                   "\"text\":%s},\"redirectURL\":\"\",\"headersSize\":-1,\"bodySize\":%zu},",
+                e.status, e.responseBody.size(), jsonString(e.responseBody).c_str(), e.responseBody.size());
+        fprintf(f, "\"cache\":{},\"timings\":{\"send\":0,\"wait\":%.3f,\"receive\":0}}%s\n", waitMs,
+                i + 1 < harExchanges.size() ? "," : "");
+    }
+    fprintf(f, "]}}\n");
+    fclose(f);
+    return true;
+}
+
+static void printStats(Mezzo_Simulator& sim) {
+    MezzoSimStats s = sim.getStats();
+    printf("requests=%lu gets=%lu puts=%lu failures=%lu drops=%lu refused=%lu bad=%lu\n",
+           s.requests, s.gets, s.puts, s.failures, s.drops, s.refused, s.badRequests);
+    fflush(stdout);
+}
+
+int main(int argc, char** argv) {
+    MezzoSimConfig config;
+    int port = 8080;
+    const char* fixturePath = nullptr;
+    const char* harPath = nullptr;
+
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+        if (strcmp(arg, "--keep-alive") == 0) {
+            config.keepAlive = true;
+        } else if (strcmp(arg, "--verbose") == 0) {
+            verbose = true;
+        } else if (value && strcmp(arg, "--port") == 0) {
+            port = atoi(value); i++;
+        } else if (value && strcmp(arg, "--devices") == 0) {
+            config.numDevices = atoi(value); i++;
+        } else if (value && strcmp(arg, "--zones") == 0) {
+            config.zonesPerDevice = atoi(value); i++;
+        } else if (value && strcmp(arg, "--latency") == 0) {
+            config.latencyMs = strtoul(value, nullptr, 10); i++;
+        } else if (value && strcmp(arg, "--jitter") == 0) {
+            config.jitterMs = strtoul(value, nullptr, 10); i++;
+        } else if (value && strcmp(arg, "--failure-rate") == 0) {
+            config.failureRate = strtof(value, nullptr); i++;
+        } else if (value && strcmp(arg, "--close-rate") == 0) {
+            config.closeRate = strtof(value, nullptr); i++;
+        } else if (value && strcmp(arg, "--seed") == 0) {
+            config.seed = strtoul(value, nullptr, 10); i++;
+        } else if (value && strcmp(arg, "--fixture") == 0) {
+            fixturePath = value; i++;
+        } else if (value && strcmp(arg, "--har") == 0) {
+            harPath = value; i++;
+        } else {
+            fprintf(stderr, "Usage: %s [--port N] [--devices N] [--zones N] [--latency MS] [--jitter MS]\n"
+                            "          [--failure-rate F] [--close-rate F] [--keep-alive] [--seed N] [--verbose]\n"
+                            "          [--fixture fixture.json] [--har served.har]\n",
+                    argv[0]);
+            return 2;
+        }
+    }
+
+    Mezzo_Simulator sim(config);
+    sim.setEventCallback(onEvent);
+    if (fixturePath != nullptr) {
+        std::string fixture;
+        if (!readFile(fixturePath, fixture) || !sim.applyFixture(fixture)) {
+            fprintf(stderr, "Cannot load fixture %s\n", fixturePath);
+            return 2;
+        }
+        config = sim.getConfig();
+    }
+    Mezzo_Sim_Server server(sim, (uint16_t)port);
+    if (harPath != nullptr) server.setExchangeCallback(onExchange);
+    if (!server.start()) return 1;
+
+    printf("Mezzo simulator: %d device(s) x %d zones on 127.0.0.1:%d-%d (latency %lu+%lu ms)\n",
+           config.numDevices, config.zonesPerDevice, port, port + config.numDevices - 1,
+           config.latencyMs, config.jitterMs);
+    fflush(stdout);
+
+    signal(SIGINT, onSignal);
+    signal(SIGTERM, onSignal);
+    auto lastStats = std::chrono::steady_clock::now();
+    while (!stopRequested) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        if (std::chrono::steady_clock::now() - lastStats > std::chrono::seconds(10)) {
+            printStats(sim);
+            lastStats = std::chrono::steady_clock::now();
+        }
+    }
+
+    server.stop();
+    printStats(sim);
+    if (harPath != nullptr) {
+        using namespace std::chrono;
+        int64_t wallOffsetUs = duration_cast<microseconds>(system_clock::now().time_since_epoch()).count() -
+                               duration_cast<microseconds>(steady_clock::now().time_since_epoch()).count();
+        if (!writeHar(harPath, port, wallOffsetUs)) {
+            fprintf(stderr, "Cannot write %s\n", harPath);
+            return 1;
+        }
+        printf("Wrote %zu requests to %s\n", harExchanges.size(), harPath);
+    }
+    return 0;
+}
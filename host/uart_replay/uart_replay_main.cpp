@@ -0,0 +1,202 @@
+// Replays a DGUS capture ("capture dump" on the firmware console) through
+// DMT_Display and measures parse and dispatch time per panel frame.
+//
+// Usage: program [--speed x] [--out results.json] capture.txt
+//
+// --speed 1 keeps the captured timing, 10 replays ten times faster and 0 as
+// fast as possible. TX frames in the capture are counted but not replayed.
+// Results are written as bench JSON so runs can be diffed with host/bench/compare.py.
+
+#include <Arduino.h>
+#include <HardwareSerial.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "DMT_Display.h"
+#include "Perf_Metrics.h"
+
+struct CapturedFrame {
+    bool tx;
+    uint64_t atUs;              // Since the first record
+    std::vector<uint8_t> bytes;
+};
+
+struct ReplayResult {
+    std::string name;
+    double value;
+    const char* unit;
+    unsigned long iterations;
+};
+
+static std::vector<ReplayResult> results;
+static unsigned long vpCallbacks = 0;
+static unsigned long rtcCallbacks = 0;
+
+static void onReplayVPData(uint8_t panel, uint16_t vpAddress, uint16_t vpData) {
+    (void)panel; (void)vpAddress; (void)vpData;
+    vpCallbacks++;
+}
+
+static void onReplayRTCData(uint8_t* rtcData, int length) {
+    (void)rtcData; (void)length;
+    rtcCallbacks++;
+}
+
+static int hexValue(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    return -1;
+}
+
+// Reads "<R|T> <delta us> <hex>" lines. Anything else in a serial log is
+// skipped, and only the last "#dmt-capture" block counts if there are several.
+static bool loadCapture(const char* path, std::vector<CapturedFrame>& frames) {
+    FILE* f = fopen(path, "r");
+    if (f == nullptr) return false;
+    char line[1024];
+    uint64_t atUs = 0;
+    while (fgets(line, sizeof(line), f)) {
+        const char* p = line;
+        while (*p == ' ' || *p == '\t') p++;
+        if (strncmp(p, "#dmt-capture v", 14) == 0) {
+            frames.clear();
+            atUs = 0;
+            continue;
+        }
+        if ((p[0] != 'R' && p[0] != 'T') || p[1] != ' ') continue;
+
+        char* end = nullptr;
+        unsigned long delta = strtoul(p + 2, &end, 10);
+        if (end == p + 2 || *end != ' ') continue;
+        CapturedFrame frame = {p[0] == 'T', atUs + delta, {}};
+        for (const char* h = end + 1; hexValue(h[0]) >= 0 && hexValue(h[1]) >= 0; h += 2) {
+            frame.bytes.push_back((uint8_t)(hexValue(h[0]) << 4 | hexValue(h[1])));
+        }
+        if (frame.bytes.empty()) continue;
+        atUs = frame.atUs;
+        frames.push_back(frame);
+    }
+    fclose(f);
+    return true;
+}
+
+static void report(const char* name, double value, const char* unit, unsigned long iterations) {
+    results.push_back({name, value, unit, iterations});
+    fprintf(stderr, "%-30s %14.2f %-8s (%lu)\n", name, value, unit, iterations);
+}
+
+static bool writeResults(const char* path) {
+    FILE* f = path ? fopen(path, "w") : stdout;
+    if (f == nullptr) return false;
+    fprintf(f, "{\n  \"benchmarks\": [\n");
+    for (size_t i = 0; i < results.size(); i++) {
+        fprintf(f, "    {\"name\": \"%s\", \"value\": %.4f, \"unit\": \"%s\", \"iterations\": %lu}%s\n",
+                results[i].name.c_str(), results[i].value, results[i].unit, results[i].iterations,
+                i + 1 < results.size() ? "," : "");
+    }
+    fprintf(f, "  ]\n}\n");
+    if (f != stdout) fclose(f);
+    return true;
+}
+
+static double percentile(std::vector<double>& samples, double p) {
+    if (samples.empty()) return 0.0;
+    std::sort(samples.begin(), samples.end());
+    size_t rank = (size_t)(p * samples.size() + 0.999999);
+    if (rank == 0) rank = 1;
+    return samples[std::min(rank, samples.size()) - 1];
+}
+
+int main(int argc, char** argv) {
+    const char* outPath = nullptr;
+    const char* capturePath = nullptr;
+    double speed = 1.0;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--out") == 0 && i + 1 < argc) {
+            outPath = argv[++i];
+        } else if (strcmp(argv[i], "--speed") == 0 && i + 1 < argc) {
+            speed = atof(argv[++i]);
+        } else if (argv[i][0] != '-' && capturePath == nullptr) {
+            capturePath = argv[i];
+        } else {
+            capturePath = nullptr;
+            break;
+        }
+    }
+    if (capturePath == nullptr || speed < 0.0) {
+        fprintf(stderr, "Usage: %s [--speed x] [--out results.json] capture.txt\n", argv[0]);
+        return 2;
+    }
+
+    std::vector<CapturedFrame> frames;
+    if (!loadCapture(capturePath, frames) || frames.empty()) {
+        fprintf(stderr, "No frames in %s\n", capturePath);
+        return 1;
+    }
+
+    HardwareSerial uart(1);
+    uart.setRxBufferSize(4096);
+    DMT_Display display(&uart);
+    display.begin(115200);
+    display.setVPDataCallback(onReplayVPData);
+    display.setRTCDataCallback(onReplayRTCData);
+    Serial.hostSetConsole(stderr);
+    perfMetrics.reset();
+
+    typedef std::chrono::steady_clock Clock;
+    std::vector<double> dispatchNs;
+    std::vector<uint64_t> rxTimes;
+    unsigned long txFrames = 0;
+    double maxLateMs = 0.0;
+    Clock::time_point start = Clock::now();
+
+    for (size_t i = 0; i < frames.size(); i++) {
+        const CapturedFrame& frame = frames[i];
+        if (frame.tx) {
+            txFrames++;
+            continue;
+        }
+        rxTimes.push_back(frame.atUs);
+        if (speed > 0.0) {
+            Clock::time_point due = start + std::chrono::microseconds((uint64_t)(frame.atUs / speed));
+            std::this_thread::sleep_until(due);
+            double lateMs = std::chrono::duration<double, std::milli>(Clock::now() - due).count();
+            if (lateMs > maxLateMs) maxLateMs = lateMs;
+        }
+        Clock::time_point t0 = Clock::now();
+        uart.hostInjectRx(frame.bytes.data(), frame.bytes.size());
+        display.handleIncomingData();
+        dispatchNs.push_back(std::chrono::duration<double, std::nano>(Clock::now() - t0).count());
+    }
+    double wallSeconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    // Busiest one-second window of panel traffic in the capture
+    unsigned long peakPerSecond = 0;
+    for (size_t lo = 0, hi = 0; hi < rxTimes.size(); hi++) {
+        while (rxTimes[hi] - rxTimes[lo] >= 1000000) lo++;
+        peakPerSecond = std::max(peakPerSecond, (unsigned long)(hi - lo + 1));
+    }
+
+    unsigned long rxFrames = dispatchNs.size();
+    double spanSeconds = frames.back().atUs / 1e6;
+    fprintf(stderr, "%s: %lu RX / %lu TX frames over %.1f s, replayed in %.2f s\n",
+            capturePath, rxFrames, txFrames, spanSeconds, wallSeconds);
+    report("replay_rx_frames", rxFrames, "frames", rxFrames);
+    report("replay_vp_callbacks", vpCallbacks, "calls", rxFrames);
+    report("replay_rtc_callbacks", rtcCallbacks, "calls", rxFrames);
+    report("replay_frames_dropped", perfMetrics.getCounter(PERF_COUNT_FRAMES_DROPPED), "frames", rxFrames);
+    report("replay_peak_rx_rate", peakPerSecond, "frames/s", rxFrames);
+    report("replay_dispatch_p50", percentile(dispatchNs, 0.50), "ns", rxFrames);
+    report("replay_dispatch_p99", percentile(dispatchNs, 0.99), "ns", rxFrames);
+    report("replay_dispatch_max", dispatchNs.empty() ? 0.0 : dispatchNs.back(), "ns", rxFrames);
+    if (speed > 0.0) report("replay_max_late", maxLateMs, "ms", rxFrames);
+
+    return writeResults(outPath) ? 0 : 1;
+}
@@ -0,0 +1,173 @@
+#include "Alloc_Trace.h"
+
+Alloc_Trace allocTrace;
+
+static const char* const regionNames[ALLOC_REGION_COUNT] = {
+    "loop", "uart_dispatch", "gain_enqueue", "gain_send", "http_serve"
+};
+
+// Regions that must never allocate
+static const uint32_t allocationFreeMask = (1UL << ALLOC_REGION_UART_DISPATCH) | (1UL << ALLOC_REGION_GAIN_ENQUEUE);
+
+// The IDF calls these after every heap_caps allocation and before every free,
+// from whichever task allocates; only the loop task's blocks reach the regions
+#if defined(ESP_PLATFORM) && defined(CONFIG_HEAP_USE_HOOKS)
+#define ALLOC_TRACE_HOOKS true
+
+extern "C" void esp_heap_trace_alloc_hook(void* ptr, size_t size, uint32_t caps) {
+    (void)ptr;
+    (void)caps;
+    allocTrace.onAllocate(size);
+}
+
+extern "C" void esp_heap_trace_free_hook(void* ptr) {
+    (void)ptr;
+    allocTrace.onFree();
+}
+#else
+#define ALLOC_TRACE_HOOKS false
+#endif
+
+// Constructor
+Alloc_Trace::Alloc_Trace() : _active(0), _loopTask(nullptr), _tracing(ALLOC_TRACE_HOOKS) {
+    reset();
+}
+
+// Allocator hooks
+void Alloc_Trace::onAllocate(size_t size) {
+    _allocations++;
+    uint32_t active = _active;
+    if (active == 0) return;
+#ifdef ESP_PLATFORM
+    if (xTaskGetCurrentTaskHandle() != _loopTask) return;
+#endif
+    for (int i = 0; i < ALLOC_REGION_COUNT; i++) {
+        if (active & (1UL << i)) {
+            _regions[i].allocations++;
+            _regions[i].bytes += size;
+        }
+    }
+    if (active & allocationFreeMask) {
+        _violations++;
+        _lastViolation = __builtin_ctz(active & allocationFreeMask);
+        _lastViolationSize = size;
+    }
+}
+
+// Regions
+uint32_t Alloc_Trace::enter(AllocRegionId id) {
+    uint32_t previous = _active;
+#ifdef ESP_PLATFORM
+    if (previous == 0) _loopTask = xTaskGetCurrentTaskHandle();
+#endif
+    _regions[id].entries++;
+    _active = previous | (1UL << id);
+    return previous;
+}
+
+// Heap shape
+void Alloc_Trace::poll() {
+    if (_sampleCount == 0 || millis() - _lastSampleMs >= ALLOC_TRACE_SAMPLE_MS) sampleHeap();
+}
+
+void Alloc_Trace::sampleHeap() {
+    AllocHeapSample sample;
+    sample.ms = millis();
+    sample.freeBytes = ESP.getFreeHeap();
+    sample.largestFree = ESP.getMaxAllocHeap();
+
+    if (_sampleCount < ALLOC_TRACE_HEAP_SAMPLES) {
+        _samples[(_sampleHead + _sampleCount++) % ALLOC_TRACE_HEAP_SAMPLES] = sample;
+    } else {
+        _samples[_sampleHead] = sample;
+        _sampleHead = (_sampleHead + 1) % ALLOC_TRACE_HEAP_SAMPLES;
+    }
+    if (sample.largestFree < _minLargestFree) _minLargestFree = sample.largestFree;
+    uint8_t fragmentation = fragmentationPercent(sample.freeBytes, sample.largestFree);
+    if (fragmentation > _maxFragmentation) _maxFragmentation = fragmentation;
+    _lastSampleMs = sample.ms;
+}
+
+// Share of the free heap that cannot be had in one block
+uint8_t Alloc_Trace::fragmentationPercent(uint32_t freeBytes, uint32_t largestFree) {
+    if (freeBytes == 0 || largestFree >= freeBytes) return 0;
+    return (uint8_t)(100 - (uint64_t)largestFree * 100 / freeBytes);
+}
+
+// Control
+void Alloc_Trace::reset() {
+    memset(_regions, 0, sizeof(_regions));
+    _allocations = 0;
+    _frees = 0;
+    _violations = 0;
+    _lastViolation = -1;
+    _lastViolationSize = 0;
+    _sampleHead = 0;
+    _sampleCount = 0;
+    _lastSampleMs = 0;
+    _minLargestFree = UINT32_MAX;
+    _maxFragmentation = 0;
+}
+
+// Access
+const AllocHeapSample& Alloc_Trace::getSample(size_t index) const {
+    return _samples[(_sampleHead + index) % ALLOC_TRACE_HEAP_SAMPLES];
+}
+
+bool Alloc_Trace::isAllocationFree(AllocRegionId id) {
+    return (allocationFreeMask & (1UL << id)) != 0;
+}
+
+const char* Alloc_Trace::regionName(AllocRegionId id) {
+    return id < ALLOC_REGION_COUNT ? regionNames[id] : "";
+}
+
+// Reports (each printf stays below the 64-byte stack buffer of Print::printf)
+void Alloc_Trace::printReport(Print& out) const {
+    if (!_tracing) out.println("🧱 Allocations not traced (CONFIG_HEAP_USE_HOOKS)");
+    out.printf("🧱 %lu allocations, %lu frees", (unsigned long)_allocations, (unsigned long)_frees);
+    out.printf(", %lu in allocation-free regions\n", (unsigned long)_violations);
+    if (_lastViolation >= 0) {
+        out.printf("  last: %lu bytes in %s\n", (unsigned long)_lastViolationSize,
+                   regionNames[_lastViolation]);
+    }
+    out.printf("  %-15s%10s%10s%10s\n", "region", "entries", "allocs", "bytes");
+    for (int i = 0; i < ALLOC_REGION_COUNT; i++) {
+        out.printf("  %-15s%10lu", regionNames[i], (unsigned long)_regions[i].entries);
+        out.printf("%10lu%10lu", (unsigned long)_regions[i].allocations, (unsigned long)_regions[i].bytes);
+        out.println(isAllocationFree((AllocRegionId)i) ? "  (must be 0)" : "");
+    }
+
+    out.printf("  %-10s%10s%10s%6s\n", "uptime s", "free", "largest", "frag");
+    for (size_t i = 0; i < _sampleCount; i++) {
+        const AllocHeapSample& s = getSample(i);
+        out.printf("  %-10lu%10lu%10lu", (unsigned long)(s.ms / 1000), (unsigned long)s.freeBytes,
+                   (unsigned long)s.largestFree);
+        out.printf("%5u%%\n", fragmentationPercent(s.freeBytes, s.largestFree));
+    }
+}
+
+void Alloc_Trace::printPrometheus(Print& out) const {
+    out.printf("panel_alloc_tracing %d\n", _tracing ? 1 : 0);
+    out.println("# TYPE panel_alloc_total counter");
+    for (int i = 0; i < ALLOC_REGION_COUNT; i++) {
+        out.printf("panel_alloc_total{region=\"%s\"} %lu\n", regionNames[i],
+                   (unsigned long)_regions[i].allocations);
+    }
+    out.println("# TYPE panel_alloc_violations_total counter");
+    out.printf("panel_alloc_violations_total %lu\n", (unsigned long)_violations);
+    if (_sampleCount == 0) return;
+    const AllocHeapSample& newest = getSample(_sampleCount - 1);
+    out.printf("panel_heap_fragmentation_percent %u\n",
+               fragmentationPercent(newest.freeBytes, newest.largestFree));
+    out.printf("panel_heap_fragmentation_max_percent %u\n", _maxFragmentation);
+    out.printf("panel_heap_min_largest_free_bytes %lu\n", (unsigned long)_minLargestFree);
+}
+
+// Region scope
+AllocRegionScope::AllocRegionScope(AllocRegionId id) : _previous(allocTrace.enter(id)) {
+}
+
+AllocRegionScope::~AllocRegionScope() {
+    allocTrace.leave(_previous);
+}
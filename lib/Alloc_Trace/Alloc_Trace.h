@@ -0,0 +1,113 @@
+#ifndef ALLOC_TRACE_H
+#define ALLOC_TRACE_H
+
+#include <Arduino.h>
+
+// Heap shape samples kept in the ring, one every ALLOC_TRACE_SAMPLE_MS
+#ifndef ALLOC_TRACE_HEAP_SAMPLES
+#define ALLOC_TRACE_HEAP_SAMPLES 64
+#endif
+
+#ifndef ALLOC_TRACE_SAMPLE_MS
+#define ALLOC_TRACE_SAMPLE_MS 10000
+#endif
+
+// Code regions allocations are charged to; nested regions are all charged
+enum AllocRegionId {
+    ALLOC_REGION_LOOP = 0,         // One loop() iteration
+    ALLOC_REGION_UART_DISPATCH,    // Complete panel frame through processDMTFrame() (allocation-free)
+    ALLOC_REGION_GAIN_ENQUEUE,     // Mezzo_Controller::queueGain() (allocation-free)
+    ALLOC_REGION_GAIN_SEND,        // Mezzo_Controller::service(): one queued write
+    ALLOC_REGION_HTTP_SERVE,       // Local HTTP server: one request
+    ALLOC_REGION_COUNT
+};
+
+struct AllocRegionStats {
+    uint32_t entries;
+    uint32_t allocations;
+    uint32_t bytes;
+};
+
+struct AllocHeapSample {
+    uint32_t ms;
+    uint32_t freeBytes;
+    uint32_t largestFree;          // Biggest single block malloc() could return
+};
+
+// Allocation counts per code region and the heap's shape over time. The
+// allocator reports every block through onAllocate()/onFree(): the ESP-IDF
+// heap hooks on the device (needs CONFIG_HEAP_USE_HOOKS in sdkconfig) and
+// Heap_Tracker in the host harness. Regions are entered from loop context
+// only; an allocation inside a region marked allocation-free counts as a
+// violation. Without hooks only the heap samples are kept.
+class Alloc_Trace {
+private:
+    AllocRegionStats _regions[ALLOC_REGION_COUNT];
+    volatile uint32_t _active;     // Bit per region entered and not yet left
+    volatile uint32_t _allocations;
+    volatile uint32_t _frees;
+    uint32_t _violations;
+    int _lastViolation;            // Region of the newest violation, -1 if none
+    size_t _lastViolationSize;
+    void* _loopTask;               // Task that enters regions (device only)
+    bool _tracing;
+    AllocHeapSample _samples[ALLOC_TRACE_HEAP_SAMPLES];
+    size_t _sampleHead;            // Index of the oldest sample
+    size_t _sampleCount;
+    unsigned long _lastSampleMs;
+    uint32_t _minLargestFree;
+    uint8_t _maxFragmentation;
+
+public:
+    // Constructor
+    Alloc_Trace();
+
+    // Allocator hooks
+    void onAllocate(size_t size);
+    void onFree() { _frees++; }
+    void setTracing(bool tracing) { _tracing = tracing; }  // For hooks installed at run time
+    bool isTracing() const { return _tracing; }             // False when the allocator reports nothing
+
+    // Regions
+    uint32_t enter(AllocRegionId id);
+    void leave(uint32_t previous) { _active = previous; }
+
+    // Heap shape
+    void poll();                   // Sample every ALLOC_TRACE_SAMPLE_MS, from loop()
+    void sampleHeap();
+    static uint8_t fragmentationPercent(uint32_t freeBytes, uint32_t largestFree);
+
+    // Control
+    void reset();
+
+    // Access
+    const AllocRegionStats& getRegion(AllocRegionId id) const { return _regions[id]; }
+    uint32_t getAllocations() const { return _allocations; }
+    uint32_t getFrees() const { return _frees; }
+    uint32_t getViolations() const { return _violations; }
+    int getLastViolation() const { return _lastViolation; }
+    uint32_t getMinLargestFree() const { return _minLargestFree; }
+    uint8_t getMaxFragmentation() const { return _maxFragmentation; }
+    size_t getSampleCount() const { return _sampleCount; }
+    const AllocHeapSample& getSample(size_t index) const;  // 0 is the oldest
+    static bool isAllocationFree(AllocRegionId id);
+    static const char* regionName(AllocRegionId id);
+
+    // Reports
+    void printReport(Print& out) const;      // Regions and the heap samples
+    void printPrometheus(Print& out) const;
+};
+
+// Charges the enclosing scope's allocations to one region
+class AllocRegionScope {
+private:
+    uint32_t _previous;
+
+public:
+    AllocRegionScope(AllocRegionId id);
+    ~AllocRegionScope();
+};
+
+extern Alloc_Trace allocTrace;
+
+#endif // ALLOC_TRACE_H
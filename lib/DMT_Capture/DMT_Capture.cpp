@@ -0,0 +1,110 @@
+#include "DMT_Capture.h"
+
+DMT_Capture dmtCapture;
+
+// Constructor
+DMT_Capture::DMT_Capture()
+    : _head(0), _used(0), _lastUs(0), _records(0), _overwritten(0), _enabled(false) {
+}
+
+// Control
+void DMT_Capture::setEnabled(bool enabled) {
+    // The first record after enabling starts a new timeline
+    if (enabled && !_enabled) _lastUs = micros();
+    _enabled = enabled;
+}
+
+void DMT_Capture::clear() {
+    _head = 0;
+    _used = 0;
+    _lastUs = micros();
+    _records = 0;
+    _overwritten = 0;
+}
+
+// Ring helpers
+void DMT_Capture::put(uint8_t value) {
+    _ring[(_head + _used) % DMT_CAPTURE_BUFFER_SIZE] = value;
+    _used++;
+}
+
+void DMT_Capture::putVarint(uint32_t value) {
+    while (value >= 0x80) {
+        put((uint8_t)(value | 0x80));
+        value >>= 7;
+    }
+    put((uint8_t)value);
+}
+
+// LEB128 at offset, which is moved past it
+uint32_t DMT_Capture::getVarint(size_t& offset) const {
+    uint32_t value = 0;
+    int shift = 0;
+    uint8_t b;
+    do {
+        b = at(offset++);
+        value |= (uint32_t)(b & 0x7F) << shift;
+        shift += 7;
+    } while (b & 0x80);
+    return value;
+}
+
+size_t DMT_Capture::recordSize(size_t offset) const {
+    size_t end = offset + 1;                  // Direction
+    getVarint(end);                           // Delta
+    size_t length = getVarint(end);
+    return end - offset + length;
+}
+
+void DMT_Capture::dropOldest() {
+    size_t size = recordSize(0);
+    _head = (_head + size) % DMT_CAPTURE_BUFFER_SIZE;
+    _used -= size;
+    _records--;
+    _overwritten++;
+}
+
+// Recording
+void DMT_Capture::append(DMTCaptureDirection direction, const uint8_t* frame, size_t length, uint32_t timestampUs) {
+    if (length > DMT_CAPTURE_MAX_FRAME) length = DMT_CAPTURE_MAX_FRAME;
+    uint32_t delta = timestampUs - _lastUs;
+    _lastUs = timestampUs;
+
+    size_t deltaBytes = 1;
+    for (uint32_t d = delta >> 7; d != 0; d >>= 7) deltaBytes++;
+    size_t need = 1 + deltaBytes + (length < 0x80 ? 1 : 2) + length;
+    while (DMT_CAPTURE_BUFFER_SIZE - _used < need) dropOldest();
+
+    put((uint8_t)direction);
+    putVarint(delta);
+    putVarint((uint32_t)length);
+    for (size_t i = 0; i < length; i++) put(frame[i]);
+    _records++;
+}
+
+// Dump (each print stays below the 64-byte stack buffer of Print::printf)
+void DMT_Capture::dump(Print& out) const {
+    out.printf("#dmt-capture v1 records=%lu overwritten=%lu\n",
+               (unsigned long)_records, (unsigned long)_overwritten);
+    static const char hexDigits[] = "0123456789ABCDEF";
+    size_t offset = 0;
+    bool first = true;
+    while (offset < _used) {
+        uint8_t direction = at(offset++);
+        uint32_t delta = getVarint(offset);
+        uint32_t length = getVarint(offset);
+
+        // The first record's delta points at an overwritten one
+        out.printf("%c %lu ", direction == DMT_CAPTURE_TX ? 'T' : 'R', first ? 0UL : (unsigned long)delta);
+        first = false;
+        char hex[2];
+        for (uint32_t i = 0; i < length; i++) {
+            uint8_t value = at(offset++);
+            hex[0] = hexDigits[value >> 4];
+            hex[1] = hexDigits[value & 0x0F];
+            out.write((const uint8_t*)hex, 2);
+        }
+        out.println();
+    }
+    out.println("#dmt-capture end");
+}
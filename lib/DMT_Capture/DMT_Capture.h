@@ -0,0 +1,66 @@
+#ifndef DMT_CAPTURE_H
+#define DMT_CAPTURE_H
+
+#include <Arduino.h>
+
+// RAM reserved for the capture ring; the oldest frames are overwritten
+#ifndef DMT_CAPTURE_BUFFER_SIZE
+#define DMT_CAPTURE_BUFFER_SIZE 8192
+#endif
+
+#define DMT_CAPTURE_MAX_FRAME 258   // Header, length byte and a full 255-byte payload
+
+enum DMTCaptureDirection {
+    DMT_CAPTURE_RX = 0,   // Panel to firmware
+    DMT_CAPTURE_TX = 1    // Firmware to panel
+};
+
+// Ring of DGUS frames with microsecond timestamps. Each record is
+// [direction][delta us since previous record, LEB128][length, LEB128][frame
+// bytes], so a slider upload costs about 14 bytes. Disabled by default; record() is a
+// single branch while off. Loop context only.
+class DMT_Capture {
+private:
+    uint8_t _ring[DMT_CAPTURE_BUFFER_SIZE];
+    size_t _head;           // Offset of the oldest record
+    size_t _used;
+    uint32_t _lastUs;
+    uint32_t _records;
+    uint32_t _overwritten;
+    bool _enabled;
+
+    void put(uint8_t value);
+    void putVarint(uint32_t value);
+    uint8_t at(size_t offset) const { return _ring[(_head + offset) % DMT_CAPTURE_BUFFER_SIZE]; }
+    uint32_t getVarint(size_t& offset) const;
+    size_t recordSize(size_t offset) const;
+    void dropOldest();
+
+public:
+    // Constructor
+    DMT_Capture();
+
+    // Control
+    void setEnabled(bool enabled);
+    bool isEnabled() const { return _enabled; }
+    void clear();
+
+    // Recording
+    void record(DMTCaptureDirection direction, const uint8_t* frame, size_t length, uint32_t timestampUs) {
+        if (_enabled) append(direction, frame, length, timestampUs);
+    }
+    void append(DMTCaptureDirection direction, const uint8_t* frame, size_t length, uint32_t timestampUs);
+
+    // Access
+    uint32_t getRecordCount() const { return _records; }
+    uint32_t getOverwritten() const { return _overwritten; }
+    size_t getUsedBytes() const { return _used; }
+
+    // Text dump, one frame per line: "<R|T> <delta us> <hex>", between
+    // "#dmt-capture" header and footer lines (read by host/uart_replay)
+    void dump(Print& out) const;
+};
+
+extern DMT_Capture dmtCapture;
+
+#endif // DMT_CAPTURE_H
@@ -1,9 +1,13 @@
 #include "DMT_Display.h"
-#include <cmath>
+#include "Perf_Metrics.h"
+#include "DMT_Capture.h"
+#include "Perf_Trace.h"
+#include "Alloc_Trace.h"
 
 // Constructor
 DMT_Display::DMT_Display(HardwareSerial* serial) 
-    : _serial(serial), _bufferIndex(0), _frameStarted(false), 
+    : _serial(serial), _panel(0), _bufferIndex(0), _frameStarted(false), _frameStartUs(0), _shadowCount(0),
+      _numWidgets(0), _page(DMT_PAGE_UNKNOWN), _baudRate(0), _unansweredReads(0), _registerReplies(0),
       _vpDataCallback(nullptr), _rtcDataCallback(nullptr) {
     memset(_dmtBuffer, 0, DMT_BUFFER_SIZE);
 }
@@ -11,12 +15,189 @@ DMT_Display::DMT_Display(HardwareSerial* serial)
 // Initialization
 void DMT_Display::begin(unsigned long baudRate, int rxPin, int txPin) {
     _serial->begin(baudRate, SERIAL_8N1, rxPin, txPin);
+    _baudRate = baudRate;
     _bufferIndex = 0;
     _frameStarted = false;
 }
 
+// UART rate
+static const unsigned long baudRates[] = {DMT_BAUD_TABLE};
+
+int DMT_Display::baudCode(unsigned long baudRate) {
+    for (size_t i = 0; i < sizeof(baudRates) / sizeof(baudRates[0]); i++) {
+        if (baudRates[i] == baudRate) return (int)i;
+    }
+    return -1;
+}
+
+void DMT_Display::setBaud(unsigned long baudRate) {
+    _serial->flush();
+    _serial->updateBaudRate(baudRate);
+    _baudRate = baudRate;
+    // Whatever arrived around the switch is garbled
+    while (_serial->available()) _serial->read();
+    _bufferIndex = 0;
+    _frameStarted = false;
+    _unansweredReads = 0;
+}
+
+bool DMT_Display::ping(unsigned long timeoutMs) {
+    uint32_t replies = _registerReplies;
+    requestPage();
+    unsigned long start = millis();
+    while (millis() - start < timeoutMs) {
+        handleIncomingData();
+        if (_registerReplies != replies) return true;
+        delay(1);
+    }
+    return false;
+}
+
+bool DMT_Display::negotiateBaud(unsigned long baudRate, unsigned long timeoutMs) {
+    int code = baudCode(baudRate);
+    if (code < 0) return false;
+    if (baudRate == _baudRate) return true;
+    unsigned long previous = _baudRate;
+    writeRegister(DMT_REG_BAUD, code >> 8, code & 0xFF);
+    setBaud(baudRate);
+    if (ping(timeoutMs)) return true;
+
+    // The panel may have switched with only the reply lost: ask it back at the new rate
+    int previousCode = baudCode(previous);
+    if (previousCode >= 0) writeRegister(DMT_REG_BAUD, previousCode >> 8, previousCode & 0xFF);
+    setBaud(previous);
+    ping(timeoutMs);
+    return false;
+}
+
+// Every frame to the panel goes through here so it can be captured and shadowed
+void DMT_Display::sendFrame(const uint8_t* frame, size_t length) {
+    _serial->write(frame, length);
+    noteFrame(frame, length);
+}
+
+// Capture, shadow and page switches of a frame already written
+void DMT_Display::noteFrame(const uint8_t* frame, size_t length) {
+    dmtCapture.record(DMT_CAPTURE_TX, frame, length, micros());
+    if (length == 8 && frame[2] == 0x05 && frame[3] == DMT_CMD_WRITE_VP) {
+        uint16_t vpAddress = (frame[4] << 8) | frame[5];
+        uint16_t value = (frame[6] << 8) | frame[7];
+        updateShadow(vpAddress, value, DMT_SHADOW_TX);
+        if (vpAddress == DMT_VP_PAGE_SWITCH) setPage(value);
+    } else if (length == 7 && frame[3] == DMT_CMD_WRITE_REG && frame[4] == DMT_REG_PIC_ID) {
+        setPage((frame[5] << 8) | frame[6]);
+    }
+}
+
+// Page tracking
+void DMT_Display::bindWidgetPage(uint16_t vpAddress, uint16_t page) {
+    for (int i = 0; i < _numWidgets; i++) {
+        if (_widgets[i].vpAddress == vpAddress) {
+            _widgets[i].page = page;
+            return;
+        }
+    }
+    if (_numWidgets < DMT_MAX_PAGE_WIDGETS) _widgets[_numWidgets++] = {vpAddress, page, 0, false};
+}
+
+int DMT_Display::getDeferredCount() const {
+    int count = 0;
+    for (int i = 0; i < _numWidgets; i++) {
+        if (_widgets[i].deferred) count++;
+    }
+    return count;
+}
+
+// Writes go through while the page is unknown
+bool DMT_Display::deferWrite(uint16_t vpAddress, uint16_t vpData) {
+    if (_page == DMT_PAGE_UNKNOWN) return false;
+    for (int i = 0; i < _numWidgets; i++) {
+        DMTPageWidget& widget = _widgets[i];
+        if (widget.vpAddress != vpAddress) continue;
+        if (widget.page == _page) {
+            widget.deferred = false;
+            return false;
+        }
+        widget.value = vpData;
+        widget.deferred = true;
+        perfMetrics.increment(PERF_COUNT_VP_DEFERRED);
+        return true;
+    }
+    return false;
+}
+
+void DMT_Display::setPage(uint16_t page) {
+    if (page == _page) return;
+    _page = page;
+    flushPage();
+}
+
+// Deferred widgets of the page now shown, as back-to-back 0x82 frames in one UART write
+void DMT_Display::flushPage() {
+    uint8_t burst[DMT_MAX_PAGE_WIDGETS * 8];
+    size_t length = 0;
+    for (int i = 0; i < _numWidgets; i++) {
+        DMTPageWidget& widget = _widgets[i];
+        if (!widget.deferred || widget.page != _page) continue;
+        uint8_t* frame = burst + length;
+        frame[0] = DMT_HEADER_1;
+        frame[1] = DMT_HEADER_2;
+        frame[2] = 0x05;
+        frame[3] = DMT_CMD_WRITE_VP;
+        frame[4] = widget.vpAddress >> 8;
+        frame[5] = widget.vpAddress & 0xFF;
+        frame[6] = widget.value >> 8;
+        frame[7] = widget.value & 0xFF;
+        widget.deferred = false;
+        length += 8;
+    }
+    if (length == 0) return;
+    _serial->write(burst, length);
+    for (size_t offset = 0; offset < length; offset += 8) noteFrame(burst + offset, 8);
+}
+
+// VP shadow
+void DMT_Display::updateShadow(uint16_t vpAddress, uint16_t value, DMTShadowSource source) {
+    int slot = -1;
+    for (int i = 0; i < _shadowCount; i++) {
+        if (_shadow[i].vpAddress == vpAddress) {
+            slot = i;
+            break;
+        }
+    }
+    if (slot < 0 && _shadowCount < DMT_VP_SHADOW_SIZE) {
+        slot = _shadowCount++;
+    } else if (slot < 0) {
+        slot = 0;
+        for (int i = 1; i < _shadowCount; i++) {
+            if (millis() - _shadow[i].updatedMs > millis() - _shadow[slot].updatedMs) slot = i;
+        }
+    }
+    _shadow[slot] = {vpAddress, value, (uint32_t)millis(), (uint8_t)source};
+}
+
+bool DMT_Display::getShadowVP(uint16_t vpAddress, uint16_t& value) const {
+    for (int i = 0; i < _shadowCount; i++) {
+        if (_shadow[i].vpAddress == vpAddress) {
+            value = _shadow[i].value;
+            return true;
+        }
+    }
+    return false;
+}
+
+void DMT_Display::printShadow(Print& out) const {
+    out.printf("🧮 VP shadow, %d of %d entries\n", _shadowCount, DMT_VP_SHADOW_SIZE);
+    if (_page != DMT_PAGE_UNKNOWN) out.printf("  page %u, %d writes deferred\n", _page, getDeferredCount());
+    for (int i = 0; i < _shadowCount; i++) {
+        const DMTShadowEntry& e = _shadow[i];
+        out.printf("  0x%04X = 0x%04X %s %lu ms ago\n", e.vpAddress, e.value,
+                   e.source == DMT_SHADOW_RX ? "panel" : "fw   ", (unsigned long)(millis() - e.updatedMs));
+    }
+}
+
 // Callback setters
-void DMT_Display::setVPDataCallback(void (*callback)(uint16_t vpAddress, uint16_t vpData)) {
+void DMT_Display::setVPDataCallback(void (*callback)(uint8_t panel, uint16_t vpAddress, uint16_t vpData)) {
     _vpDataCallback = callback;
 }
 
@@ -34,21 +215,21 @@ void DMT_Display::writeRegister(uint8_t regAddress, uint8_t dataHigh, uint8_t da
         dataHigh,                      // Data high byte
         dataLow                        // Data low byte
     };
-    _serial->write(writeRegCommand, sizeof(writeRegCommand));
+    sendFrame(writeRegCommand, sizeof(writeRegCommand));
 }
 
-// Function to read from DGUS1 Register (1 byte data only)
-uint8_t DMT_Display::readRegister(uint8_t regAddress) {
+// Function to read DGUS1 Registers; the reply is handled in processDMTFrame()
+void DMT_Display::readRegister(uint8_t regAddress, uint8_t count) {
     uint8_t readRegCommand[] = {
         DMT_HEADER_1, DMT_HEADER_2,    // Header
         0x03,                          // Length (3 bytes after header)
         DMT_CMD_READ_RTC,              // Read Register command
         regAddress,                    // Register address (1 byte)
-        0x01                           // Read 1 byte
+        count                          // Bytes to read
     };
     
-    _serial->write(readRegCommand, sizeof(readRegCommand));
-    return 0; // Placeholder - actual reading handled in callback
+    if (_unansweredReads < 0xFF) _unansweredReads++;
+    sendFrame(readRegCommand, sizeof(readRegCommand));
 }
 
 // Function to write volume (0-100) to VP address
@@ -56,6 +237,7 @@ void DMT_Display::writeVP(uint16_t vpAddress, int volume) {
     if (volume < 0) volume = 0;
     if (volume > 100) volume = 100;
     uint16_t vpData = ((uint16_t)volume << 8); // High byte is volume, low byte is 0x00
+    if (deferWrite(vpAddress, vpData)) return;
     
     uint8_t writeVPCommand[] = {
         DMT_HEADER_1, DMT_HEADER_2,    // Header
@@ -66,11 +248,12 @@ void DMT_Display::writeVP(uint16_t vpAddress, int volume) {
         (uint8_t)(vpData >> 8),        // Data high byte (volume)
         (uint8_t)(vpData & 0xFF)       // Data low byte (0x00)
     };
-    _serial->write(writeVPCommand, sizeof(writeVPCommand));
+    sendFrame(writeVPCommand, sizeof(writeVPCommand));
 }
 
 // Function to write raw VP data to VP address
 void DMT_Display::writeVP(uint16_t vpAddress, uint16_t vpData) {
+    if (deferWrite(vpAddress, vpData)) return;
     uint8_t writeVPCommand[] = {
         DMT_HEADER_1, DMT_HEADER_2,    // Header
         0x05,                          // Length
@@ -80,7 +263,7 @@ void DMT_Display::writeVP(uint16_t vpAddress, uint16_t vpData) {
         (uint8_t)(vpData >> 8),        // Data high byte
         (uint8_t)(vpData & 0xFF)       // Data low byte
     };
-    _serial->write(writeVPCommand, sizeof(writeVPCommand));
+    sendFrame(writeVPCommand, sizeof(writeVPCommand));
 }
 
 // Function to write ASCII text to DMT VP address (GBK encoding, 1 byte per character)
@@ -89,11 +272,12 @@ void DMT_Display::writeText(uint16_t vpAddress, const char* text) {
     
     int textLen = strlen(text);
     if (textLen == 0) return;
+    if (textLen > DMT_TEXT_MAX) textLen = DMT_TEXT_MAX;
     
     // Calculate frame length: header(2) + length(1) + command(1) + VP_addr(2) + text_data
     int frameLen = 3 + 1 + 2 + textLen; // 3 for header+length, 1 for command, 2 for VP address, textLen for text
     
-    uint8_t* writeTextCommand = new uint8_t[frameLen];
+    uint8_t writeTextCommand[6 + DMT_TEXT_MAX];
     
     writeTextCommand[0] = DMT_HEADER_1;               // Header
     writeTextCommand[1] = DMT_HEADER_2;               // Header
@@ -107,8 +291,7 @@ void DMT_Display::writeText(uint16_t vpAddress, const char* text) {
         writeTextCommand[6 + i] = (uint8_t)text[i];
     }
     
-    _serial->write(writeTextCommand, frameLen);
-    delete[] writeTextCommand;
+    sendFrame(writeTextCommand, frameLen);
 }
 
 // Function to write single ASCII character to DMT VP address
@@ -128,41 +311,18 @@ uint16_t DMT_Display::readVP(uint16_t vpAddress) {
         0x01                           // Read 1 word (2 bytes)
     };
     
-    _serial->write(readVPCommand, sizeof(readVPCommand));
+    sendFrame(readVPCommand, sizeof(readVPCommand));
     return 0; // Placeholder - actual reading handled in callback
 }
 
-// Function to map gain (0.0-1.0) to VP data (high byte = volume_converted, low byte = 0x00)
-uint16_t DMT_Display::mapGainToVP(float gain) {
-    if (gain <= 0.0f) return 0x0000;  // Volume 0 → VP data 0x0000
-    if (gain >= 1.0f) return 0x6400;  // Volume 100 → VP data 0x6400
-    
-    // Reverse calculation: find volume_converted from gain
-    // GAIN = (2^(dec_volume/10))/1000, so dec_volume = 10 * log2(gain * 1000)
-    float volume_converted = 10.0f * log2f(gain * 1000.0f);
-    if (volume_converted < 0.0f) volume_converted = 0.0f;
-    if (volume_converted > 100.0f) volume_converted = 100.0f;
-    
-    // Create VP data: high byte = volume_converted (0-100), low byte = 0x00
-    uint8_t volumeByte = (uint8_t)round(volume_converted);
-    uint16_t vpData = (volumeByte << 8) | 0x00;  // Format: 0xVV00 where VV is volume_converted
-    
-    return vpData;
+// Function to map gain (0-GAIN_UNITY) to VP data (high byte = volume_converted, low byte = 0x00)
+uint16_t DMT_Display::mapGainToVP(FixedGain gain) {
+    return (uint16_t)(calculateHighByteFromGain(gain) << 8);
 }
 
-// Function to calculate high byte value from gain using reverse formula
-uint8_t DMT_Display::calculateHighByteFromGain(float gain) {
-    if (gain <= 0.0f) return 0x00;
-    if (gain >= 1.0f) return 0x64;  // 100 decimal = 0x64
-    
-    // Reverse formula: gain = (2^(volume/10))/1000
-    // So: volume = 10 * log2(gain * 1000)
-    float volume = 10.0f * log2f(gain * 1000.0f);
-    if (volume < 0.0f) volume = 0.0f;
-    if (volume > 100.0f) volume = 100.0f;
-    
-    uint8_t highByte = (uint8_t)round(volume);
-    return highByte;
+// Function to calculate high byte value from gain: volume = 10 * log2(gain * 1000), rounded
+uint8_t DMT_Display::calculateHighByteFromGain(FixedGain gain) {
+    return (uint8_t)volumeFromGain(gain);
 }
 
 // Function to map VP data to volume percentage
@@ -185,38 +345,44 @@ void DMT_Display::handleIncomingData() {
         if (!_frameStarted) {
             if (_bufferIndex == 0 && incomingByte == DMT_HEADER_1) {
                 _dmtBuffer[_bufferIndex++] = incomingByte;
+                _frameStartUs = micros();
             } else if (_bufferIndex == 1 && incomingByte == DMT_HEADER_2) {
                 _dmtBuffer[_bufferIndex++] = incomingByte;
                 _frameStarted = true;
             } else {
-                _bufferIndex = 0; // Reset if header not found
+                if (_bufferIndex == 1) perfMetrics.increment(PERF_COUNT_FRAMES_DROPPED);
+                // A repeated 0x5A may be the real start of the next frame
+                if (incomingByte == DMT_HEADER_1) {
+                    _bufferIndex = 1;
+                    _frameStartUs = micros();
+                } else {
+                    _bufferIndex = 0; // Reset if header not found
+                }
             }
         } else {
             // Frame started, collect data
-            if (_bufferIndex < DMT_BUFFER_SIZE) {
-                _dmtBuffer[_bufferIndex++] = incomingByte;
-                
-                // Check if we have received length byte (3rd byte)
-                if (_bufferIndex == 3) {
-                    uint8_t frameLength = _dmtBuffer[2] + 3; // Length + header(2) + length byte(1)
-                    if (frameLength > DMT_BUFFER_SIZE) {
-                        _bufferIndex = 0;
-                        _frameStarted = false;
-                        return;
-                    }
-                }
-                
-                // Check if we have received the complete frame
-                if (_bufferIndex >= 3) {
-                    uint8_t expectedFrameLength = _dmtBuffer[2] + 3;
-                    if (_bufferIndex >= expectedFrameLength) {
-                        // Complete frame received
-                        processDMTFrame(_dmtBuffer, _bufferIndex);
-                        _bufferIndex = 0;
-                        _frameStarted = false;
-                    }
+            _dmtBuffer[_bufferIndex++] = incomingByte;
+            
+            // Length byte (3rd byte) counts the bytes after it; int so 0xFD-0xFF cannot wrap
+            int expectedFrameLength = _dmtBuffer[2] + 3;
+            if (expectedFrameLength > DMT_BUFFER_SIZE) {
+                perfMetrics.increment(PERF_COUNT_FRAMES_DROPPED);
+                _bufferIndex = 0;
+                _frameStarted = false;
+                continue;
+            }
+            
+            // Check if we have received the complete frame
+            if (_bufferIndex >= expectedFrameLength) {
+                perfMetrics.increment(PERF_COUNT_FRAMES_RECEIVED);
+                dmtCapture.record(DMT_CAPTURE_RX, _dmtBuffer, _bufferIndex, _frameStartUs);
+                perfTrace.begin(PERF_TRACE_DMT_FRAME, _bufferIndex >= 6 ? (_dmtBuffer[4] << 8) | _dmtBuffer[5] : 0);
+                {
+                    AllocRegionScope region(ALLOC_REGION_UART_DISPATCH);
+                    processDMTFrame(_dmtBuffer, _bufferIndex);
                 }
-            } else {
+                perfTrace.end(PERF_TRACE_DMT_FRAME);
+                perfMetrics.record(PERF_HIST_UART_DISPATCH, micros() - _frameStartUs);
                 _bufferIndex = 0;
                 _frameStarted = false;
             }
@@ -226,7 +392,13 @@ void DMT_Display::handleIncomingData() {
 
 // Function to process complete DMT frame
 void DMT_Display::processDMTFrame(uint8_t* frame, int frameLength) {
-    if (frameLength < 4) return; // Minimum frame size: header(2) + length(1) + command(1)
+    // Minimum frame size: header(2) + length(1) + command(1), and the
+    // length byte must not claim more bytes than the caller passed
+    if (frameLength < 4 || frame[2] + 3 > frameLength) {
+        perfMetrics.increment(PERF_COUNT_FRAMES_DROPPED);
+        return;
+    }
+    frameLength = frame[2] + 3; // Ignore anything past the declared length
     
     uint8_t command = frame[3];
     
@@ -236,14 +408,30 @@ void DMT_Display::processDMTFrame(uint8_t* frame, int frameLength) {
                 uint16_t vpAddress = (frame[4] << 8) | frame[5];
                 uint16_t vpData = (frame[6] << 8) | frame[7];
                 
+                // The word itself follows the word count (frame[6])
+                if (frameLength >= 9 && frame[6] == 0x01) {
+                    updateShadow(vpAddress, (frame[7] << 8) | frame[8], DMT_SHADOW_RX);
+                }
+                
+                // A touched widget is on the page being shown
+                for (int i = 0; i < _numWidgets; i++) {
+                    if (_widgets[i].vpAddress == vpAddress) setPage(_widgets[i].page);
+                }
+                
                 // Call user callback if set
                 if (_vpDataCallback) {
-                    _vpDataCallback(vpAddress, vpData);
+                    _vpDataCallback(_panel, vpAddress, vpData);
                 }
             }
             break;
             
         case DMT_CMD_READ_RTC: // 0x81 - RTC data
+            _unansweredReads = 0;
+            _registerReplies++;
+            // 5A A5 LEN 81 REG N DATA...; the page register is tracked here
+            if (frameLength >= 8 && frame[4] == DMT_REG_PIC_ID && frame[5] >= 2) {
+                setPage((frame[6] << 8) | frame[7]);
+            }
             if (frameLength >= 5) {
                 // Call user callback if set
                 if (_rtcDataCallback) {
@@ -271,7 +459,7 @@ void DMT_Display::showWiFiIcon(bool isConnected) {
         0x20, 0x00,                    // VP address 0x2000 (WiFi icon)
         0x00, static_cast<uint8_t>(isConnected ? 0x01 : 0x00) // Data (WiFi ON/OFF)
     };
-    _serial->write(wifiCommand, sizeof(wifiCommand));
+    sendFrame(wifiCommand, sizeof(wifiCommand));
 }
 
 void DMT_Display::showConnectionStatus(const char* message, uint16_t vpAddress) {
@@ -284,18 +472,14 @@ void DMT_Display::showConnectionError(const char* message, uint16_t vpAddress) {
 
 void DMT_Display::clearText(uint16_t vpAddress, int numChars) {
     // Create a string with specified number of spaces
-    char* spaces = new char[numChars + 1];
-    for (int i = 0; i < numChars; i++) {
-        spaces[i] = ' ';
-    }
-    spaces[numChars] = '\0';
-    
-    writeText(vpAddress, spaces);
-    delete[] spaces;
+    Fixed_String<DMT_TEXT_MAX + 1> spaces;
+    spaces.append(' ', numChars > 0 ? numChars : 0);
+    writeText(vpAddress, spaces.c_str());
 }
 
 void DMT_Display::showRSSI(int rssi, uint16_t vpAddress) {
-    String rssiMsg = "RSSI=" + String(rssi);
+    Fixed_String<16> rssiMsg;
+    rssiMsg.appendf("RSSI=%d", rssi);
     writeText(vpAddress, rssiMsg.c_str());
 }
 
@@ -320,5 +504,5 @@ void DMT_Display::showNodeOnlineIcon(uint16_t vpAddress, bool online) {
         (uint8_t)(vpAddress & 0xFF),   // VP address low byte
         0x00, static_cast<uint8_t>(online ? 0x01 : 0x00) // Data (0x01 online, 0x00 offline)
     };
-    _serial->write(iconCommand, sizeof(iconCommand));
+    sendFrame(iconCommand, sizeof(iconCommand));
 }
@@ -3,6 +3,8 @@
 
 #include <Arduino.h>
 #include <HardwareSerial.h>
+#include "Gain_Fixed.h"
+#include "Fixed_String.h"
 
 // DMT Protocol Constants
 #define DMT_HEADER_1 0x5A
@@ -12,6 +14,33 @@
 #define DMT_CMD_WRITE_VP 0x82
 #define DMT_CMD_WRITE_REG 0x80  // DGUS1 Write Register command
 #define DMT_BUFFER_SIZE 64
+#define DMT_TEXT_MAX 252        // Text bytes in one write; the length byte also counts command and VP
+
+// Current page: DGUS1 PIC_ID register (2 bytes), or a write to the page-switch VP
+#define DMT_REG_PIC_ID 0x03
+#define DMT_VP_PAGE_SWITCH 0x0010
+#define DMT_PAGE_UNKNOWN 0xFFFF
+
+// UART rate register (16-bit code, index into DMT_BAUD_TABLE)
+#ifndef DMT_REG_BAUD
+#define DMT_REG_BAUD 0x0C
+#endif
+// Rate of each register code, in code order; match it to the panel's configuration
+#ifndef DMT_BAUD_TABLE
+#define DMT_BAUD_TABLE 9600, 19200, 38400, 57600, 115200, 230400, 460800, 921600
+#endif
+#define DMT_BAUD_VERIFY_MS 100          // Wait for a register read-back at a new rate
+#define DMT_LINK_LOST_READS 5           // Register reads in a row without a reply
+
+// VP words remembered as last written to or uploaded by the panel
+#ifndef DMT_VP_SHADOW_SIZE
+#define DMT_VP_SHADOW_SIZE 32
+#endif
+
+// VP words bound to a page; writes to them wait until that page is shown
+#ifndef DMT_MAX_PAGE_WIDGETS
+#define DMT_MAX_PAGE_WIDGETS 16
+#endif
 
 // Volume mapping constants
 #define VP_MIN_VALUE 0x100
@@ -19,17 +48,53 @@
 #define VOLUME_MIN 0
 #define VOLUME_MAX 100
 
+enum DMTShadowSource {
+    DMT_SHADOW_TX = 0,   // Written by the firmware (0x82)
+    DMT_SHADOW_RX = 1    // Uploaded by the panel (0x83)
+};
+
+struct DMTShadowEntry {
+    uint16_t vpAddress;
+    uint16_t value;
+    uint32_t updatedMs;
+    uint8_t source;
+};
+
+struct DMTPageWidget {
+    uint16_t vpAddress;
+    uint16_t page;
+    uint16_t value;                 // Newest value while deferred
+    bool deferred;
+};
+
 class DMT_Display {
 private:
     HardwareSerial* _serial;
+    uint8_t _panel;                     // Index among the controller's panels
     uint8_t _dmtBuffer[DMT_BUFFER_SIZE];
     int _bufferIndex;
     bool _frameStarted;
+    uint32_t _frameStartUs;             // When the first header byte arrived
+    DMTShadowEntry _shadow[DMT_VP_SHADOW_SIZE];
+    int _shadowCount;
+    DMTPageWidget _widgets[DMT_MAX_PAGE_WIDGETS];
+    int _numWidgets;
+    uint16_t _page;                     // Page shown, DMT_PAGE_UNKNOWN until read or switched
+    unsigned long _baudRate;
+    uint8_t _unansweredReads;           // Register reads since the last 0x81 reply
+    uint32_t _registerReplies;
     
     // Callback function pointers
-    void (*_vpDataCallback)(uint16_t vpAddress, uint16_t vpData);
+    void (*_vpDataCallback)(uint8_t panel, uint16_t vpAddress, uint16_t vpData);
     void (*_rtcDataCallback)(uint8_t* rtcData, int length);
     
+    void sendFrame(const uint8_t* frame, size_t length);
+    void noteFrame(const uint8_t* frame, size_t length);
+    void updateShadow(uint16_t vpAddress, uint16_t value, DMTShadowSource source);
+    bool deferWrite(uint16_t vpAddress, uint16_t vpData);
+    void setPage(uint16_t page);
+    void flushPage();
+    
 public:
     // Constructor
     DMT_Display(HardwareSerial* serial);
@@ -37,13 +102,28 @@ public:
     // Initialization
     void begin(unsigned long baudRate = 115200, int rxPin = 20, int txPin = 21);
     
+    // UART rate: the panel's rate register is written at the current rate,
+    // both ends switch, and a register read must come back at the new rate;
+    // otherwise both ends return to the old one. Blocks for up to 2 x timeoutMs.
+    bool negotiateBaud(unsigned long baudRate, unsigned long timeoutMs = DMT_BAUD_VERIFY_MS);
+    void setBaud(unsigned long baudRate);          // This end only, after the TX FIFO drained
+    unsigned long getBaudRate() const { return _baudRate; }
+    static int baudCode(unsigned long baudRate);   // -1 for a rate the panel cannot take
+    bool ping(unsigned long timeoutMs = DMT_BAUD_VERIFY_MS);   // Blocking register read
+    bool isLinkLost() const { return _unansweredReads >= DMT_LINK_LOST_READS; }
+    void flush() { _serial->flush(); }             // Wait until every byte is on the wire
+    
+    // Panel number passed to the VP callback (DMT_Panels numbers its panels)
+    void setPanel(uint8_t panel) { _panel = panel; }
+    uint8_t getPanel() const { return _panel; }
+    
     // Callback setters
-    void setVPDataCallback(void (*callback)(uint16_t vpAddress, uint16_t vpData));
+    void setVPDataCallback(void (*callback)(uint8_t panel, uint16_t vpAddress, uint16_t vpData));
     void setRTCDataCallback(void (*callback)(uint8_t* rtcData, int length));
     
-    // DGUS1 Register functions
+    // DGUS1 Register functions; the reply arrives as a 0x81 frame (RTC callback)
     void writeRegister(uint8_t regAddress, uint8_t dataHigh, uint8_t dataLow);
-    uint8_t readRegister(uint8_t regAddress);
+    void readRegister(uint8_t regAddress, uint8_t count = 1);
     
     // DGUS1 VP functions - overloaded for different data types
     void writeVP(uint16_t vpAddress, int volume);           // Volume 0-100
@@ -53,14 +133,27 @@ public:
     uint16_t readVP(uint16_t vpAddress);
     
     // Volume mapping utilities
-    uint16_t mapGainToVP(float gain);
-    uint8_t calculateHighByteFromGain(float gain);
+    uint16_t mapGainToVP(FixedGain gain);
+    uint8_t calculateHighByteFromGain(FixedGain gain);
     int mapVPToVolume(uint16_t vpData);
     
     // Frame processing
     void handleIncomingData();
     void processDMTFrame(uint8_t* frame, int frameLength);
     
+    // Page tracking: widgets bound to a page get writes only while it is shown;
+    // the newest deferred value of each goes out in one burst when it is
+    void bindWidgetPage(uint16_t vpAddress, uint16_t page);
+    void requestPage() { readRegister(DMT_REG_PIC_ID, 2); }
+    uint16_t getPage() const { return _page; }
+    int getDeferredCount() const;
+    
+    // VP shadow: single-word VPs only, least recently updated entry replaced when full
+    bool getShadowVP(uint16_t vpAddress, uint16_t& value) const;
+    int getShadowCount() const { return _shadowCount; }
+    void clearShadow() { _shadowCount = 0; }
+    void printShadow(Print& out) const;
+    
     // WiFi status display helpers
     void showWiFiIcon(bool isConnected);
     void showNodeOnlineIcon(uint16_t vpAddress, bool online);
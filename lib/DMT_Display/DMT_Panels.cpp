@@ -0,0 +1,83 @@
+#include "DMT_Panels.h"
+
+// Constructor
+DMT_Panels::DMT_Panels() : _numPanels(0) {
+}
+
+// Configuration
+bool DMT_Panels::add(DMT_Display* display) {
+    if (_numPanels == DMT_MAX_PANELS) return false;
+    display->setPanel((uint8_t)_numPanels);
+    _panels[_numPanels++] = display;
+    return true;
+}
+
+void DMT_Panels::setVPDataCallback(void (*callback)(uint8_t panel, uint16_t vpAddress, uint16_t vpData)) {
+    for (int i = 0; i < _numPanels; i++) _panels[i]->setVPDataCallback(callback);
+}
+
+// Loop
+void DMT_Panels::handleIncomingData() {
+    for (int i = 0; i < _numPanels; i++) _panels[i]->handleIncomingData();
+}
+
+// Page tracking
+void DMT_Panels::bindWidgetPage(uint16_t vpAddress, uint16_t page) {
+    for (int i = 0; i < _numPanels; i++) _panels[i]->bindWidgetPage(vpAddress, page);
+}
+
+void DMT_Panels::requestPage() {
+    for (int i = 0; i < _numPanels; i++) _panels[i]->requestPage();
+}
+
+// The touched panel already shows the value
+void DMT_Panels::mirrorVP(uint8_t fromPanel, uint16_t vpAddress, uint16_t vpData) {
+    for (int i = 0; i < _numPanels; i++) {
+        if (i != fromPanel) _panels[i]->writeVP(vpAddress, vpData);
+    }
+}
+
+// Writes to every panel
+void DMT_Panels::writeVP(uint16_t vpAddress, uint16_t vpData) {
+    for (int i = 0; i < _numPanels; i++) _panels[i]->writeVP(vpAddress, vpData);
+}
+
+void DMT_Panels::writeText(uint16_t vpAddress, const char* text) {
+    for (int i = 0; i < _numPanels; i++) _panels[i]->writeText(vpAddress, text);
+}
+
+void DMT_Panels::readVP(uint16_t vpAddress) {
+    for (int i = 0; i < _numPanels; i++) _panels[i]->readVP(vpAddress);
+}
+
+void DMT_Panels::showWiFiIcon(bool isConnected) {
+    for (int i = 0; i < _numPanels; i++) _panels[i]->showWiFiIcon(isConnected);
+}
+
+void DMT_Panels::showConnectionStatus(const char* message, uint16_t vpAddress) {
+    for (int i = 0; i < _numPanels; i++) _panels[i]->showConnectionStatus(message, vpAddress);
+}
+
+void DMT_Panels::showConnectionError(const char* message, uint16_t vpAddress) {
+    for (int i = 0; i < _numPanels; i++) _panels[i]->showConnectionError(message, vpAddress);
+}
+
+void DMT_Panels::clearText(uint16_t vpAddress, int numChars) {
+    for (int i = 0; i < _numPanels; i++) _panels[i]->clearText(vpAddress, numChars);
+}
+
+void DMT_Panels::showRSSI(int rssi, uint16_t vpAddress) {
+    for (int i = 0; i < _numPanels; i++) _panels[i]->showRSSI(rssi, vpAddress);
+}
+
+void DMT_Panels::showBootMessage(const char* message) {
+    for (int i = 0; i < _numPanels; i++) _panels[i]->showBootMessage(message);
+}
+
+// Diagnostics
+void DMT_Panels::printShadow(Print& out) const {
+    for (int i = 0; i < _numPanels; i++) {
+        if (_numPanels > 1) out.printf("Panel %d: ", i);
+        _panels[i]->printShadow(out);
+    }
+}
@@ -0,0 +1,55 @@
+#ifndef DMT_PANELS_H
+#define DMT_PANELS_H
+
+#include <Arduino.h>
+#include "DMT_Display.h"
+
+// Panels driven by one controller, each on its own UART
+#ifndef DMT_MAX_PANELS
+#define DMT_MAX_PANELS 2
+#endif
+
+// The panels of one controller as a single display: every write goes to each
+// panel, and every panel's UART is read. Each DMT_Display keeps its own
+// receive buffer and VP shadow; zone state lives in Mezzo_Controller only.
+class DMT_Panels {
+private:
+    DMT_Display* _panels[DMT_MAX_PANELS];
+    int _numPanels;
+
+public:
+    // Constructor
+    DMT_Panels();
+
+    // Configuration; the display's panel number is its index here
+    bool add(DMT_Display* display);
+    void setVPDataCallback(void (*callback)(uint8_t panel, uint16_t vpAddress, uint16_t vpData));
+    int getCount() const { return _numPanels; }
+    DMT_Display& get(int panel) { return *_panels[panel]; }
+
+    // Read every panel's UART
+    void handleIncomingData();
+
+    // Page tracking, per panel (see DMT_Display)
+    void bindWidgetPage(uint16_t vpAddress, uint16_t page);
+    void requestPage();
+
+    // A touch on one panel, shown on the others with one VP write each
+    void mirrorVP(uint8_t fromPanel, uint16_t vpAddress, uint16_t vpData);
+
+    // Writes to every panel
+    void writeVP(uint16_t vpAddress, uint16_t vpData);
+    void writeText(uint16_t vpAddress, const char* text);
+    void readVP(uint16_t vpAddress);
+    void showWiFiIcon(bool isConnected);
+    void showConnectionStatus(const char* message, uint16_t vpAddress = 0x3300);
+    void showConnectionError(const char* message, uint16_t vpAddress = 0x3400);
+    void clearText(uint16_t vpAddress, int numChars = 40);
+    void showRSSI(int rssi, uint16_t vpAddress = 0x3400);
+    void showBootMessage(const char* message = "Booting...");
+
+    // Diagnostics
+    void printShadow(Print& out) const;
+};
+
+#endif // DMT_PANELS_H
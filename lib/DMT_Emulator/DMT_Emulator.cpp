@@ -0,0 +1,368 @@
+#include "DMT_Emulator.h"
+#include <algorithm>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <pty.h>
+#include <termios.h>
+#include <unistd.h>
+
+// Constructor
+DMT_Emulator::DMT_Emulator()
+    : _vpMemory(65536, 0), _scriptPos(0), _scriptSorted(true), _recording(false), _ackWrites(false),
+      _baudRate(DMT_EMU_DEFAULT_BAUD), _baudFixed(false), _stats(), _frameCallback(nullptr) {
+    memset(_registers, 0, sizeof(_registers));
+    _registers[DMT_EMU_REG_BAUD + 1] = 4;   // 115200
+}
+
+// Options
+void DMT_Emulator::setAckWrites(bool enable) {
+    _ackWrites = enable;
+}
+
+void DMT_Emulator::setBaudFixed(bool fixed) {
+    _baudFixed = fixed;
+}
+
+// Same table as DMT_Display
+unsigned long DMT_Emulator::baudFromCode(uint16_t code) {
+    static const unsigned long rates[] = {9600, 19200, 38400, 57600, 115200, 230400, 460800, 921600};
+    return code < sizeof(rates) / sizeof(rates[0]) ? rates[code] : 0;
+}
+
+void DMT_Emulator::setRecording(bool enable) {
+    _recording = enable;
+}
+
+void DMT_Emulator::setFrameCallback(void (*callback)(const DMTEmuFrame& frame)) {
+    _frameCallback = callback;
+}
+
+// Wire interface
+void DMT_Emulator::receive(const uint8_t* data, size_t length, uint64_t nowUs) {
+    _stats.bytesReceived += length;
+    _rxBuffer.insert(_rxBuffer.end(), data, data + length);
+
+    size_t pos = 0;
+    while (_rxBuffer.size() - pos >= 3) {
+        if (_rxBuffer[pos] != DMT_EMU_HEADER_1 || _rxBuffer[pos + 1] != DMT_EMU_HEADER_2) {
+            // Resynchronise on the next header
+            _stats.malformedFrames++;
+            pos++;
+            while (pos < _rxBuffer.size() && _rxBuffer[pos] != DMT_EMU_HEADER_1) pos++;
+            continue;
+        }
+        size_t frameLength = (size_t)_rxBuffer[pos + 2] + 3;
+        if (_rxBuffer.size() - pos < frameLength) break; // Wait for the rest of the frame
+
+        processFrame(&_rxBuffer[pos], frameLength, nowUs);
+        pos += frameLength;
+    }
+    _rxBuffer.erase(_rxBuffer.begin(), _rxBuffer.begin() + pos);
+}
+
+size_t DMT_Emulator::pollOutput(uint64_t nowUs, std::vector<uint8_t>& out) {
+    // Emit every scripted touch that is due, as the panel's auto-upload
+    sortScript();
+    while (_scriptPos < _script.size() && _script[_scriptPos].atUs <= nowUs) {
+        const DMTEmuTouch& touch = _script[_scriptPos++];
+        // The slider keeps its position in the high byte of the VP word
+        _vpMemory[touch.vpAddress] = (uint16_t)touch.value << 8;
+        const uint8_t upload[] = {
+            DMT_EMU_HEADER_1, DMT_EMU_HEADER_2, 0x06, DMT_EMU_CMD_READ_VP,
+            (uint8_t)(touch.vpAddress >> 8), (uint8_t)(touch.vpAddress & 0xFF),
+            0x01, touch.value, 0x00
+        };
+        queueFrame(upload, sizeof(upload), nowUs);
+        _stats.touchesSent++;
+    }
+
+    size_t n = _txPending.size();
+    out.insert(out.end(), _txPending.begin(), _txPending.end());
+    _txPending.clear();
+    return n;
+}
+
+uint64_t DMT_Emulator::nextEventUs() const {
+    sortScript();
+    return _scriptPos < _script.size() ? _script[_scriptPos].atUs : UINT64_MAX;
+}
+
+// Frame handling
+void DMT_Emulator::processFrame(const uint8_t* frame, size_t length, uint64_t nowUs) {
+    _stats.framesReceived++;
+    recordFrame(frame, length, false, nowUs);
+    if (length < 4) {
+        _stats.malformedFrames++;
+        return;
+    }
+
+    uint8_t command = frame[3];
+    switch (command) {
+        case DMT_EMU_CMD_WRITE_VP: { // 5A A5 LEN 82 VP_H VP_L DATA...
+            if (length < 7) {
+                _stats.malformedFrames++;
+                return;
+            }
+            uint16_t vp = (frame[4] << 8) | frame[5];
+            for (size_t i = 6; i < length; i += 2, vp++) {
+                if (i + 1 < length) {
+                    _vpMemory[vp] = (frame[i] << 8) | frame[i + 1];
+                } else {
+                    // Odd-length text: only the high byte of the last word changes
+                    _vpMemory[vp] = (frame[i] << 8) | (_vpMemory[vp] & 0x00FF);
+                }
+            }
+            _stats.vpWrites++;
+            if (_ackWrites) {
+                const uint8_t ack[] = {DMT_EMU_HEADER_1, DMT_EMU_HEADER_2, 0x03, DMT_EMU_CMD_WRITE_VP, 0x4F, 0x4B};
+                queueFrame(ack, sizeof(ack), nowUs);
+            }
+            break;
+        }
+
+        case DMT_EMU_CMD_READ_VP: { // 5A A5 04 83 VP_H VP_L N -> 5A A5 LEN 83 VP_H VP_L N DATA...
+            if (length < 7) {
+                _stats.malformedFrames++;
+                return;
+            }
+            uint16_t vp = (frame[4] << 8) | frame[5];
+            uint8_t words = frame[6];
+            std::vector<uint8_t> reply = {DMT_EMU_HEADER_1, DMT_EMU_HEADER_2, (uint8_t)(4 + 2 * words),
+                                          DMT_EMU_CMD_READ_VP, frame[4], frame[5], words};
+            for (uint8_t i = 0; i < words; i++) {
+                uint16_t value = _vpMemory[(uint16_t)(vp + i)];
+                reply.push_back(value >> 8);
+                reply.push_back(value & 0xFF);
+            }
+            queueFrame(reply.data(), reply.size(), nowUs);
+            _stats.vpReads++;
+            break;
+        }
+
+        case DMT_EMU_CMD_WRITE_REG: { // 5A A5 LEN 80 REG DATA...
+            if (length < 6) {
+                _stats.malformedFrames++;
+                return;
+            }
+            uint8_t reg = frame[4];
+            for (size_t i = 5; i < length; i++) {
+                _registers[(uint8_t)(reg + (i - 5))] = frame[i];
+            }
+            _stats.regWrites++;
+            // The new rate applies from the next byte on
+            if (!_baudFixed && reg <= DMT_EMU_REG_BAUD + 1 && reg + (length - 5) > DMT_EMU_REG_BAUD) {
+                unsigned long rate = baudFromCode((_registers[DMT_EMU_REG_BAUD] << 8) | _registers[DMT_EMU_REG_BAUD + 1]);
+                if (rate != 0 && rate != _baudRate) {
+                    _baudRate = rate;
+                    _stats.baudChanges++;
+                }
+            }
+            break;
+        }
+
+        case DMT_EMU_CMD_READ_REG: { // 5A A5 03 81 REG N -> 5A A5 LEN 81 REG N DATA...
+            if (length < 6) {
+                _stats.malformedFrames++;
+                return;
+            }
+            uint8_t reg = frame[4];
+            uint8_t count = frame[5];
+            std::vector<uint8_t> reply = {DMT_EMU_HEADER_1, DMT_EMU_HEADER_2, (uint8_t)(3 + count),
+                                          DMT_EMU_CMD_READ_REG, reg, count};
+            for (uint8_t i = 0; i < count; i++) {
+                reply.push_back(_registers[(uint8_t)(reg + i)]);
+            }
+            queueFrame(reply.data(), reply.size(), nowUs);
+            _stats.regReads++;
+            break;
+        }
+
+        default:
+            _stats.malformedFrames++;
+            break;
+    }
+}
+
+void DMT_Emulator::queueFrame(const uint8_t* frame, size_t length, uint64_t nowUs) {
+    _txPending.insert(_txPending.end(), frame, frame + length);
+    _stats.framesSent++;
+    _stats.bytesSent += length;
+    recordFrame(frame, length, true, nowUs);
+}
+
+void DMT_Emulator::recordFrame(const uint8_t* frame, size_t length, bool fromPanel, uint64_t nowUs) {
+    if (!_recording && !_frameCallback) return;
+    DMTEmuFrame entry = {nowUs, fromPanel, std::vector<uint8_t>(frame, frame + length)};
+    if (_frameCallback) _frameCallback(entry);
+    if (_recording) _log.push_back(entry);
+}
+
+// Touch script
+void DMT_Emulator::addTouch(uint64_t atUs, uint16_t vpAddress, uint8_t value) {
+    if (value > 100) value = 100;
+    _script.push_back({atUs, vpAddress, value});
+    _scriptSorted = false;
+}
+
+void DMT_Emulator::sortScript() const {
+    if (_scriptSorted) return;
+    // Only the pending part is reordered; stable so equal timestamps keep their order
+    std::stable_sort(_script.begin() + _scriptPos, _script.end(),
+                     [](const DMTEmuTouch& a, const DMTEmuTouch& b) { return a.atUs < b.atUs; });
+    _scriptSorted = true;
+}
+
+void DMT_Emulator::addDrag(uint64_t startUs, uint16_t vpAddress, uint8_t fromValue, uint8_t toValue,
+                           unsigned long durationMs, unsigned long rateHz) {
+    if (rateHz == 0) rateHz = 1;
+    unsigned long steps = durationMs * rateHz / 1000;
+    if (steps == 0) steps = 1;
+    for (unsigned long i = 0; i <= steps; i++) {
+        int value = fromValue + ((int)toValue - (int)fromValue) * (long)i / (long)steps;
+        addTouch(startUs + (uint64_t)i * 1000000ULL / rateHz, vpAddress, (uint8_t)value);
+    }
+}
+
+// Script format, one gesture per line ('#' starts a comment):
+//   <at_ms> touch <vp> <value>
+//   <at_ms> drag  <vp> <from> <to> <duration_ms> <rate_hz>
+bool DMT_Emulator::loadScript(const char* path, uint64_t offsetUs) {
+    FILE* f = fopen(path, "r");
+    if (f == nullptr) return false;
+
+    char line[256];
+    int lineNumber = 0;
+    bool ok = true;
+    while (fgets(line, sizeof(line), f)) {
+        lineNumber++;
+        char* comment = strchr(line, '#');
+        if (comment) *comment = '\0';
+
+        unsigned long atMs, a, b, duration, rate;
+        long vp;
+        char kind[16];
+        int fields = sscanf(line, "%lu %15s %li %lu %lu %lu %lu", &atMs, kind, &vp, &a, &b, &duration, &rate);
+        if (fields <= 0) continue; // Blank line
+
+        uint64_t atUs = offsetUs + (uint64_t)atMs * 1000ULL;
+        if (fields == 4 && strcmp(kind, "touch") == 0) {
+            addTouch(atUs, (uint16_t)vp, (uint8_t)a);
+        } else if (fields == 7 && strcmp(kind, "drag") == 0) {
+            addDrag(atUs, (uint16_t)vp, (uint8_t)a, (uint8_t)b, duration, rate);
+        } else {
+            fprintf(stderr, "%s:%d: cannot parse gesture\n", path, lineNumber);
+            ok = false;
+        }
+    }
+    fclose(f);
+    return ok;
+}
+
+// Panel state
+std::string DMT_Emulator::getText(uint16_t vpAddress, size_t maxChars) const {
+    std::string text;
+    for (size_t i = 0; i < maxChars; i++) {
+        uint16_t word = _vpMemory[(uint16_t)(vpAddress + i / 2)];
+        char c = (char)((i % 2 == 0) ? (word >> 8) : (word & 0xFF));
+        if (c == '\0') break;
+        text += c;
+    }
+    return text;
+}
+
+// Observation
+bool DMT_Emulator::writeLogCSV(const char* path) const {
+    FILE* f = fopen(path, "w");
+    if (f == nullptr) return false;
+    fprintf(f, "timestamp_us,direction,frame\n");
+    for (size_t i = 0; i < _log.size(); i++) {
+        fprintf(f, "%llu,%s,", (unsigned long long)_log[i].timestampUs, _log[i].fromPanel ? "panel" : "controller");
+        for (size_t j = 0; j < _log[i].bytes.size(); j++) {
+            fprintf(f, "%02X", _log[i].bytes[j]);
+        }
+        fprintf(f, "\n");
+    }
+    fclose(f);
+    return true;
+}
+
+void DMT_Emulator::resetStats() {
+    _stats = DMTEmuStats();
+}
+
+// ---------------------------------------------------------------------------
+// Pseudo-terminal front end
+// ---------------------------------------------------------------------------
+
+DMT_Emulator_Pty::DMT_Emulator_Pty(DMT_Emulator& emu)
+    : _emu(emu), _masterFd(-1), _slaveFd(-1) {
+}
+
+DMT_Emulator_Pty::~DMT_Emulator_Pty() {
+    close();
+}
+
+bool DMT_Emulator_Pty::open() {
+    char name[128];
+    if (openpty(&_masterFd, &_slaveFd, name, nullptr, nullptr) < 0) {
+        fprintf(stderr, "openpty failed: %s\n", strerror(errno));
+        return false;
+    }
+
+    // Raw 8-bit line: no echo, no newline translation
+    struct termios tio;
+    tcgetattr(_slaveFd, &tio);
+    cfmakeraw(&tio);
+    tcsetattr(_slaveFd, TCSANOW, &tio);
+    // Our slave descriptor stays open so the master never sees a hangup
+    // while the controller process is (re)starting.
+
+    fcntl(_masterFd, F_SETFL, fcntl(_masterFd, F_GETFL, 0) | O_NONBLOCK);
+    _slavePath = name;
+    return true;
+}
+
+void DMT_Emulator_Pty::close() {
+    if (_masterFd >= 0) {
+        ::close(_masterFd);
+        _masterFd = -1;
+    }
+    if (_slaveFd >= 0) {
+        ::close(_slaveFd);
+        _slaveFd = -1;
+    }
+}
+
+void DMT_Emulator_Pty::service(uint64_t nowUs, int waitMs) {
+    if (_masterFd < 0) return;
+
+    struct pollfd pfd = {_masterFd, POLLIN, 0};
+    if (poll(&pfd, 1, waitMs) > 0 && (pfd.revents & POLLIN)) {
+        uint8_t buf[512];
+        ssize_t n;
+        while ((n = read(_masterFd, buf, sizeof(buf))) > 0) {
+            _emu.receive(buf, (size_t)n, nowUs);
+        }
+    }
+
+    std::vector<uint8_t> out;
+    if (_emu.pollOutput(nowUs, out) > 0) {
+        size_t offset = 0;
+        while (offset < out.size()) {
+            ssize_t n = write(_masterFd, out.data() + offset, out.size() - offset);
+            if (n <= 0) {
+                if (errno == EAGAIN) {
+                    struct pollfd wfd = {_masterFd, POLLOUT, 0};
+                    poll(&wfd, 1, 10);
+                    continue;
+                }
+                break;
+            }
+            offset += n;
+        }
+    }
+}
@@ -0,0 +1,131 @@
+#ifndef DMT_EMULATOR_H
+#define DMT_EMULATOR_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string>
+#include <vector>
+
+// DGUS frame constants, same values as DMT_Display.h
+#define DMT_EMU_HEADER_1 0x5A
+#define DMT_EMU_HEADER_2 0xA5
+#define DMT_EMU_CMD_WRITE_REG 0x80
+#define DMT_EMU_CMD_READ_REG 0x81
+#define DMT_EMU_CMD_WRITE_VP 0x82
+#define DMT_EMU_CMD_READ_VP 0x83
+#define DMT_EMU_REG_BAUD 0x0C          // 16-bit rate code, index into the rate table
+#define DMT_EMU_DEFAULT_BAUD 115200
+
+// One frame on the wire, as seen by the panel
+struct DMTEmuFrame {
+    uint64_t timestampUs;
+    bool fromPanel;                // true: panel -> controller, false: controller -> panel
+    std::vector<uint8_t> bytes;
+};
+
+// Touch input queued for upload: value is the slider position (0-100)
+struct DMTEmuTouch {
+    uint64_t atUs;
+    uint16_t vpAddress;
+    uint8_t value;
+};
+
+struct DMTEmuStats {
+    unsigned long framesReceived;
+    unsigned long framesSent;
+    unsigned long bytesReceived;
+    unsigned long bytesSent;
+    unsigned long vpWrites;        // 0x82 frames applied
+    unsigned long vpReads;         // 0x83 requests answered
+    unsigned long regWrites;
+    unsigned long regReads;
+    unsigned long touchesSent;     // 0x83 auto-upload frames emitted
+    unsigned long malformedFrames;
+    unsigned long baudChanges;
+};
+
+// DGUS panel model: keeps VP and register memory, applies 0x82/0x80 writes,
+// answers 0x83/0x81 reads and emits scripted slider gestures as 0x83
+// auto-upload frames. Transport-agnostic; DMT_Emulator_Pty attaches it to a
+// pseudo-terminal, host harnesses can shuttle bytes in-process.
+class DMT_Emulator {
+private:
+    std::vector<uint16_t> _vpMemory;
+    uint8_t _registers[256];
+    std::vector<uint8_t> _rxBuffer;
+    std::vector<uint8_t> _txPending;
+    mutable std::vector<DMTEmuTouch> _script;   // Pending part sorted by atUs on demand
+    size_t _scriptPos;
+    mutable bool _scriptSorted;
+    std::vector<DMTEmuFrame> _log;
+    bool _recording;
+    bool _ackWrites;
+    unsigned long _baudRate;       // Rate the panel's UART runs at
+    bool _baudFixed;               // Ignores writes to the baud register
+    DMTEmuStats _stats;
+    void (*_frameCallback)(const DMTEmuFrame& frame);
+
+    void processFrame(const uint8_t* frame, size_t length, uint64_t nowUs);
+    void queueFrame(const uint8_t* frame, size_t length, uint64_t nowUs);
+    void recordFrame(const uint8_t* frame, size_t length, bool fromPanel, uint64_t nowUs);
+    void sortScript() const;
+
+public:
+    // Constructor
+    DMT_Emulator();
+
+    // Options
+    void setAckWrites(bool enable);            // DGUS2-style "OK" reply to 0x82 writes
+    void setRecording(bool enable);
+    void setFrameCallback(void (*callback)(const DMTEmuFrame& frame));
+    void setBaudFixed(bool fixed);             // Panel firmware without a writable rate
+
+    // UART rate; a controller at another rate gets nothing through (the transport drops the bytes)
+    unsigned long getBaudRate() const { return _baudRate; }
+    static unsigned long baudFromCode(uint16_t code);   // 0 for an unknown code
+
+    // Wire interface: bytes from the controller in, bytes for the controller out
+    void receive(const uint8_t* data, size_t length, uint64_t nowUs);
+    size_t pollOutput(uint64_t nowUs, std::vector<uint8_t>& out);
+    uint64_t nextEventUs() const;              // Time of the next scripted touch, or UINT64_MAX
+
+    // Touch script
+    void addTouch(uint64_t atUs, uint16_t vpAddress, uint8_t value);
+    void addDrag(uint64_t startUs, uint16_t vpAddress, uint8_t fromValue, uint8_t toValue,
+                 unsigned long durationMs, unsigned long rateHz);
+    bool loadScript(const char* path, uint64_t offsetUs = 0);
+    size_t scriptRemaining() const { return _script.size() - _scriptPos; }
+
+    // Panel state
+    uint16_t getVP(uint16_t vpAddress) const { return _vpMemory[vpAddress]; }
+    void setVP(uint16_t vpAddress, uint16_t value) { _vpMemory[vpAddress] = value; }
+    std::string getText(uint16_t vpAddress, size_t maxChars = 40) const;
+    uint8_t getRegister(uint8_t regAddress) const { return _registers[regAddress]; }
+
+    // Observation
+    const std::vector<DMTEmuFrame>& getLog() const { return _log; }
+    void clearLog() { _log.clear(); }
+    bool writeLogCSV(const char* path) const;
+    DMTEmuStats getStats() const { return _stats; }
+    void resetStats();
+};
+
+// Pseudo-terminal front end: the slave side looks like the panel's UART
+class DMT_Emulator_Pty {
+private:
+    DMT_Emulator& _emu;
+    int _masterFd;
+    int _slaveFd;
+    std::string _slavePath;
+
+public:
+    DMT_Emulator_Pty(DMT_Emulator& emu);
+    ~DMT_Emulator_Pty();
+
+    bool open();
+    void close();
+    const char* getSlavePath() const { return _slavePath.c_str(); }
+    void service(uint64_t nowUs, int waitMs);  // Move bytes both ways, waiting up to waitMs for input
+};
+
+#endif // DMT_EMULATOR_H
@@ -0,0 +1,144 @@
+#include "Event_Log.h"
+#include "Gain_Fixed.h"
+
+#ifdef ESP_PLATFORM
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+
+// Flush task: below the loop task (priority 1), so it only runs while loop() waits
+#define EVENT_LOG_TASK_PRIORITY tskIDLE_PRIORITY
+#define EVENT_LOG_TASK_STACK 3072
+#endif
+
+// Records formatted per poll() or per task wakeup
+#define EVENT_LOG_FLUSH_BATCH 8
+
+Event_Log eventLog;
+
+// Constructor
+Event_Log::Event_Log()
+    : _head(0), _tail(0), _dropped(0), _reportedDropped(0), _out(nullptr), _taskRunning(false),
+      _task(nullptr), _level(EVENT_LOG_LEVEL) {
+}
+
+const char* Event_Log::levelName(uint8_t level) {
+    switch (level) {
+        case EVENT_LOG_LEVEL_NONE: return "none";
+        case EVENT_LOG_LEVEL_ERROR: return "error";
+        case EVENT_LOG_LEVEL_WARN: return "warn";
+        case EVENT_LOG_LEVEL_INFO: return "info";
+        case EVENT_LOG_LEVEL_DEBUG: return "debug";
+        default: return "?";
+    }
+}
+
+void Event_Log::begin(Print& out) {
+    _out = &out;
+#ifdef ESP_PLATFORM
+    if (!_taskRunning) {
+        TaskHandle_t task = nullptr;
+        _taskRunning = xTaskCreate(taskMain, "event_log", EVENT_LOG_TASK_STACK, this,
+                                   EVENT_LOG_TASK_PRIORITY, &task) == pdPASS;
+        _task = task;
+    }
+#endif
+}
+
+uint32_t Event_Log::getTaskStackFree() const {
+#ifdef ESP_PLATFORM
+    if (_taskRunning) return uxTaskGetStackHighWaterMark((TaskHandle_t)_task);
+#endif
+    return 0;
+}
+
+void Event_Log::taskMain(void* param) {
+#ifdef ESP_PLATFORM
+    Event_Log* log = (Event_Log*)param;
+    for (;;) {
+        if (log->flush(*log->_out, EVENT_LOG_FLUSH_BATCH) == 0) vTaskDelay(pdMS_TO_TICKS(20));
+    }
+#else
+    (void)param;
+#endif
+}
+
+// Recording: drops the new record rather than waiting for the consumer
+void Event_Log::record(uint8_t level, EventLogId id, int32_t a, int32_t b) {
+    if (level > _level) return;
+    uint32_t tail = _tail.load(std::memory_order_relaxed);
+    if (tail - _head.load(std::memory_order_acquire) >= EVENT_LOG_BUFFER_RECORDS) {
+        // Only the producer writes the counter, so no read-modify-write atomics are needed
+        _dropped.store(_dropped.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+        return;
+    }
+    EventLogRecord& record = _ring[tail % EVENT_LOG_BUFFER_RECORDS];
+    record.timestampUs = micros();
+    record.id = (uint8_t)id;
+    record.level = level;
+    record.reserved = 0;
+    record.a = a;
+    record.b = b;
+    _tail.store(tail + 1, std::memory_order_release);
+}
+
+// Formatting
+size_t Event_Log::flush(Print& out, size_t maxRecords) {
+    uint32_t dropped = _dropped.load(std::memory_order_relaxed);
+    if (dropped != _reportedDropped) {
+        out.printf("⚠️  %lu log records dropped\n", (unsigned long)(dropped - _reportedDropped));
+        _reportedDropped = dropped;
+    }
+
+    size_t written = 0;
+    uint32_t head = _head.load(std::memory_order_relaxed);
+    while (written < maxRecords && head != _tail.load(std::memory_order_acquire)) {
+        EventLogRecord record = _ring[head % EVENT_LOG_BUFFER_RECORDS];
+        _head.store(++head, std::memory_order_release);
+        format(out, record);
+        written++;
+    }
+    return written;
+}
+
+size_t Event_Log::poll() {
+    if (_taskRunning || _out == nullptr) return 0;
+    return flush(*_out, EVENT_LOG_FLUSH_BATCH);
+}
+
+// Each printf stays below the 64-byte stack buffer of Print::printf
+void Event_Log::format(Print& out, const EventLogRecord& record) const {
+    out.printf("[%lu.%03lu] ", (unsigned long)(record.timestampUs / 1000000),
+               (unsigned long)(record.timestampUs / 1000 % 1000));
+    long a = record.a;
+    long b = record.b;
+
+    switch (record.id) {
+        case ELOG_VP_RECEIVED:
+            out.printf("🔊 VP: 0x%04lX = 0x%04lX (Vol: %ld)\n", a, b, b & 0xFF);
+            break;
+        case ELOG_VOLUME_SEND: {
+            char gainText[GAIN_TEXT_SIZE];
+            formatGain((FixedGain)b, gainText);
+            out.printf("🔊 Vol %d to zone %ld (Gain: %s)\n", volumeFromGain((FixedGain)b), a, gainText);
+            break;
+        }
+        case ELOG_HTTP_OK:
+            out.printf("✅ HTTP %ld\n", a);
+            break;
+        case ELOG_HTTP_OK_TIMED:
+            out.printf("✅ HTTP %ld (%ld ms)\n", a, b);
+            break;
+        case ELOG_HTTP_ERROR:
+            out.printf("❌ HTTP Error: %ld\n", a);
+            break;
+        case ELOG_GET_ERROR:
+            out.printf("❌ HTTP Error: %ld (readGainFromZone)\n", a);
+            break;
+        case ELOG_WIFI_NOT_CONNECTED:
+            out.println("⚠️  WiFi not connected, cannot send volume");
+            break;
+        default:
+            out.printf("log %u: %ld %ld\n", (unsigned)record.id, a, b);
+            break;
+    }
+}
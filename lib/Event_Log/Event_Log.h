@@ -0,0 +1,114 @@
+#ifndef EVENT_LOG_H
+#define EVENT_LOG_H
+
+#include <Arduino.h>
+#include <atomic>
+
+// Log levels; messages above EVENT_LOG_LEVEL compile out, arguments included
+#define EVENT_LOG_LEVEL_NONE 0
+#define EVENT_LOG_LEVEL_ERROR 1
+#define EVENT_LOG_LEVEL_WARN 2
+#define EVENT_LOG_LEVEL_INFO 3
+#define EVENT_LOG_LEVEL_DEBUG 4
+
+#ifndef EVENT_LOG_LEVEL
+#define EVENT_LOG_LEVEL EVENT_LOG_LEVEL_INFO
+#endif
+
+// Records kept until flushed (16 bytes each, power of two); newer ones are dropped when full
+#ifndef EVENT_LOG_BUFFER_RECORDS
+#define EVENT_LOG_BUFFER_RECORDS 128
+#endif
+
+// Hot-path messages, formatted only when flushed
+enum EventLogId {
+    ELOG_VP_RECEIVED = 0,          // a: VP address, b: VP data
+    ELOG_VOLUME_SEND,              // a: zone number, b: FixedGain
+    ELOG_HTTP_OK,                  // a: status
+    ELOG_HTTP_OK_TIMED,            // a: status, b: ms
+    ELOG_HTTP_ERROR,               // a: status
+    ELOG_GET_ERROR,                // a: status
+    ELOG_WIFI_NOT_CONNECTED,
+    ELOG_ID_COUNT
+};
+
+struct EventLogRecord {
+    uint32_t timestampUs;
+    uint8_t id;
+    uint8_t level;
+    uint16_t reserved;
+    int32_t a;
+    int32_t b;
+};
+
+// Binary log ring: record() copies 16 bytes and never blocks or formats;
+// flush() turns records into text lines. Single producer (loop) and single
+// consumer. On the ESP32 begin() starts a task below the loop task's
+// priority that flushes whenever loop() blocks; elsewhere loop() calls poll().
+class Event_Log {
+private:
+    EventLogRecord _ring[EVENT_LOG_BUFFER_RECORDS];
+    std::atomic<uint32_t> _head;   // Next record to flush
+    std::atomic<uint32_t> _tail;   // Next record to write
+    std::atomic<uint32_t> _dropped;
+    uint32_t _reportedDropped;
+    Print* _out;
+    bool _taskRunning;
+    void* _task;                   // TaskHandle_t of the flush task
+    uint8_t _level;                // Runtime threshold, at most EVENT_LOG_LEVEL
+
+    void format(Print& out, const EventLogRecord& record) const;
+    static void taskMain(void* param);
+
+public:
+    // Constructor
+    Event_Log();
+
+    // Start flushing to out (a background task where there is one)
+    void begin(Print& out);
+
+    // Runtime threshold; levels above EVENT_LOG_LEVEL are compiled out and stay off
+    void setLevel(uint8_t level) { _level = level > EVENT_LOG_LEVEL ? EVENT_LOG_LEVEL : level; }
+    uint8_t getLevel() const { return _level; }
+    static const char* levelName(uint8_t level);
+
+    // Recording (use the ELOG_* macros so disabled levels compile out)
+    void record(uint8_t level, EventLogId id, int32_t a = 0, int32_t b = 0);
+
+    // Formatting; both return the number of records written
+    size_t flush(Print& out, size_t maxRecords);
+    size_t poll();                 // Flush a few records unless a task does it
+
+    // Access
+    size_t getPending() const { return _tail.load() - _head.load(); }
+    uint32_t getDropped() const { return _dropped.load(); }
+    uint32_t getTaskStackFree() const;   // Flush task's stack high-water mark, 0 without a task
+};
+
+extern Event_Log eventLog;
+
+#if EVENT_LOG_LEVEL >= EVENT_LOG_LEVEL_ERROR
+#define ELOG_ERROR(id, ...) eventLog.record(EVENT_LOG_LEVEL_ERROR, id, ##__VA_ARGS__)
+#else
+#define ELOG_ERROR(id, ...) ((void)0)
+#endif
+
+#if EVENT_LOG_LEVEL >= EVENT_LOG_LEVEL_WARN
+#define ELOG_WARN(id, ...) eventLog.record(EVENT_LOG_LEVEL_WARN, id, ##__VA_ARGS__)
+#else
+#define ELOG_WARN(id, ...) ((void)0)
+#endif
+
+#if EVENT_LOG_LEVEL >= EVENT_LOG_LEVEL_INFO
+#define ELOG_INFO(id, ...) eventLog.record(EVENT_LOG_LEVEL_INFO, id, ##__VA_ARGS__)
+#else
+#define ELOG_INFO(id, ...) ((void)0)
+#endif
+
+#if EVENT_LOG_LEVEL >= EVENT_LOG_LEVEL_DEBUG
+#define ELOG_DEBUG(id, ...) eventLog.record(EVENT_LOG_LEVEL_DEBUG, id, ##__VA_ARGS__)
+#else
+#define ELOG_DEBUG(id, ...) ((void)0)
+#endif
+
+#endif // EVENT_LOG_H
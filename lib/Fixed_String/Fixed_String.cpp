@@ -0,0 +1,15 @@
+#include "Fixed_String.h"
+
+size_t fixedStringAppendf(char* buffer, size_t size, size_t length, bool* truncated,
+                          const char* format, va_list args) {
+    int written = vsnprintf(buffer + length, size - length, format, args);
+    if (written < 0) {
+        buffer[length] = '\0';
+        return length;
+    }
+    if ((size_t)written >= size - length) {
+        *truncated = true;
+        return size - 1;
+    }
+    return length + written;
+}
@@ -0,0 +1,61 @@
+#ifndef FIXED_STRING_H
+#define FIXED_STRING_H
+
+#include <Arduino.h>
+#include <stdarg.h>
+
+// Formats into buffer[length..size), always terminated; returns the new length.
+// Output that does not fit is cut and *truncated set.
+size_t fixedStringAppendf(char* buffer, size_t size, size_t length, bool* truncated,
+                          const char* format, va_list args);
+
+// Text of at most SIZE - 1 characters held inline, for status messages built
+// on timers: nothing touches the heap, and text that does not fit is cut
+// (isTruncated()) instead of growing the buffer
+template <size_t SIZE>
+class Fixed_String {
+private:
+    char _buffer[SIZE];
+    size_t _length;
+    bool _truncated;
+
+public:
+    Fixed_String() { clear(); }
+
+    void clear() {
+        _buffer[0] = '\0';
+        _length = 0;
+        _truncated = false;
+    }
+
+    Fixed_String& append(const char* text) {
+        while (*text != '\0' && _length < SIZE - 1) _buffer[_length++] = *text++;
+        if (*text != '\0') _truncated = true;
+        _buffer[_length] = '\0';
+        return *this;
+    }
+
+    Fixed_String& append(char c, size_t count = 1) {
+        for (; count > 0 && _length < SIZE - 1; count--) _buffer[_length++] = c;
+        if (count > 0) _truncated = true;
+        _buffer[_length] = '\0';
+        return *this;
+    }
+
+    // printf-style append through vsnprintf on the buffer itself
+    __attribute__((format(printf, 2, 3))) Fixed_String& appendf(const char* format, ...) {
+        va_list args;
+        va_start(args, format);
+        _length = fixedStringAppendf(_buffer, SIZE, _length, &_truncated, format, args);
+        va_end(args);
+        return *this;
+    }
+
+    // Access
+    const char* c_str() const { return _buffer; }
+    size_t length() const { return _length; }
+    static size_t capacity() { return SIZE - 1; }
+    bool isTruncated() const { return _truncated; }
+};
+
+#endif // FIXED_STRING_H
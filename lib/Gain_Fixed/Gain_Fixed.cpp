@@ -0,0 +1,127 @@
+#include "Gain_Fixed.h"
+
+// 1000 * 2^(v/10) for v = 0..100, rounded; the ends are overridden by
+// gainFromVolume() but still bound the rounding of volumes 0 and 99
+static const uint32_t gainCurve[GAIN_MAX_VOLUME + 1] = {
+       1000,    1072,    1149,    1231,    1320,    1414,    1516,    1625,
+       1741,    1866,    2000,    2144,    2297,    2462,    2639,    2828,
+       3031,    3249,    3482,    3732,    4000,    4287,    4595,    4925,
+       5278,    5657,    6063,    6498,    6964,    7464,    8000,    8574,
+       9190,    9849,   10556,   11314,   12126,   12996,   13929,   14929,
+      16000,   17148,   18379,   19698,   21112,   22627,   24251,   25992,
+      27858,   29857,   32000,   34297,   36758,   39397,   42224,   45255,
+      48503,   51984,   55715,   59714,   64000,   68594,   73517,   78793,
+      84449,   90510,   97006,  103968,  111430,  119428,  128000,  137187,
+     147033,  157586,  168897,  181019,  194012,  207937,  222861,  238856,
+     256000,  274374,  294067,  315173,  337794,  362039,  388023,  415873,
+     445722,  477713,  512000,  548748,  588134,  630346,  675588,  724077,
+     776047,  831746,  891444,  955426, 1024000
+};
+
+#define GAIN_MAX_DIGITS 100000000000000ULL   // Mantissa digits kept while parsing (15)
+
+FixedGain gainFromVolume(int volume) {
+    if (volume <= 0) return 0;
+    if (volume >= GAIN_MAX_VOLUME) return GAIN_UNITY;
+    return gainCurve[volume];
+}
+
+// Volume v covers the gains between the geometric means of its neighbours on
+// the curve, so comparing squares finds the log-domain rounding without log2
+int volumeFromGain(FixedGain gain) {
+    if (gain == 0) return 0;
+    if (gain >= GAIN_UNITY) return GAIN_MAX_VOLUME;
+    uint64_t square = (uint64_t)gain * gain;
+    int low = 0;
+    int high = GAIN_MAX_VOLUME;
+    while (low < high) {
+        int mid = (low + high) / 2;
+        if (square >= (uint64_t)gainCurve[mid] * gainCurve[mid + 1]) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return low;
+}
+
+size_t formatGain(FixedGain gain, char* out) {
+    if (gain >= GAIN_UNITY || gain == 0) {
+        out[0] = gain == 0 ? '0' : '1';
+        out[1] = '\0';
+        return 1;
+    }
+    size_t len = 0;
+    out[len++] = '0';
+    out[len++] = '.';
+    for (uint32_t digit = GAIN_UNITY / 10; gain > 0; digit /= 10) {
+        out[len++] = (char)('0' + gain / digit);
+        gain %= digit;
+    }
+    out[len] = '\0';
+    return len;
+}
+
+// Mantissa and decimal exponent are collected as integers, then scaled to
+// millionths with one rounded division
+const char* parseGain(const char* text, FixedGain& gain) {
+    const char* p = text;
+    bool negative = *p == '-';
+    if (negative) p++;
+    if (*p < '0' || *p > '9') return nullptr;
+
+    uint64_t mantissa = 0;
+    int exponent = 0;
+    for (; *p >= '0' && *p <= '9'; p++) {
+        if (mantissa < GAIN_MAX_DIGITS) {
+            mantissa = mantissa * 10 + (*p - '0');
+        } else {
+            exponent++;
+        }
+    }
+    if (*p == '.') {
+        p++;
+        if (*p < '0' || *p > '9') return nullptr;
+        for (; *p >= '0' && *p <= '9'; p++) {
+            if (mantissa < GAIN_MAX_DIGITS) {
+                mantissa = mantissa * 10 + (*p - '0');
+                exponent--;
+            }
+        }
+    }
+    if (*p == 'e' || *p == 'E') {
+        p++;
+        bool negativeExponent = *p == '-';
+        if (*p == '-' || *p == '+') p++;
+        if (*p < '0' || *p > '9') return nullptr;
+        int value = 0;
+        for (; *p >= '0' && *p <= '9'; p++) {
+            if (value < 1000) value = value * 10 + (*p - '0');
+        }
+        exponent += negativeExponent ? -value : value;
+    }
+
+    // Millionths = mantissa * 10^(exponent + 6)
+    int scale = exponent + 6;
+    if (negative || mantissa == 0 || scale < -19) {
+        gain = 0;
+    } else if (scale > 6) {
+        gain = GAIN_UNITY;
+    } else if (scale >= 0) {
+        uint64_t value = mantissa;
+        for (int i = 0; i < scale && value <= GAIN_UNITY; i++) value *= 10;
+        gain = value > GAIN_UNITY ? GAIN_UNITY : (FixedGain)value;
+    } else {
+        uint64_t divisor = 1;
+        for (int i = 0; i < -scale; i++) divisor *= 10;
+        uint64_t value = (mantissa + divisor / 2) / divisor;
+        gain = value > GAIN_UNITY ? GAIN_UNITY : (FixedGain)value;
+    }
+    return p;
+}
+
+FixedGain gainFromFloat(float gain) {
+    if (!(gain > 0.0f)) return 0;
+    if (gain >= 1.0f) return GAIN_UNITY;
+    return (FixedGain)(gain * (float)GAIN_UNITY + 0.5f);
+}
@@ -0,0 +1,34 @@
+#ifndef GAIN_FIXED_H
+#define GAIN_FIXED_H
+
+#include <Arduino.h>
+
+// Zone gain in millionths: 0 is off, GAIN_UNITY is the Mezzo's 1.0. Carried as
+// an integer from the panel's volume byte to the PUT body and back from the GET
+// response, so the touch path does no float arithmetic on the soft-float core.
+typedef uint32_t FixedGain;
+
+#define GAIN_UNITY 1000000UL
+#define GAIN_MAX_VOLUME 100
+#define GAIN_TEXT_SIZE 9           // "0.000001" and the terminator
+
+// Panel volume 0-100 to gain on the curve (2^(volume/10))/1000; volume 0 is
+// off and 100 is unity
+FixedGain gainFromVolume(int volume);
+
+// Nearest volume on the same curve, rounded in the log domain like
+// round(10 * log2(gain * 1000))
+int volumeFromGain(FixedGain gain);
+
+// Decimal text without trailing zeros ("0", "0.128", "1"); out holds
+// GAIN_TEXT_SIZE bytes. Returns the length.
+size_t formatGain(FixedGain gain, char* out);
+
+// JSON number to the nearest millionth, clamped to 0..GAIN_UNITY. Returns the
+// character after the number, nullptr if text does not start with one.
+const char* parseGain(const char* text, FixedGain& gain);
+
+// Gains that arrive as float (REST body, OSC argument)
+FixedGain gainFromFloat(float gain);
+
+#endif // GAIN_FIXED_H
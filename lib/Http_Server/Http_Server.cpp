@@ -0,0 +1,194 @@
+#include "Http_Server.h"
+#include "Perf_Metrics.h"
+#include "Alloc_Trace.h"
+
+// Response
+Http_Response::Http_Response() : _client(nullptr), _length(0), _started(false) {
+}
+
+void Http_Response::attach(WiFiClient* client) {
+    _client = client;
+    _length = 0;
+    _started = false;
+}
+
+void Http_Response::begin(int status, const char* contentType) {
+    _started = true;
+    printf("HTTP/1.0 %d %s\r\n", status, Http_Server::statusText(status));
+    printf("Content-Type: %s\r\n", contentType);
+    print("Connection: close\r\n\r\n");
+}
+
+void Http_Response::end() {
+    sendBuffer();
+}
+
+void Http_Response::sendBuffer() {
+    if (_length > 0 && _client != nullptr) _client->write(_buffer, _length);
+    _length = 0;
+}
+
+size_t Http_Response::write(uint8_t c) {
+    if (_length == HTTP_SERVER_OUT_BUFFER) sendBuffer();
+    _buffer[_length++] = c;
+    return 1;
+}
+
+size_t Http_Response::write(const uint8_t* buffer, size_t size) {
+    size_t left = size;
+    while (left > 0) {
+        if (_length == HTTP_SERVER_OUT_BUFFER) sendBuffer();
+        size_t chunk = HTTP_SERVER_OUT_BUFFER - _length;
+        if (chunk > left) chunk = left;
+        memcpy(_buffer + _length, buffer, chunk);
+        _length += chunk;
+        buffer += chunk;
+        left -= chunk;
+    }
+    return size;
+}
+
+// Constructor
+Http_Server::Http_Server(uint16_t port)
+    : _server(port), _numRoutes(0), _length(0), _startMs(0), _active(false),
+      _served(0), _rejected(0) {
+}
+
+// Configuration
+bool Http_Server::on(const char* method, const char* path, HttpHandler handler) {
+    if (_numRoutes == HTTP_SERVER_MAX_ROUTES) return false;
+    _routes[_numRoutes++] = {method, path, handler};
+    return true;
+}
+
+void Http_Server::begin() {
+    _server.begin();
+    _server.setNoDelay(true);
+}
+
+// Takes whatever bytes have arrived; dispatches once the request is complete
+void Http_Server::handleClient() {
+    if (!_active) {
+        _client = _server.available();
+        if (!_client) return;
+        _active = true;
+        _length = 0;
+        _request[0] = '\0';
+        _startMs = millis();
+    }
+
+    int pending = _client.available();
+    if (pending > 0) {
+        size_t room = HTTP_SERVER_REQUEST_SIZE - 1 - _length;
+        int got = _client.read((uint8_t*)_request + _length, (size_t)pending < room ? pending : room);
+        if (got > 0) _length += got;
+        _request[_length] = '\0';
+    }
+
+    HttpRequest request;
+    int status = parse(request);
+    if (status == 0 && _length == HTTP_SERVER_REQUEST_SIZE - 1) status = 413;
+    if (status == 200) {
+        PerfScope scope(PERF_HIST_HTTP_SERVE);
+        AllocRegionScope region(ALLOC_REGION_HTTP_SERVE);
+        dispatch(request);
+    } else if (status != 0) {
+        reply(status, status == 413 ? "Request too large" : "Bad request");
+    } else if (!_client.connected() || millis() - _startMs > HTTP_SERVER_TIMEOUT_MS) {
+        _rejected++;
+        close();
+    }
+}
+
+// Splits the buffer in place once the request is complete: 0 while more is
+// expected, 200 once parsed, else the error status to reply with
+int Http_Server::parse(HttpRequest& request) {
+    char* headerEnd = strstr(_request, "\r\n\r\n");
+    if (headerEnd == nullptr) return 0;
+
+    // Content-Length, if any, decides whether the body is all there
+    size_t contentLength = 0;
+    for (char* line = strstr(_request, "\r\n"); line != nullptr && line < headerEnd;
+         line = strstr(line + 2, "\r\n")) {
+        if (strncasecmp(line + 2, "Content-Length:", 15) == 0) {
+            contentLength = strtoul(line + 17, nullptr, 10);
+        }
+    }
+    char* body = headerEnd + 4;
+    if (contentLength > HTTP_SERVER_REQUEST_SIZE - 1 - (size_t)(body - _request)) return 413;
+    if ((size_t)(_request + _length - body) < contentLength) return 0;
+
+    // "METHOD SP target SP version"
+    char* space = strchr(_request, ' ');
+    if (space == nullptr || space > headerEnd) return 400;
+    *space = '\0';
+    char* target = space + 1;
+    space = strchr(target, ' ');
+    if (space == nullptr || space > headerEnd) return 400;
+    *space = '\0';
+
+    char* query = strchr(target, '?');
+    if (query != nullptr) *query++ = '\0';
+    body[contentLength] = '\0';
+
+    request.method = _request;
+    request.path = target;
+    request.query = query != nullptr ? query : "";
+    request.body = body;
+    request.bodyLength = contentLength;
+    return 200;
+}
+
+void Http_Server::dispatch(const HttpRequest& request) {
+    bool pathFound = false;
+    for (int i = 0; i < _numRoutes; i++) {
+        if (!matches(_routes[i].path, request.path)) continue;
+        pathFound = true;
+        if (strcmp(_routes[i].method, request.method) != 0) continue;
+
+        _response.attach(&_client);
+        _routes[i].handler(request, _response);
+        if (!_response.isStarted()) _response.begin(204);
+        _response.end();
+        _served++;
+        close();
+        return;
+    }
+    reply(pathFound ? 405 : 404, pathFound ? "Method not allowed" : "Not found");
+}
+
+// Exact path, or any path starting with the part before a trailing '*'
+bool Http_Server::matches(const char* pattern, const char* path) {
+    size_t length = strlen(pattern);
+    if (length > 0 && pattern[length - 1] == '*') return strncmp(pattern, path, length - 1) == 0;
+    return strcmp(pattern, path) == 0;
+}
+
+void Http_Server::reply(int status, const char* message) {
+    _response.attach(&_client);
+    _response.begin(status);
+    _response.println(message);
+    _response.end();
+    _rejected++;
+    close();
+}
+
+void Http_Server::close() {
+    _client.stop();
+    _active = false;
+    _length = 0;
+}
+
+const char* Http_Server::statusText(int status) {
+    switch (status) {
+        case 200: return "OK";
+        case 202: return "Accepted";
+        case 204: return "No Content";
+        case 400: return "Bad Request";
+        case 404: return "Not Found";
+        case 405: return "Method Not Allowed";
+        case 413: return "Payload Too Large";
+        case 503: return "Service Unavailable";
+        default: return "";
+    }
+}
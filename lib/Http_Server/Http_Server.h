@@ -0,0 +1,102 @@
+#ifndef HTTP_SERVER_H
+#define HTTP_SERVER_H
+
+#include <Arduino.h>
+#include <WiFi.h>
+
+// Request line, headers and body must fit; larger requests get 413
+#ifndef HTTP_SERVER_REQUEST_SIZE
+#define HTTP_SERVER_REQUEST_SIZE 768
+#endif
+
+// Response bytes gathered before each write to the socket
+#ifndef HTTP_SERVER_OUT_BUFFER
+#define HTTP_SERVER_OUT_BUFFER 512
+#endif
+
+#define HTTP_SERVER_MAX_ROUTES 8
+#define HTTP_SERVER_TIMEOUT_MS 1000   // A request not complete by then is dropped
+
+// Parsed request; every pointer points into the server's request buffer
+struct HttpRequest {
+    const char* method;
+    const char* path;
+    const char* query;          // After '?', "" when absent
+    const char* body;
+    size_t bodyLength;
+};
+
+// Response streamed to the client through a fixed buffer: begin() writes the
+// status line and headers, print() the body. HTTP/1.0, closed after the body.
+class Http_Response : public Print {
+private:
+    WiFiClient* _client;
+    uint8_t _buffer[HTTP_SERVER_OUT_BUFFER];
+    size_t _length;
+    bool _started;
+
+    void sendBuffer();
+
+public:
+    Http_Response();
+
+    void attach(WiFiClient* client);
+    void begin(int status, const char* contentType = "text/plain; charset=utf-8");
+    void end();
+    bool isStarted() const { return _started; }
+
+    // Print interface
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t* buffer, size_t size) override;
+    using Print::write;
+};
+
+typedef void (*HttpHandler)(const HttpRequest& request, Http_Response& response);
+
+// Minimal HTTP server for loop(): one connection at a time, read as bytes
+// arrive so handleClient() never waits on the network, handlers dispatched by
+// method and path (a trailing '*' matches any rest). No heap use of its own.
+class Http_Server {
+private:
+    struct Route {
+        const char* method;
+        const char* path;
+        HttpHandler handler;
+    };
+
+    WiFiServer _server;
+    WiFiClient _client;
+    Http_Response _response;
+    Route _routes[HTTP_SERVER_MAX_ROUTES];
+    int _numRoutes;
+    char _request[HTTP_SERVER_REQUEST_SIZE];
+    size_t _length;
+    unsigned long _startMs;
+    bool _active;
+    uint32_t _served;
+    uint32_t _rejected;         // Malformed, oversized, timed out or unrouted
+
+    int parse(HttpRequest& request);
+    void dispatch(const HttpRequest& request);
+    static bool matches(const char* pattern, const char* path);
+    void reply(int status, const char* message);
+    void close();
+
+public:
+    // Constructor
+    Http_Server(uint16_t port = 80);
+
+    // Configuration
+    bool on(const char* method, const char* path, HttpHandler handler);
+    void begin();
+
+    // Call from loop()
+    void handleClient();
+
+    // Access
+    uint32_t getServed() const { return _served; }
+    uint32_t getRejected() const { return _rejected; }
+    static const char* statusText(int status);
+};
+
+#endif // HTTP_SERVER_H
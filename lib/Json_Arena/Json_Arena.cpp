@@ -0,0 +1,78 @@
+#include "Json_Arena.h"
+#include "Perf_Metrics.h"
+
+// Each block is preceded by its size, padded to keep blocks aligned
+struct JsonArenaHeader {
+    size_t size;
+};
+
+#define JSON_ARENA_HEADER_SIZE \
+    ((sizeof(JsonArenaHeader) + JSON_ARENA_ALIGN - 1) / JSON_ARENA_ALIGN * JSON_ARENA_ALIGN)
+
+static size_t alignedSize(size_t size) {
+    return (size + JSON_ARENA_ALIGN - 1) / JSON_ARENA_ALIGN * JSON_ARENA_ALIGN;
+}
+
+// Constructor
+Json_Arena::Json_Arena() : _used(0), _newest(0), _peak(0), _blocks(0), _failures(0) {
+}
+
+// ArduinoJson::Allocator
+void* Json_Arena::allocate(size_t size) {
+    if (size > JSON_ARENA_SIZE || alignedSize(size) + JSON_ARENA_HEADER_SIZE > JSON_ARENA_SIZE - _used) {
+        _failures++;
+        perfMetrics.increment(PERF_COUNT_JSON_ARENA_FAILURES);
+        return nullptr;
+    }
+    JsonArenaHeader* header = (JsonArenaHeader*)(_buffer + _used);
+    header->size = size;
+    _newest = _used;
+    _used += JSON_ARENA_HEADER_SIZE + alignedSize(size);
+    if (_used > _peak) _peak = _used;
+    _blocks++;
+    return _buffer + _newest + JSON_ARENA_HEADER_SIZE;
+}
+
+// Space is only given back for the newest block, or all at once with the last one
+void Json_Arena::deallocate(void* ptr) {
+    if (ptr == nullptr) return;
+    if (--_blocks <= 0) {
+        reset();
+        return;
+    }
+    if ((uint8_t*)ptr == _buffer + _newest + JSON_ARENA_HEADER_SIZE) {
+        _used = _newest;
+    }
+}
+
+void* Json_Arena::reallocate(void* ptr, size_t newSize) {
+    if (ptr == nullptr) return allocate(newSize);
+    JsonArenaHeader* header = (JsonArenaHeader*)((uint8_t*)ptr - JSON_ARENA_HEADER_SIZE);
+
+    // The newest block resizes where it is
+    if ((uint8_t*)header == _buffer + _newest) {
+        if (newSize <= JSON_ARENA_SIZE && alignedSize(newSize) <= JSON_ARENA_SIZE - _newest - JSON_ARENA_HEADER_SIZE) {
+            header->size = newSize;
+            _used = _newest + JSON_ARENA_HEADER_SIZE + alignedSize(newSize);
+            if (_used > _peak) _peak = _used;
+            return ptr;
+        }
+        _failures++;
+        perfMetrics.increment(PERF_COUNT_JSON_ARENA_FAILURES);
+        return nullptr;
+    }
+
+    size_t oldSize = header->size;
+    void* moved = allocate(newSize);
+    if (moved == nullptr) return nullptr;
+    memcpy(moved, ptr, oldSize < newSize ? oldSize : newSize);
+    _blocks--;   // The old block is abandoned; its space returns with reset()
+    return moved;
+}
+
+// Control
+void Json_Arena::reset() {
+    _used = 0;
+    _newest = 0;
+    _blocks = 0;
+}
@@ -0,0 +1,59 @@
+#ifndef JSON_ARENA_H
+#define JSON_ARENA_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+
+// Bytes for the documents of one request; a document that needs more fails
+// with NoMemory instead of reaching the heap
+#ifndef JSON_ARENA_SIZE
+#define JSON_ARENA_SIZE 4096
+#endif
+
+#define JSON_ARENA_ALIGN 8
+
+// ArduinoJson allocator over a fixed, preallocated buffer. Blocks are bumped
+// off the front; only the newest one shrinks, grows or is freed in place, and
+// the arena empties itself when its last block is freed. reset() empties it
+// unconditionally once a request's documents are gone. Failed allocations
+// are counted in perfMetrics (json_arena_failures).
+class Json_Arena : public ArduinoJson::Allocator {
+private:
+    alignas(JSON_ARENA_ALIGN) uint8_t _buffer[JSON_ARENA_SIZE];
+    size_t _used;
+    size_t _newest;                // Offset of the newest block's header
+    size_t _peak;
+    int _blocks;                   // Allocated and not yet freed
+    uint32_t _failures;
+
+public:
+    // Constructor
+    Json_Arena();
+
+    // ArduinoJson::Allocator
+    void* allocate(size_t size) override;
+    void deallocate(void* ptr) override;
+    void* reallocate(void* ptr, size_t newSize) override;
+
+    // Control
+    void reset();
+
+    // Access
+    size_t getUsed() const { return _used; }
+    size_t getPeak() const { return _peak; }
+    uint32_t getFailures() const { return _failures; }
+    static size_t getSize() { return JSON_ARENA_SIZE; }
+};
+
+// Resets the arena when the enclosing scope ends; declare it before the
+// documents so they are destroyed first
+class JsonArenaScope {
+private:
+    Json_Arena& _arena;
+
+public:
+    explicit JsonArenaScope(Json_Arena& arena) : _arena(arena) {}
+    ~JsonArenaScope() { _arena.reset(); }
+};
+
+#endif // JSON_ARENA_H
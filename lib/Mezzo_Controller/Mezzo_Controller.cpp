@@ -1,10 +1,11 @@
 #include "Mezzo_Controller.h"
-#include <cmath>
+#include "Alloc_Trace.h"
 
 // Constructor
 Mezzo_Controller::Mezzo_Controller(const char* mezzoIP, int mezzoPort)
     : _mezzoIP(mezzoIP), _mezzoPort(mezzoPort), _zones(nullptr), _numZones(0),
-      _httpTimeout(2000), _wifiFailureCallback(nullptr) {
+      _httpTimeout(2000), _pendingWrites(0), _nextWrite(0), _wifiFailureCallback(nullptr),
+      _zoneGainCallback(nullptr) {
 }
 
 // Configuration
@@ -21,10 +22,14 @@ void Mezzo_Controller::setWiFiFailureCallback(void (*callback)()) {
     _wifiFailureCallback = callback;
 }
 
+void Mezzo_Controller::setZoneGainCallback(void (*callback)(int zoneIdx, FixedGain gain)) {
+    _zoneGainCallback = callback;
+}
+
 // Zone control
 bool Mezzo_Controller::sendVolumeToZone(uint16_t vpAddress, int volume) {
     if (WiFi.status() != WL_CONNECTED) {
-        Serial.println("⚠️  WiFi not connected, cannot send volume");
+        ELOG_WARN(ELOG_WIFI_NOT_CONNECTED);
         return false;
     }
     
@@ -32,13 +37,13 @@ bool Mezzo_Controller::sendVolumeToZone(uint16_t vpAddress, int volume) {
     if (zoneIdx == -1) return false;
     
     // Convert volume to gain using the mapping
-    uint16_t vpData = map(volume, 0, 100, 0x100, 0x164); // VP_MIN_VALUE to VP_MAX_VALUE
-    float gain = calculateGainFromVPData(vpData);
+    FixedGain gain = gainFromVolume(volume);
     
+    WiFiClient client;
     HTTPClient http;
     String url = "http://" + _mezzoIP + "/iv/views/web/730665316/zone-controls/" + String(_zones[zoneIdx].zoneNumber);
     
-    http.begin(url);
+    http.begin(client, url);
     http.addHeader("Content-Type", "application/json");
     http.addHeader("Installation-Client-Id", "0add066f-0458-4a61-9f57-c3a82fbb63f9");
     http.addHeader("Origin", "http://" + _mezzoIP);
@@ -46,25 +51,30 @@ bool Mezzo_Controller::sendVolumeToZone(uint16_t vpAddress, int volume) {
     http.setTimeout(_httpTimeout);
     
     // Build JSON payload
-    JsonDocument doc;
-    JsonArray zonesArr = doc["Zones"].to<JsonArray>();
-    JsonObject zoneObj = zonesArr.add<JsonObject>();
-    zoneObj["Id"] = _zones[zoneIdx].zoneId;
-    zoneObj["Gain"] = gain;
-    
     String jsonString;
-    serializeJson(doc, jsonString);
+    {
+        PerfScope scope(PERF_HIST_PUT_BUILD);
+        PerfTraceScope trace(PERF_TRACE_JSON_BUILD, _zones[zoneIdx].zoneNumber);
+        buildGainPayload(zoneIdx, gain, jsonString);
+    }
     
-    unsigned long startTime = millis();
-    int httpResponseCode = http.PUT(jsonString);
-    unsigned long responseTime = millis() - startTime;
+    uint32_t startUs = micros();
+    int httpResponseCode = HTTPC_ERROR_CONNECTION_REFUSED;
+    if (connectClient(client, PERF_HIST_PUT_CONNECT)) {
+        PerfScope scope(PERF_HIST_PUT_REQUEST);
+        PerfTraceScope trace(PERF_TRACE_HTTP_PUT, _zones[zoneIdx].zoneNumber);
+        httpResponseCode = http.PUT(jsonString);
+    }
+    uint32_t elapsedUs = micros() - startUs;
+    countResult(httpResponseCode, true);
+    noteZoneResult(zoneIdx, httpResponseCode, gain, elapsedUs);
     
     bool success = false;
     if (httpResponseCode > 0) {
-        Serial.printf("✅ HTTP %d (%.0f ms)\n", httpResponseCode, responseTime);
+        ELOG_DEBUG(ELOG_HTTP_OK_TIMED, httpResponseCode, (int32_t)(elapsedUs / 1000));
         success = true;
     } else {
-        Serial.printf("❌ HTTP Error: %d\n", httpResponseCode);
+        ELOG_ERROR(ELOG_HTTP_ERROR, httpResponseCode);
         checkWiFiAfterHTTPFailure();
     }
     
@@ -73,25 +83,25 @@ bool Mezzo_Controller::sendVolumeToZone(uint16_t vpAddress, int volume) {
 }
 
 bool Mezzo_Controller::sendVolumeToZoneWithVPData(uint16_t vpAddress, uint16_t vpData) {
-    if (WiFi.status() != WL_CONNECTED) {
-        return false;
-    }
-    
     int zoneIdx = findZoneIndex(vpAddress);
     if (zoneIdx == -1) return false;
     
-    // Extract low byte (dec_volume) from VP data
-    uint8_t dec_volume = vpData & 0x00FF;
-    
     // Convert dec_volume to gain using formula: GAIN = (2^(dec_volume/10))/1000
-    float gain = calculateGainFromVPData(vpData);
+    return sendGainToZone(zoneIdx, calculateGainFromVPData(vpData));
+}
+
+bool Mezzo_Controller::sendGainToZone(int zoneIdx, FixedGain gain) {
+    if (WiFi.status() != WL_CONNECTED) {
+        return false;
+    }
     
-    Serial.printf("🔊 Vol %d to %s (Gain: %.3f)\n", dec_volume, _zones[zoneIdx].name, gain);
+    ELOG_INFO(ELOG_VOLUME_SEND, _zones[zoneIdx].zoneNumber, (int32_t)gain);
     
+    WiFiClient client;
     HTTPClient http;
     String url = "http://" + _mezzoIP + "/iv/views/web/730665316/zone-controls/" + String(_zones[zoneIdx].zoneNumber);
     
-    http.begin(url);
+    http.begin(client, url);
     http.addHeader("Content-Type", "application/json");
     http.addHeader("Installation-Client-Id", "0add066f-0458-4a61-9f57-c3a82fbb63f9");
     http.addHeader("Origin", "http://" + _mezzoIP);
@@ -99,22 +109,29 @@ bool Mezzo_Controller::sendVolumeToZoneWithVPData(uint16_t vpAddress, uint16_t v
     http.setTimeout(300); // Very short timeout for volume changes
     
     // Build JSON payload
-    JsonDocument doc;
-    JsonArray zonesArr = doc["Zones"].to<JsonArray>();
-    JsonObject zoneObj = zonesArr.add<JsonObject>();
-    zoneObj["Id"] = _zones[zoneIdx].zoneId;
-    zoneObj["Gain"] = gain;
-    
     String jsonString;
-    serializeJson(doc, jsonString);
+    {
+        PerfScope scope(PERF_HIST_PUT_BUILD);
+        PerfTraceScope trace(PERF_TRACE_JSON_BUILD, _zones[zoneIdx].zoneNumber);
+        buildGainPayload(zoneIdx, gain, jsonString);
+    }
+    
+    uint32_t startUs = micros();
+    int httpResponseCode = HTTPC_ERROR_CONNECTION_REFUSED;
+    if (connectClient(client, PERF_HIST_PUT_CONNECT)) {
+        PerfScope scope(PERF_HIST_PUT_REQUEST);
+        PerfTraceScope trace(PERF_TRACE_HTTP_PUT, _zones[zoneIdx].zoneNumber);
+        httpResponseCode = http.PUT(jsonString);
+    }
+    countResult(httpResponseCode, true);
+    noteZoneResult(zoneIdx, httpResponseCode, gain, micros() - startUs);
     
-    int httpResponseCode = http.PUT(jsonString);
     bool success = false;
     if (httpResponseCode > 0) {
-        Serial.printf("✅ HTTP %d\n", httpResponseCode);
+        ELOG_DEBUG(ELOG_HTTP_OK, httpResponseCode);
         success = true;
     } else {
-        Serial.printf("❌ HTTP Error: %d\n", httpResponseCode);
+        ELOG_ERROR(ELOG_HTTP_ERROR, httpResponseCode);
         checkWiFiAfterHTTPFailure();
     }
     
@@ -122,92 +139,155 @@ bool Mezzo_Controller::sendVolumeToZoneWithVPData(uint16_t vpAddress, uint16_t v
     return success;
 }
 
-float Mezzo_Controller::readGainFromZone(uint16_t vpAddress) {
+FixedGain Mezzo_Controller::readGainFromZone(uint16_t vpAddress) {
     if (WiFi.status() != WL_CONNECTED) {
-        return 0.0f;
+        return 0;
     }
     
     int zoneIdx = findZoneIndex(vpAddress);
-    if (zoneIdx == -1) return 0.0f;
+    if (zoneIdx == -1) return 0;
     
+    WiFiClient client;
     HTTPClient http;
     String url = "http://" + _mezzoIP + "/iv/views/web/730665316/zone-controls/" + String(_zones[zoneIdx].zoneNumber);
     
-    http.begin(url);
+    http.begin(client, url);
     http.addHeader("Accept", "application/json, text/plain, */*");
     http.addHeader("Installation-Client-Id", "0add066f-0458-4a61-9f57-c3a82fbb63f9");
     http.addHeader("Origin", "http://" + _mezzoIP);
     http.addHeader("Referer", "http://" + _mezzoIP + "/webapp/views/730665316");
     http.setTimeout(_httpTimeout);
     
-    int httpResponseCode = http.GET();
-    float currentGain = 0.0f;
+    uint32_t startUs = micros();
+    int httpResponseCode = HTTPC_ERROR_CONNECTION_REFUSED;
+    if (connectClient(client, PERF_HIST_GET_CONNECT)) {
+        PerfScope scope(PERF_HIST_GET_REQUEST);
+        PerfTraceScope trace(PERF_TRACE_HTTP_GET, _zones[zoneIdx].zoneNumber);
+        httpResponseCode = http.GET();
+    }
+    countResult(httpResponseCode, false);
+    FixedGain currentGain = 0;
     
     if (httpResponseCode == 200) {
+        PerfScope scope(PERF_HIST_GET_PARSE);
+        PerfTraceScope trace(PERF_TRACE_JSON_PARSE);
         String response = http.getString();
-        
-        // Parse JSON response to extract current gain
-        JsonDocument respDoc;
-        DeserializationError err = deserializeJson(respDoc, response);
-        if (!err) {
-            if (respDoc["Code"].is<int>() && respDoc["Code"].as<int>() == 0) {
-                // Look for gain in Result.Gain.Value
-                if (respDoc["Result"]["Gain"]["Value"].is<float>()) {
-                    currentGain = respDoc["Result"]["Gain"]["Value"].as<float>();
-                }
-                // Alternative: look for gain in Result.Zones[0].Gain
-                else if (respDoc["Result"]["Zones"].is<JsonArray>()) {
-                    JsonArray resultZones = respDoc["Result"]["Zones"].as<JsonArray>();
-                    if (resultZones.size() > 0 && resultZones[0]["Gain"].is<float>()) {
-                        currentGain = resultZones[0]["Gain"].as<float>();
-                    }
-                }
-            }
-        }
+        currentGain = parseGainResponse(response);
     } else {
-        Serial.printf("❌ HTTP Error: %d (readGainFromZone)\n", httpResponseCode);
+        ELOG_ERROR(ELOG_GET_ERROR, httpResponseCode);
         checkWiFiAfterHTTPFailure();
     }
+    noteZoneResult(zoneIdx, httpResponseCode, httpResponseCode == 200 ? currentGain : _zones[zoneIdx].lastGain,
+                   micros() - startUs);
     
     http.end();
     return currentGain;
 }
 
+// Coalesced writes
+bool Mezzo_Controller::queueGain(int zoneIdx, FixedGain gain) {
+    AllocRegionScope region(ALLOC_REGION_GAIN_ENQUEUE);
+    if (zoneIdx < 0 || zoneIdx >= _numZones) return false;
+    ZoneInfo& zone = _zones[zoneIdx];
+    if (zone.writePending) {
+        perfMetrics.increment(PERF_COUNT_COALESCED_UPDATES);
+    } else {
+        zone.writePending = true;
+        _pendingWrites++;
+    }
+    zone.pendingGain = gain;
+    zone.writeRetry = false;
+    return true;
+}
+
+bool Mezzo_Controller::queueVolumeWithVPData(uint16_t vpAddress, uint16_t vpData) {
+    return queueGain(findZoneIndex(vpAddress), calculateGainFromVPData(vpData));
+}
+
+// No request and no callback: the gain already reached the Mezzo from elsewhere
+void Mezzo_Controller::setCachedGain(int zoneIdx, FixedGain gain) {
+    if (zoneIdx < 0 || zoneIdx >= _numZones) return;
+    _zones[zoneIdx].lastGain = gain;
+}
+
+// One request per call, round robin so a busy slider cannot starve the other
+// zones. Writes wait in their slots while WiFi is down. A write the Mezzo did
+// not accept goes back to its slot and is resent after MEZZO_WRITE_RETRY_MS,
+// unless a newer gain replaces it first.
+bool Mezzo_Controller::service() {
+    if (_pendingWrites == 0 || WiFi.status() != WL_CONNECTED) return false;
+    for (int n = 0; n < _numZones; n++) {
+        int zoneIdx = (_nextWrite + n) % _numZones;
+        ZoneInfo& zone = _zones[zoneIdx];
+        if (!zone.writePending) continue;
+        if (zone.writeRetry && millis() - zone.lastRequestMs < MEZZO_WRITE_RETRY_MS) continue;
+        zone.writePending = false;
+        _pendingWrites--;
+        _nextWrite = (zoneIdx + 1) % _numZones;
+        AllocRegionScope region(ALLOC_REGION_GAIN_SEND);
+        FixedGain gain = zone.pendingGain;
+        sendGainToZone(zoneIdx, gain);
+        if (!isAccepted(zone.lastStatus) && !zone.writePending) {
+            zone.writePending = true;
+            zone.pendingGain = gain;
+            zone.writeRetry = true;
+            _pendingWrites++;
+        }
+        return true;
+    }
+    return false;
+}
+
 // Utility functions
-uint16_t Mezzo_Controller::mapGainToVP(float gain) {
-    if (gain <= 0.0f) return 0x0000;  // Volume 0 → VP data 0x0000
-    if (gain >= 1.0f) return 0x6400;  // Volume 100 → VP data 0x6400
-    
-    // Reverse calculation: find volume_converted from gain
-    // GAIN = (2^(dec_volume/10))/1000, so dec_volume = 10 * log2(gain * 1000)
-    float volume_converted = 10.0f * log2f(gain * 1000.0f);
-    if (volume_converted < 0.0f) volume_converted = 0.0f;
-    if (volume_converted > 100.0f) volume_converted = 100.0f;
-    
-    // Create VP data: high byte = volume_converted (0-100), low byte = 0x00
-    uint8_t volumeByte = (uint8_t)round(volume_converted);
-    uint16_t vpData = (volumeByte << 8) | 0x00;  // Format: 0xVV00 where VV is volume_converted
-    
-    return vpData;
+uint16_t Mezzo_Controller::mapGainToVP(FixedGain gain) {
+    // Create VP data: high byte = volume (0-100), low byte = 0x00
+    return (uint16_t)(volumeFromGain(gain) << 8);
 }
 
-float Mezzo_Controller::calculateGainFromVPData(uint16_t vpData) {
-    // Extract low byte (dec_volume) from VP data
-    uint8_t dec_volume = vpData & 0x00FF;
-    
-    // Convert dec_volume to gain using formula: GAIN = (2^(dec_volume/10))/1000
-    float gain = 0.0f;
-    if (dec_volume <= 0) {
-        gain = 0.0f;
-    } else if (dec_volume >= 100) {
-        gain = 1.0f;  // Maximum gain
-    } else {
-        float exponent = (float)dec_volume / 10.0f;
-        gain = pow(2.0f, exponent) / 1000.0f;
-        if (gain > 1.0f) gain = 1.0f;  // Cap at 1.0
+FixedGain Mezzo_Controller::calculateGainFromVPData(uint16_t vpData) {
+    // Low byte (dec_volume) to gain: GAIN = (2^(dec_volume/10))/1000
+    return gainFromVolume(vpData & 0x00FF);
+}
+
+// Build the zone-controls PUT body: {"Zones":[{"Id":<zoneId>,"Gain":<gain>}]}
+void Mezzo_Controller::buildGainPayload(int zoneIdx, FixedGain gain, String& out) {
+    char gainText[GAIN_TEXT_SIZE];
+    formatGain(gain, gainText);
+    char payload[64];
+    snprintf(payload, sizeof(payload), "{\"Zones\":[{\"Id\":%lu,\"Gain\":%s}]}",
+             (unsigned long)_zones[zoneIdx].zoneId, gainText);
+    out = payload;
+}
+
+// Value of the first "key": member in JSON text, nullptr if there is none.
+// Quotes inside strings are escaped, so string contents never match.
+static const char* findJsonMember(const char* text, const char* key) {
+    size_t keyLength = strlen(key);
+    for (const char* quote = strchr(text, '"'); quote != nullptr; quote = strchr(quote + 1, '"')) {
+        if (strncmp(quote + 1, key, keyLength) != 0 || quote[keyLength + 1] != '"') continue;
+        const char* value = quote + keyLength + 2;
+        while (isspace((unsigned char)*value)) value++;
+        if (*value != ':') continue;
+        value++;
+        while (isspace((unsigned char)*value)) value++;
+        return value;
     }
-    
-    return gain;
+    return nullptr;
+}
+
+// Extract the current gain from a zone-controls GET response (0 if absent):
+// Result.Gain.Value, or Result.Zones[0].Gain, when Code is 0
+FixedGain Mezzo_Controller::parseGainResponse(const String& response) {
+    const char* code = findJsonMember(response.c_str(), "Code");
+    if (code == nullptr || code[0] != '0' || isdigit((unsigned char)code[1])) return 0;
+    
+    const char* result = findJsonMember(response.c_str(), "Result");
+    const char* gain = result != nullptr ? findJsonMember(result, "Gain") : nullptr;
+    if (gain != nullptr && *gain == '{') gain = findJsonMember(gain, "Value");
+    
+    FixedGain currentGain = 0;
+    if (gain == nullptr || parseGain(gain, currentGain) == nullptr) return 0;
+    return currentGain;
 }
 
 int Mezzo_Controller::findZoneIndex(uint16_t vpAddress) {
@@ -219,6 +299,15 @@ int Mezzo_Controller::findZoneIndex(uint16_t vpAddress) {
     return -1;
 }
 
+int Mezzo_Controller::findZoneByNumber(int zoneNumber) {
+    for (int i = 0; i < _numZones; i++) {
+        if (_zones[i].zoneNumber == zoneNumber) {
+            return i;
+        }
+    }
+    return -1;
+}
+
 int Mezzo_Controller::mapVPToVolume(uint16_t vpData) {
     // VP data range: 0x100 (256) to 0x164 (356) = 100 steps
     const uint16_t VP_MIN_VALUE = 0x100;
@@ -291,6 +380,81 @@ void Mezzo_Controller::discoverEndpoints() {
     Serial.println("🔍 Endpoint discovery complete\n");
 }
 
+// Diagnostics (each print stays below the 64-byte stack buffer of Print::printf)
+void Mezzo_Controller::printZones(Print& out) const {
+    out.printf("🎚️  %d zones on %s:%d\n", _numZones, _mezzoIP.c_str(), _mezzoPort);
+    for (int i = 0; i < _numZones; i++) {
+        const ZoneInfo& zone = _zones[i];
+        out.printf("  0x%04X zone %d id %lu", zone.vpAddr, zone.zoneNumber, (unsigned long)zone.zoneId);
+        if (zone.lastRequestMs == 0) {
+            out.println(" no requests yet");
+            continue;
+        }
+        char gainText[GAIN_TEXT_SIZE];
+        formatGain(zone.lastGain, gainText);
+        out.printf(" gain %s http %d", gainText, zone.lastStatus);
+        out.printf(" %lu ms ago, %lu/%lu failed\n", (unsigned long)(millis() - zone.lastRequestMs),
+                   (unsigned long)zone.failures, (unsigned long)zone.requests);
+    }
+}
+
+// Per-zone series in Prometheus text format, labelled with the Mezzo zone number
+void Mezzo_Controller::printPrometheus(Print& out) const {
+    out.println("# TYPE mezzo_zone_requests_total counter");
+    for (int i = 0; i < _numZones; i++) {
+        out.printf("mezzo_zone_requests_total{zone=\"%d\"} %lu\n", _zones[i].zoneNumber,
+                   (unsigned long)_zones[i].requests);
+    }
+    out.println("# TYPE mezzo_zone_failures_total counter");
+    for (int i = 0; i < _numZones; i++) {
+        out.printf("mezzo_zone_failures_total{zone=\"%d\"} %lu\n", _zones[i].zoneNumber,
+                   (unsigned long)_zones[i].failures);
+    }
+    out.println("# TYPE mezzo_zone_request_seconds summary");
+    for (int i = 0; i < _numZones; i++) {
+        uint64_t us = _zones[i].totalUs;
+        out.printf("mezzo_zone_request_seconds_sum{zone=\"%d\"} ", _zones[i].zoneNumber);
+        out.printf("%lu.%06lu\n", (unsigned long)(us / 1000000), (unsigned long)(us % 1000000));
+        out.printf("mezzo_zone_request_seconds_count{zone=\"%d\"} %lu\n", _zones[i].zoneNumber,
+                   (unsigned long)_zones[i].requests);
+    }
+    out.println("# TYPE mezzo_zone_gain gauge");
+    for (int i = 0; i < _numZones; i++) {
+        char gainText[GAIN_TEXT_SIZE];
+        formatGain(_zones[i].lastGain, gainText);
+        out.printf("mezzo_zone_gain{zone=\"%d\"} %s\n", _zones[i].zoneNumber, gainText);
+    }
+    out.println("# TYPE mezzo_zone_last_status gauge");
+    for (int i = 0; i < _numZones; i++) {
+        out.printf("mezzo_zone_last_status{zone=\"%d\"} %d\n", _zones[i].zoneNumber, _zones[i].lastStatus);
+    }
+}
+
+// Cached zone state as JSON; the gain is the queued one while a write is pending
+void Mezzo_Controller::printZoneJson(Print& out, int zoneIdx) const {
+    const ZoneInfo& zone = _zones[zoneIdx];
+    out.printf("{\"zone\":%d,\"id\":%lu,", zone.zoneNumber, (unsigned long)zone.zoneId);
+    out.printf("\"name\":\"%s\",\"vp\":%u,", zone.name, (unsigned)zone.vpAddr);
+    char gainText[GAIN_TEXT_SIZE];
+    formatGain(zone.writePending ? zone.pendingGain : zone.lastGain, gainText);
+    out.printf("\"gain\":%s,\"pending\":%s,", gainText, zone.writePending ? "true" : "false");
+    if (zone.lastRequestMs == 0) {
+        out.print("\"status\":null,\"age_ms\":null}");
+    } else {
+        out.printf("\"status\":%d,\"age_ms\":%lu}", zone.lastStatus,
+                   (unsigned long)(millis() - zone.lastRequestMs));
+    }
+}
+
+void Mezzo_Controller::printZonesJson(Print& out) const {
+    out.print("[");
+    for (int i = 0; i < _numZones; i++) {
+        if (i > 0) out.print(",\n");
+        printZoneJson(out, i);
+    }
+    out.println("]");
+}
+
 // Private methods
 bool Mezzo_Controller::makeHTTPRequest(const String& url, const String& method, const String& payload) {
     HTTPClient http;
@@ -327,3 +491,38 @@ void Mezzo_Controller::checkWiFiAfterHTTPFailure() {
         _wifiFailureCallback();
     }
 }
+
+// Connect before the request so HTTPClient reuses the socket and the
+// connect time is measured on its own
+bool Mezzo_Controller::connectClient(WiFiClient& client, PerfHistogramId histogram) {
+    uint32_t startUs = micros();
+    perfTrace.begin(PERF_TRACE_TCP_CONNECT);
+    bool connected = client.connect(_mezzoIP.c_str(), _mezzoPort, HTTPCLIENT_DEFAULT_TCP_TIMEOUT);
+    perfTrace.end(PERF_TRACE_TCP_CONNECT);
+    perfMetrics.record(histogram, micros() - startUs);
+    if (!connected) perfMetrics.increment(PERF_COUNT_CONNECT_FAILURES);
+    return connected;
+}
+
+void Mezzo_Controller::countResult(int httpResponseCode, bool isPut) {
+    perfMetrics.increment(isPut ? PERF_COUNT_PUT_REQUESTS : PERF_COUNT_GET_REQUESTS);
+    if (httpResponseCode >= 200 && httpResponseCode < 300) return;
+    perfMetrics.increment(isPut ? PERF_COUNT_PUT_FAILURES : PERF_COUNT_GET_FAILURES);
+    if (httpResponseCode == HTTPC_ERROR_READ_TIMEOUT) {
+        perfMetrics.increment(isPut ? PERF_COUNT_PUT_TIMEOUTS : PERF_COUNT_GET_TIMEOUTS);
+    }
+}
+
+void Mezzo_Controller::noteZoneResult(int zoneIdx, int httpResponseCode, FixedGain gain, uint32_t elapsedUs) {
+    ZoneInfo& zone = _zones[zoneIdx];
+    zone.lastStatus = httpResponseCode;
+    zone.lastRequestMs = millis() | 1;   // Never 0 once a request was made
+    zone.requests++;
+    zone.totalUs += elapsedUs;
+    if (!isAccepted(httpResponseCode)) {
+        zone.failures++;                 // lastGain stays what the Mezzo holds
+        return;
+    }
+    zone.lastGain = gain;
+    if (_zoneGainCallback) _zoneGainCallback(zoneIdx, gain);
+}
@@ -3,14 +3,37 @@
 
 #include <Arduino.h>
 #include <HTTPClient.h>
-#include <ArduinoJson.h>
 #include <WiFi.h>
+#include "Gain_Fixed.h"
+#include "Perf_Metrics.h"
+#include "Perf_Trace.h"
+#include "Event_Log.h"
+
+// A queued write the Mezzo did not accept stays queued and is sent again
+// after this long
+#ifndef MEZZO_WRITE_RETRY_MS
+#define MEZZO_WRITE_RETRY_MS 1000
+#endif
 
 struct ZoneInfo {
     uint16_t vpAddr;
     uint32_t zoneId;
     int zoneNumber;
     const char* name;
+    
+    // Last request to the zone, kept by Mezzo_Controller; zone tables list
+    // only the four fields above
+    FixedGain lastGain = 0;        // Gain last accepted or read back
+    int lastStatus = 0;            // HTTP status or negative HTTPClient error
+    unsigned long lastRequestMs = 0;   // 0 before the first request
+    uint32_t requests = 0;
+    uint32_t failures = 0;
+    uint64_t totalUs = 0;          // Connect plus request, summed over all requests
+    
+    // Coalescing write queue: one slot per zone, the newest gain wins
+    FixedGain pendingGain = 0;
+    bool writePending = false;
+    bool writeRetry = false;       // pendingGain was not accepted; resent after MEZZO_WRITE_RETRY_MS
 };
 
 class Mezzo_Controller {
@@ -20,10 +43,15 @@ private:
     ZoneInfo* _zones;
     int _numZones;
     unsigned long _httpTimeout;
+    int _pendingWrites;
+    int _nextWrite;                // Round-robin start for service()
     
     // Callback for WiFi status check
     void (*_wifiFailureCallback)();
     
+    // Callback for a gain the Mezzo accepted or reported
+    void (*_zoneGainCallback)(int zoneIdx, FixedGain gain);
+    
 public:
     // Constructor
     Mezzo_Controller(const char* mezzoIP, int mezzoPort = 80);
@@ -32,26 +60,52 @@ public:
     void setZones(ZoneInfo* zones, int numZones);
     void setHTTPTimeout(unsigned long timeout);
     void setWiFiFailureCallback(void (*callback)());
+    void setZoneGainCallback(void (*callback)(int zoneIdx, FixedGain gain));
+    int getNumZones() const { return _numZones; }
+    const ZoneInfo& getZone(int index) const { return _zones[index]; }
     
     // Zone control
     bool sendVolumeToZone(uint16_t vpAddress, int volume);
     bool sendVolumeToZoneWithVPData(uint16_t vpAddress, uint16_t vpData);
-    float readGainFromZone(uint16_t vpAddress);
+    bool sendGainToZone(int zoneIdx, FixedGain gain);
+    
+    // Coalesced writes: queue from touches or the REST API, send from loop()
+    bool queueGain(int zoneIdx, FixedGain gain);
+    bool queueVolumeWithVPData(uint16_t vpAddress, uint16_t vpData);
+    bool service();                // Sends one pending zone; true if a request was made
+    int getPendingWrites() const { return _pendingWrites; }
+    void setCachedGain(int zoneIdx, FixedGain gain);   // Gain learned elsewhere, e.g. from another panel
+    FixedGain readGainFromZone(uint16_t vpAddress);   // 0 if the read failed
     
     // Utility functions
-    uint16_t mapGainToVP(float gain);
-    float calculateGainFromVPData(uint16_t vpData);
+    uint16_t mapGainToVP(FixedGain gain);
+    FixedGain calculateGainFromVPData(uint16_t vpData);
     int findZoneIndex(uint16_t vpAddress);
+    int findZoneByNumber(int zoneNumber);
+    
+    // JSON text of the zone-controls API, written and scanned without a document
+    void buildGainPayload(int zoneIdx, FixedGain gain, String& out);
+    FixedGain parseGainResponse(const String& response);   // 0 if absent
     
     // API discovery
     void discoverEndpoints();
     
+    // Diagnostics
+    void printZones(Print& out) const;
+    void printPrometheus(Print& out) const;
+    void printZoneJson(Print& out, int zoneIdx) const;
+    void printZonesJson(Print& out) const;
+    
     // Volume mapping (moved from main)
     int mapVPToVolume(uint16_t vpData);
     
 private:
     bool makeHTTPRequest(const String& url, const String& method, const String& payload = "");
     void checkWiFiAfterHTTPFailure();
+    bool connectClient(WiFiClient& client, PerfHistogramId histogram);
+    void countResult(int httpResponseCode, bool isPut);
+    void noteZoneResult(int zoneIdx, int httpResponseCode, FixedGain gain, uint32_t elapsedUs);
+    static bool isAccepted(int httpResponseCode) { return httpResponseCode >= 200 && httpResponseCode < 300; }
 };
 
 #endif // MEZZO_CONTROLLER_H
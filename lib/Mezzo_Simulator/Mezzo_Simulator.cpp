@@ -0,0 +1,464 @@
+#include "Mezzo_Simulator.h"
+#include <ArduinoJson.h>
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <errno.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#define MEZZO_SIM_VIEW_PREFIX "/iv/views/web/"
+#define MEZZO_SIM_ZONE_SEGMENT "/zone-controls/"
+
+uint32_t mezzoSimDefaultZoneId(int device, int zoneNumber) {
+    if (device == 0) {
+        switch (zoneNumber) {
+            case 5: return 1868704443;
+            case 6: return 4127125796;
+            case 7: return 2170320302;
+            case 8: return 2525320065;
+            default: break;
+        }
+    }
+    // Deterministic, distinct IDs for every other zone
+    return 3000000000u + (uint32_t)device * 10000u + (uint32_t)zoneNumber;
+}
+
+// Constructor
+Mezzo_Simulator::Mezzo_Simulator(const MezzoSimConfig& config)
+    : _config(config), _stats(), _rng(config.seed), _eventCallback(nullptr) {
+    _devices.resize(_config.numDevices);
+    _online.assign(_config.numDevices, true);
+    for (int d = 0; d < _config.numDevices; d++) {
+        for (int z = 1; z <= _config.zonesPerDevice; z++) {
+            _devices[d].push_back({mezzoSimDefaultZoneId(d, z), 0.1f, 0});
+        }
+    }
+}
+
+// Request handling
+void Mezzo_Simulator::handleRequest(const MezzoSimRequest& req, MezzoSimResponse& resp, uint64_t nowUs) {
+    std::lock_guard<std::mutex> lock(_mutex);
+
+    resp.status = 200;
+    resp.body.clear();
+    resp.dropConnection = false;
+    resp.delayMs = _config.latencyMs;
+    if (_config.jitterMs > 0) {
+        resp.delayMs += _rng() % (_config.jitterMs + 1);
+    }
+
+    _stats.requests++;
+    if (req.device < 0 || req.device >= _config.numDevices || !_online[req.device]) {
+        _stats.refused++;
+        resp.status = -1;
+        resp.delayMs = 0;
+        return;
+    }
+
+    std::uniform_real_distribution<float> chance(0.0f, 1.0f);
+    if (_config.closeRate > 0.0f && chance(_rng) < _config.closeRate) {
+        _stats.drops++;
+        resp.dropConnection = true;
+        return;
+    }
+    if (_config.failureRate > 0.0f && chance(_rng) < _config.failureRate) {
+        _stats.failures++;
+        resp.status = 500;
+        resp.body = "{\"Code\":500,\"Message\":\"Internal error\"}";
+        emitEvent(nowUs, req.device, -1, req.method == "PUT", 0.0f, resp.status);
+        return;
+    }
+
+    // Path: /iv/views/web/<view>[/zone-controls/<n>], query string ignored
+    std::string path = req.path.substr(0, req.path.find('?'));
+    if (path.compare(0, strlen(MEZZO_SIM_VIEW_PREFIX), MEZZO_SIM_VIEW_PREFIX) != 0) {
+        _stats.badRequests++;
+        resp.status = 404;
+        return;
+    }
+    size_t zonePos = path.find(MEZZO_SIM_ZONE_SEGMENT);
+    if (zonePos == std::string::npos) {
+        // View summary, as probed by discoverEndpoints()
+        _stats.gets++;
+        char buf[96];
+        snprintf(buf, sizeof(buf), "{\"Code\":0,\"Message\":\"OK\",\"Result\":{\"ZoneCount\":%d}}",
+                 _config.zonesPerDevice);
+        resp.body = buf;
+        return;
+    }
+    int zoneNumber = atoi(path.c_str() + zonePos + strlen(MEZZO_SIM_ZONE_SEGMENT));
+
+    if (req.method == "GET") {
+        _stats.gets++;
+        handleGet(req.device, zoneNumber, resp);
+        emitEvent(nowUs, req.device, zoneNumber, false, resp.status == 200 ? findZone(req.device, zoneNumber)->gain : 0.0f,
+                  resp.status);
+    } else if (req.method == "PUT") {
+        _stats.puts++;
+        handlePut(req.device, req.body, resp, nowUs);
+    } else {
+        _stats.badRequests++;
+        resp.status = 405;
+    }
+}
+
+void Mezzo_Simulator::handleGet(int device, int zoneNumber, MezzoSimResponse& resp) {
+    Zone* zone = findZone(device, zoneNumber);
+    if (zone == nullptr) {
+        _stats.badRequests++;
+        resp.status = 404;
+        resp.body = "{\"Code\":404,\"Message\":\"Zone not found\"}";
+        return;
+    }
+
+    // Same shape readGainFromZone() looks for: Code and Result.Gain.Value
+    char buf[256];
+    snprintf(buf, sizeof(buf),
+             "{\"Code\":0,\"Message\":\"OK\",\"Result\":{\"Id\":%u,\"Index\":%d,\"Name\":\"Zone %d\","
+             "\"Gain\":{\"Value\":%.6g,\"Min\":0.0,\"Max\":1.0},\"Mute\":{\"Value\":false}}}",
+             zone->zoneId, zoneNumber, zoneNumber, zone->gain);
+    resp.body = buf;
+}
+
+void Mezzo_Simulator::handlePut(int device, const std::string& body, MezzoSimResponse& resp, uint64_t nowUs) {
+    // Body: {"Zones":[{"Id":<zoneId>,"Gain":<gain>}, ...]}
+    JsonDocument doc;
+    DeserializationError err = deserializeJson(doc, body.c_str(), body.size());
+    if (err || !doc["Zones"].is<JsonArray>()) {
+        _stats.badRequests++;
+        resp.status = 400;
+        resp.body = "{\"Code\":400,\"Message\":\"Malformed body\"}";
+        return;
+    }
+
+    std::string result = "{\"Code\":0,\"Message\":\"OK\",\"Result\":{\"Zones\":[";
+    JsonArray zones = doc["Zones"].as<JsonArray>();
+    for (size_t i = 0; i < zones.size(); i++) {
+        uint32_t zoneId = zones[i]["Id"].as<uint32_t>();
+        int zoneNumber = findZoneNumberById(device, zoneId);
+        if (zoneNumber < 0 || !zones[i]["Gain"].is<float>()) {
+            _stats.badRequests++;
+            resp.status = 400;
+            resp.body = "{\"Code\":400,\"Message\":\"Unknown zone Id\"}";
+            return;
+        }
+        float gain = zones[i]["Gain"].as<float>();
+        if (gain < 0.0f) gain = 0.0f;
+        if (gain > 1.0f) gain = 1.0f;
+
+        Zone* zone = findZone(device, zoneNumber);
+        zone->gain = gain;
+        zone->writes++;
+        emitEvent(nowUs, device, zoneNumber, true, gain, 200);
+
+        char buf[64];
+        snprintf(buf, sizeof(buf), "%s{\"Id\":%u,\"Gain\":%.6g}", i > 0 ? "," : "", zoneId, gain);
+        result += buf;
+    }
+    result += "]}}";
+    resp.body = result;
+}
+
+Mezzo_Simulator::Zone* Mezzo_Simulator::findZone(int device, int zoneNumber) {
+    if (device < 0 || device >= _config.numDevices) return nullptr;
+    if (zoneNumber < 1 || zoneNumber > _config.zonesPerDevice) return nullptr;
+    return &_devices[device][zoneNumber - 1];
+}
+
+int Mezzo_Simulator::findZoneNumberById(int device, uint32_t zoneId) {
+    for (int z = 0; z < _config.zonesPerDevice; z++) {
+        if (_devices[device][z].zoneId == zoneId) return z + 1;
+    }
+    return -1;
+}
+
+void Mezzo_Simulator::emitEvent(uint64_t nowUs, int device, int zoneNumber, bool isWrite, float gain, int status) {
+    if (_eventCallback) {
+        MezzoSimEvent event = {nowUs, device, zoneNumber, isWrite, gain, status};
+        _eventCallback(event);
+    }
+}
+
+// Zone state access
+float Mezzo_Simulator::getZoneGain(int device, int zoneNumber) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    Zone* zone = findZone(device, zoneNumber);
+    return zone ? zone->gain : 0.0f;
+}
+
+void Mezzo_Simulator::setZoneGain(int device, int zoneNumber, float gain) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    Zone* zone = findZone(device, zoneNumber);
+    if (zone) zone->gain = gain;
+}
+
+uint32_t Mezzo_Simulator::getZoneId(int device, int zoneNumber) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    Zone* zone = findZone(device, zoneNumber);
+    return zone ? zone->zoneId : 0;
+}
+
+void Mezzo_Simulator::setZoneId(int device, int zoneNumber, uint32_t zoneId) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    Zone* zone = findZone(device, zoneNumber);
+    if (zone) zone->zoneId = zoneId;
+}
+
+unsigned long Mezzo_Simulator::getZoneWrites(int device, int zoneNumber) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    Zone* zone = findZone(device, zoneNumber);
+    return zone ? zone->writes : 0;
+}
+
+// Fault injection
+void Mezzo_Simulator::setOnline(int device, bool online) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (device >= 0 && device < _config.numDevices) _online[device] = online;
+}
+
+bool Mezzo_Simulator::isOnline(int device) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return device >= 0 && device < _config.numDevices && _online[device];
+}
+
+void Mezzo_Simulator::setFailureRate(float failureRate) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _config.failureRate = failureRate;
+}
+
+void Mezzo_Simulator::setCloseRate(float closeRate) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _config.closeRate = closeRate;
+}
+
+void Mezzo_Simulator::setLatency(unsigned long latencyMs, unsigned long jitterMs) {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _config.latencyMs = latencyMs;
+    _config.jitterMs = jitterMs;
+}
+
+bool Mezzo_Simulator::applyFixture(const std::string& json) {
+    JsonDocument doc;
+    if (deserializeJson(doc, json.c_str(), json.size()) || !doc["devices"].is<JsonArray>()) return false;
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (doc["latencyMs"].is<unsigned long>()) _config.latencyMs = doc["latencyMs"].as<unsigned long>();
+    if (doc["jitterMs"].is<unsigned long>()) _config.jitterMs = doc["jitterMs"].as<unsigned long>();
+
+    JsonArray devices = doc["devices"].as<JsonArray>();
+    for (size_t d = 0; d < devices.size(); d++) {
+        JsonArray zones = devices[d]["zones"].as<JsonArray>();
+        for (size_t i = 0; i < zones.size(); i++) {
+            int zoneNumber = zones[i]["number"].as<int>();
+            if (zoneNumber < 1) return false;
+
+            // New devices and zones get default IDs before the fixture values apply
+            if ((int)d >= _config.numDevices) {
+                _config.numDevices = (int)d + 1;
+                _devices.resize(_config.numDevices);
+                _online.resize(_config.numDevices, true);
+            }
+            if (zoneNumber > _config.zonesPerDevice) _config.zonesPerDevice = zoneNumber;
+            for (int dev = 0; dev < _config.numDevices; dev++) {
+                for (int z = (int)_devices[dev].size() + 1; z <= _config.zonesPerDevice; z++) {
+                    _devices[dev].push_back({mezzoSimDefaultZoneId(dev, z), 0.1f, 0});
+                }
+            }
+
+            Zone& zone = _devices[d][zoneNumber - 1];
+            if (zones[i]["id"].is<uint32_t>()) zone.zoneId = zones[i]["id"].as<uint32_t>();
+            if (zones[i]["gain"].is<float>()) zone.gain = zones[i]["gain"].as<float>();
+        }
+    }
+    return true;
+}
+
+// Observation
+void Mezzo_Simulator::setEventCallback(void (*callback)(const MezzoSimEvent& event)) {
+    _eventCallback = callback;
+}
+
+MezzoSimStats Mezzo_Simulator::getStats() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _stats;
+}
+
+void Mezzo_Simulator::resetStats() {
+    std::lock_guard<std::mutex> lock(_mutex);
+    _stats = MezzoSimStats();
+}
+
+// ---------------------------------------------------------------------------
+// TCP front end
+// ---------------------------------------------------------------------------
+
+static uint64_t serverNowUs() {
+    return (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+Mezzo_Sim_Server::Mezzo_Sim_Server(Mezzo_Simulator& sim, uint16_t basePort)
+    : _sim(sim), _basePort(basePort), _running(false), _activeConnections(0), _nextConnectionId(1),
+      _exchangeCallback(nullptr) {
+}
+
+Mezzo_Sim_Server::~Mezzo_Sim_Server() {
+    stop();
+}
+
+bool Mezzo_Sim_Server::start() {
+    int numDevices = _sim.getConfig().numDevices;
+    _running = true;
+    for (int d = 0; d < numDevices; d++) {
+        int fd = socket(AF_INET, SOCK_STREAM, 0);
+        if (fd < 0) {
+            stop();
+            return false;
+        }
+        int one = 1;
+        setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+        struct sockaddr_in addr;
+        memset(&addr, 0, sizeof(addr));
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        addr.sin_port = htons(getPort(d));
+        if (bind(fd, (struct sockaddr*)&addr, sizeof(addr)) < 0 || listen(fd, 64) < 0) {
+            fprintf(stderr, "Mezzo sim: cannot listen on port %u: %s\n", getPort(d), strerror(errno));
+            close(fd);
+            stop();
+            return false;
+        }
+        _listenFds.push_back(fd);
+        _acceptThreads.emplace_back(&Mezzo_Sim_Server::acceptLoop, this, d, fd);
+    }
+    return true;
+}
+
+void Mezzo_Sim_Server::stop() {
+    _running = false;
+    for (size_t i = 0; i < _listenFds.size(); i++) {
+        shutdown(_listenFds[i], SHUT_RDWR);
+        close(_listenFds[i]);
+    }
+    for (size_t i = 0; i < _acceptThreads.size(); i++) {
+        if (_acceptThreads[i].joinable()) _acceptThreads[i].join();
+    }
+    _listenFds.clear();
+    _acceptThreads.clear();
+    while (_activeConnections > 0) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+}
+
+void Mezzo_Sim_Server::acceptLoop(int device, int listenFd) {
+    while (_running) {
+        struct pollfd pfd = {listenFd, POLLIN, 0};
+        if (poll(&pfd, 1, 200) <= 0) continue;
+        int fd = accept(listenFd, nullptr, nullptr);
+        if (fd < 0) continue;
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        _activeConnections++;
+        std::thread(&Mezzo_Sim_Server::serveConnection, this, device, fd, _nextConnectionId++).detach();
+    }
+}
+
+void Mezzo_Sim_Server::serveConnection(int device, int fd, unsigned long connectionId) {
+    std::string buffer;
+    char chunk[1024];
+    bool open = true;
+
+    while (open && _running) {
+        // Read one request: headers up to the blank line, then Content-Length bytes
+        size_t headerEnd;
+        while ((headerEnd = buffer.find("\r\n\r\n")) == std::string::npos) {
+            struct pollfd pfd = {fd, POLLIN, 0};
+            int ready = poll(&pfd, 1, 200);
+            if (!_running) break;
+            if (ready == 0) continue;
+            ssize_t n = recv(fd, chunk, sizeof(chunk), 0);
+            if (n <= 0) {
+                open = false;
+                break;
+            }
+            buffer.append(chunk, n);
+        }
+        if (!open || !_running) break;
+
+        MezzoSimRequest req;
+        req.device = device;
+        std::string head = buffer.substr(0, headerEnd);
+        size_t sp1 = head.find(' ');
+        size_t sp2 = head.find(' ', sp1 + 1);
+        req.method = head.substr(0, sp1);
+        req.path = head.substr(sp1 + 1, sp2 - sp1 - 1);
+
+        size_t contentLength = 0;
+        bool clientClose = false;
+        size_t lineStart = head.find("\r\n");
+        while (lineStart != std::string::npos && lineStart < head.size()) {
+            lineStart += 2;
+            size_t lineEnd = head.find("\r\n", lineStart);
+            std::string line = head.substr(lineStart, lineEnd == std::string::npos ? std::string::npos : lineEnd - lineStart);
+            if (strncasecmp(line.c_str(), "Content-Length:", 15) == 0) {
+                contentLength = strtoul(line.c_str() + 15, nullptr, 10);
+            } else if (strncasecmp(line.c_str(), "Connection:", 11) == 0 && strcasestr(line.c_str(), "close")) {
+                clientClose = true;
+            }
+            lineStart = lineEnd;
+        }
+
+        size_t bodyStart = headerEnd + 4;
+        while (buffer.size() < bodyStart + contentLength) {
+            ssize_t n = recv(fd, chunk, sizeof(chunk), 0);
+            if (n <= 0) {
+                open = false;
+                break;
+            }
+            buffer.append(chunk, n);
+        }
+        if (!open) break;
+        req.body = buffer.substr(bodyStart, contentLength);
+        buffer.erase(0, bodyStart + contentLength);
+
+        MezzoSimResponse resp;
+        uint64_t startUs = serverNowUs();
+        _sim.handleRequest(req, resp, startUs);
+        if (resp.status < 0 || resp.dropConnection) {
+            if (_exchangeCallback && resp.status >= 0) {
+                _exchangeCallback({startUs, serverNowUs(), connectionId, device, req.method, req.path, req.body, 0, ""});
+            }
+            break;
+        }
+
+        if (resp.delayMs > 0) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(resp.delayMs));
+        }
+
+        bool keepOpen = _sim.getConfig().keepAlive && !clientClose;
+        const char* reason = resp.status == 200 ? "OK" : resp.status == 500 ? "Internal Server Error" : "Error";
+        char header[256];
+        int headerLen = snprintf(header, sizeof(header),
+                                 "HTTP/1.1 %d %s\r\nContent-Type: application/json; charset=utf-8\r\n"
+                                 "Content-Length: %zu\r\nConnection: %s\r\n\r\n",
+                                 resp.status, reason, resp.body.size(), keepOpen ? "keep-alive" : "close");
+        std::string out(header, headerLen);
+        out += resp.body;
+        if (send(fd, out.data(), out.size(), MSG_NOSIGNAL) < 0) break;
+        if (_exchangeCallback) {
+            _exchangeCallback({startUs, serverNowUs(), connectionId, device, req.method, req.path, req.body,
+                               resp.status, resp.body});
+        }
+        if (!keepOpen) break;
+    }
+
+    close(fd);
+    _activeConnections--;
+}
@@ -0,0 +1,159 @@
+#ifndef MEZZO_SIMULATOR_H
+#define MEZZO_SIMULATOR_H
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <atomic>
+
+// Simulator behaviour, shared by every simulated device
+struct MezzoSimConfig {
+    int numDevices = 1;
+    int zonesPerDevice = 8;        // Zone numbers 1..zonesPerDevice
+    unsigned long latencyMs = 15;  // Base response time
+    unsigned long jitterMs = 5;    // Uniform extra delay in [0, jitterMs]
+    float failureRate = 0.0f;      // Fraction of requests answered with HTTP 500
+    float closeRate = 0.0f;        // Fraction of requests dropped without a response
+    bool keepAlive = false;        // Keep connections open between requests (server mode)
+    uint32_t seed = 1;
+};
+
+struct MezzoSimRequest {
+    int device;
+    std::string method;
+    std::string path;
+    std::string body;
+};
+
+struct MezzoSimResponse {
+    int status;                    // HTTP status, or -1 when the connection is refused
+    std::string body;
+    unsigned long delayMs;         // How long the device takes to answer
+    bool dropConnection;           // Close without answering
+};
+
+// One handled request, reported for latency and load measurements
+struct MezzoSimEvent {
+    uint64_t timestampUs;
+    int device;
+    int zoneNumber;
+    bool isWrite;
+    float gain;
+    int status;
+};
+
+// One request/response pair as served over TCP, for traffic recording (HAR export)
+struct MezzoSimExchange {
+    uint64_t startUs;              // Request fully received
+    uint64_t endUs;                // Response sent
+    unsigned long connectionId;    // Same id for requests on a kept-alive connection
+    int device;
+    std::string method;
+    std::string path;
+    std::string requestBody;
+    int status;                    // 0 when the connection was dropped without a response
+    std::string responseBody;
+};
+
+struct MezzoSimStats {
+    unsigned long requests;
+    unsigned long gets;
+    unsigned long puts;
+    unsigned long failures;        // Injected HTTP 500s
+    unsigned long drops;           // Injected connection drops
+    unsigned long refused;         // Requests to an offline device
+    unsigned long badRequests;
+};
+
+// Zone state and request handling of one or more simulated Mezzo amplifiers.
+// Transport-agnostic: Mezzo_Sim_Server serves it over TCP, host harnesses can
+// call handleRequest() directly and apply delayMs on a virtual clock.
+class Mezzo_Simulator {
+private:
+    struct Zone {
+        uint32_t zoneId;
+        float gain;
+        unsigned long writes;
+    };
+
+    MezzoSimConfig _config;
+    std::vector<std::vector<Zone>> _devices;
+    std::vector<bool> _online;
+    MezzoSimStats _stats;
+    std::mt19937 _rng;
+    std::mutex _mutex;
+    void (*_eventCallback)(const MezzoSimEvent& event);
+
+    Zone* findZone(int device, int zoneNumber);
+    int findZoneNumberById(int device, uint32_t zoneId);
+    void handleGet(int device, int zoneNumber, MezzoSimResponse& resp);
+    void handlePut(int device, const std::string& body, MezzoSimResponse& resp, uint64_t nowUs);
+    void emitEvent(uint64_t nowUs, int device, int zoneNumber, bool isWrite, float gain, int status);
+
+public:
+    // Constructor
+    Mezzo_Simulator(const MezzoSimConfig& config = MezzoSimConfig());
+
+    // Request handling
+    void handleRequest(const MezzoSimRequest& req, MezzoSimResponse& resp, uint64_t nowUs);
+
+    // Zone state access
+    float getZoneGain(int device, int zoneNumber);
+    void setZoneGain(int device, int zoneNumber, float gain);
+    uint32_t getZoneId(int device, int zoneNumber);
+    void setZoneId(int device, int zoneNumber, uint32_t zoneId);
+    unsigned long getZoneWrites(int device, int zoneNumber);
+
+    // Fault injection
+    void setOnline(int device, bool online);
+    bool isOnline(int device);
+    void setFailureRate(float failureRate);
+    void setCloseRate(float closeRate);
+    void setLatency(unsigned long latencyMs, unsigned long jitterMs);
+
+    // Zone IDs, gains and latency from a fixture (host/har/har_tool.py fixture):
+    // {"latencyMs":n,"jitterMs":n,"devices":[{"zones":[{"number":n,"id":n,"gain":f}]}]}
+    // Grows the device and zone tables as needed.
+    bool applyFixture(const std::string& json);
+
+    // Observation
+    void setEventCallback(void (*callback)(const MezzoSimEvent& event));
+    MezzoSimStats getStats();
+    void resetStats();
+    const MezzoSimConfig& getConfig() const { return _config; }
+};
+
+// TCP front end: device d listens on basePort + d and speaks HTTP/1.1
+class Mezzo_Sim_Server {
+private:
+    Mezzo_Simulator& _sim;
+    uint16_t _basePort;
+    std::vector<int> _listenFds;
+    std::vector<std::thread> _acceptThreads;
+    std::atomic<bool> _running;
+    std::atomic<int> _activeConnections;
+    std::atomic<unsigned long> _nextConnectionId;
+    void (*_exchangeCallback)(const MezzoSimExchange& exchange);
+
+    void acceptLoop(int device, int listenFd);
+    void serveConnection(int device, int fd, unsigned long connectionId);
+
+public:
+    Mezzo_Sim_Server(Mezzo_Simulator& sim, uint16_t basePort);
+    ~Mezzo_Sim_Server();
+
+    bool start();
+    void stop();
+    uint16_t getPort(int device) const { return (uint16_t)(_basePort + device); }
+
+    // Called from the connection threads after every response; set before start()
+    void setExchangeCallback(void (*callback)(const MezzoSimExchange& exchange)) { _exchangeCallback = callback; }
+};
+
+// Zone ID of the real installation (zones 5-8 of view 730665316), used as defaults for device 0
+uint32_t mezzoSimDefaultZoneId(int device, int zoneNumber);
+
+#endif // MEZZO_SIMULATOR_H
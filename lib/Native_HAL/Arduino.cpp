@@ -0,0 +1,153 @@
+#include "Arduino.h"
+#include "Native_Clock.h"
+#include <chrono>
+#include <random>
+#include <thread>
+#include <malloc.h>
+
+// Heap size of an ESP32-C3 running the Arduino core, used to report free heap
+#define HOST_HEAP_SIZE (320u * 1024u)
+
+// ESP32-C3 default CPU clock, for the cycle counter
+#define HOST_CPU_FREQ_MHZ 160
+
+EspClass ESP;
+
+static const std::chrono::steady_clock::time_point bootTime = std::chrono::steady_clock::now();
+static uint8_t pinLevels[64];
+static uint32_t minFreeHeap = HOST_HEAP_SIZE;
+
+static bool virtualTime = false;
+static uint64_t virtualNowUs = 0;
+static void (*timeHook)(uint64_t nowUs) = nullptr;
+
+// Time base
+void hostUseVirtualTime(bool enable) {
+    virtualTime = enable;
+}
+
+bool hostIsVirtualTime() {
+    return virtualTime;
+}
+
+uint64_t hostMicros64() {
+    if (virtualTime) return virtualNowUs;
+    auto elapsed = std::chrono::steady_clock::now() - bootTime;
+    return (uint64_t)std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count();
+}
+
+void hostAdvanceTime(uint64_t us) {
+    if (!virtualTime) {
+        std::this_thread::sleep_for(std::chrono::microseconds(us));
+        return;
+    }
+    while (us > 0) {
+        uint64_t step = us < 1000 ? us : 1000;
+        virtualNowUs += step;
+        us -= step;
+        if (timeHook) timeHook(virtualNowUs);
+    }
+}
+
+void hostSetTimeHook(void (*hook)(uint64_t nowUs)) {
+    timeHook = hook;
+}
+
+// Timing (32-bit wrap-around, same as on the device)
+unsigned long micros() {
+    return (unsigned long)(uint32_t)hostMicros64();
+}
+
+unsigned long millis() {
+    return (unsigned long)(uint32_t)(hostMicros64() / 1000);
+}
+
+void delay(unsigned long ms) {
+    hostAdvanceTime((uint64_t)ms * 1000);
+}
+
+void delayMicroseconds(unsigned int us) {
+    hostAdvanceTime(us);
+}
+
+void yield() {
+    if (!virtualTime) std::this_thread::yield();
+}
+
+// Digital I/O
+void pinMode(uint8_t pin, uint8_t mode) {
+    (void)pin;
+    (void)mode;
+}
+
+void digitalWrite(uint8_t pin, uint8_t val) {
+    if (pin < sizeof(pinLevels)) pinLevels[pin] = val ? HIGH : LOW;
+}
+
+int digitalRead(uint8_t pin) {
+    return pin < sizeof(pinLevels) ? pinLevels[pin] : LOW;
+}
+
+// CPU clock
+uint32_t getCpuFrequencyMhz() {
+    return HOST_CPU_FREQ_MHZ;
+}
+
+// Math helpers
+long map(long x, long in_min, long in_max, long out_min, long out_max) {
+    // Same integer arithmetic as the ESP32 core
+    const long run = in_max - in_min;
+    if (run == 0) return -1;
+    const long rise = out_max - out_min;
+    const long delta = x - in_min;
+    return (delta * rise) / run + out_min;
+}
+
+uint32_t esp_random() {
+    static std::random_device device;
+    return device();
+}
+
+// Heap queries, derived from the host allocator's in-use bytes
+uint32_t EspClass::getHeapSize() {
+    return HOST_HEAP_SIZE;
+}
+
+uint32_t EspClass::getFreeHeap() {
+    struct mallinfo2 info = mallinfo2();
+    uint32_t used = info.uordblks > HOST_HEAP_SIZE ? HOST_HEAP_SIZE : (uint32_t)info.uordblks;
+    uint32_t freeHeap = HOST_HEAP_SIZE - used;
+    if (freeHeap < minFreeHeap) minFreeHeap = freeHeap;
+    return freeHeap;
+}
+
+uint32_t EspClass::getMinFreeHeap() {
+    getFreeHeap();
+    return minFreeHeap;
+}
+
+uint32_t EspClass::getMaxAllocHeap() {
+    return getFreeHeap();
+}
+
+// MAC 02:00:00:00:00:01 in the device's byte order (first octet lowest)
+uint64_t EspClass::getEfuseMac() {
+    const char* env = getenv("NATIVE_EFUSE_MAC");
+    return env ? strtoull(env, nullptr, 16) : 0x010000000002ULL;
+}
+
+// 32-bit like the CPU's counter, wrapping every 26.8 s
+uint32_t EspClass::getCycleCount() {
+    return (uint32_t)(hostMicros64() * HOST_CPU_FREQ_MHZ);
+}
+
+#ifndef NATIVE_HAL_NO_MAIN
+// Same entry point as the Arduino core: setup() once, then loop() forever
+int main() {
+    setup();
+    for (;;) {
+        loop();
+    }
+    return 0;
+}
+#endif
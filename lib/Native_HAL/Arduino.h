@@ -0,0 +1,54 @@
+#ifndef ARDUINO_H
+#define ARDUINO_H
+
+// Host (Linux) build of the Arduino-ESP32 core API surface used by this project.
+// Only compiled for the PlatformIO "native" environments.
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <ctype.h>
+
+#include "WString.h"
+#include "Print.h"
+#include "IPAddress.h"
+#include "HardwareSerial.h"
+#include "Esp.h"
+#include "Native_Clock.h"
+
+typedef bool boolean;
+typedef uint8_t byte;
+
+#define LOW    0x0
+#define HIGH   0x1
+#define INPUT  0x01
+#define OUTPUT 0x03
+
+// Timing
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+void yield();
+
+// Digital I/O (pin levels are only remembered, there is no hardware behind them)
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+int digitalRead(uint8_t pin);
+
+// CPU clock the cycle counter runs at
+uint32_t getCpuFrequencyMhz();
+
+// Math helpers
+long map(long x, long in_min, long in_max, long out_min, long out_max);
+
+// Hardware RNG on the ESP32; the host's random device here
+uint32_t esp_random();
+
+// Sketch entry points
+void setup();
+void loop();
+
+#endif // ARDUINO_H
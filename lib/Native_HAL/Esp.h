@@ -0,0 +1,19 @@
+#ifndef ESP_H
+#define ESP_H
+
+#include <stdint.h>
+
+// Host stand-in for the ESP32 EspClass (heap queries and the cycle counter)
+class EspClass {
+public:
+    uint32_t getHeapSize();
+    uint32_t getFreeHeap();
+    uint32_t getMinFreeHeap();
+    uint32_t getMaxAllocHeap();
+    uint32_t getCycleCount();   // Derived from micros(), so it follows virtual time
+    uint64_t getEfuseMac();     // NATIVE_EFUSE_MAC (hex) if set, so host instances can differ
+};
+
+extern EspClass ESP;
+
+#endif // ESP_H
@@ -0,0 +1,221 @@
+#include "HTTPClient.h"
+#include "WiFi.h"
+#include <poll.h>
+#include <strings.h>
+#include <sys/socket.h>
+
+static HostHTTPTransport hostTransport = nullptr;
+
+void HTTPClient::hostSetTransport(HostHTTPTransport transport) {
+    hostTransport = transport;
+}
+
+HTTPClient::HTTPClient()
+    : _port(80), _responseSize(-1), _connectTimeout(HTTPCLIENT_DEFAULT_TCP_TIMEOUT),
+      _timeout(HTTPCLIENT_DEFAULT_TCP_TIMEOUT), _client(&_ownClient) {
+}
+
+bool HTTPClient::begin(WiFiClient& client, const String& url) {
+    if (!begin(url)) return false;
+    _client = &client;
+    return true;
+}
+
+bool HTTPClient::begin(const String& url) {
+    _client = &_ownClient;
+    _requestHeaders.clear();
+    _responseHeaders.clear();
+    _responseBody.clear();
+    _responseSize = -1;
+
+    String rest = url;
+    if (rest.startsWith("http://")) {
+        rest = rest.substring(7);
+    } else if (rest.indexOf("://") >= 0) {
+        return false; // Only plain HTTP is supported, as used by the Mezzo API
+    }
+
+    int slash = rest.indexOf('/');
+    String hostPort = slash >= 0 ? rest.substring(0, slash) : rest;
+    _path = slash >= 0 ? rest.substring(slash) : String("/");
+
+    int colon = hostPort.indexOf(':');
+    if (colon >= 0) {
+        _host = hostPort.substring(0, colon);
+        _port = (uint16_t)hostPort.substring(colon + 1).toInt();
+    } else {
+        _host = hostPort;
+        _port = 80;
+    }
+    return _host.length() > 0;
+}
+
+void HTTPClient::end() {
+    _requestHeaders.clear();
+    _client->stop();
+}
+
+void HTTPClient::addHeader(const String& name, const String& value) {
+    _requestHeaders.push_back({name, value});
+}
+
+void HTTPClient::setTimeout(uint16_t timeout) {
+    _timeout = timeout;
+}
+
+void HTTPClient::setConnectTimeout(int32_t connectTimeout) {
+    _connectTimeout = connectTimeout;
+}
+
+int HTTPClient::GET() {
+    return sendRequest("GET", String());
+}
+
+int HTTPClient::PUT(const String& payload) {
+    return sendRequest("PUT", payload);
+}
+
+int HTTPClient::POST(const String& payload) {
+    return sendRequest("POST", payload);
+}
+
+String HTTPClient::getString() {
+    return _responseBody;
+}
+
+int HTTPClient::getSize() {
+    return _responseSize;
+}
+
+String HTTPClient::header(const char* name) {
+    for (size_t i = 0; i < _responseHeaders.size(); i++) {
+        if (strcasecmp(_responseHeaders[i].name.c_str(), name) == 0) {
+            return _responseHeaders[i].value;
+        }
+    }
+    return String();
+}
+
+// Private methods
+static bool sendAll(WiFiClient& client, const char* data, size_t len) {
+    return client.write((const uint8_t*)data, len) == len;
+}
+
+int HTTPClient::sendRequest(const char* method, const String& payload) {
+    _responseHeaders.clear();
+    _responseBody.clear();
+    _responseSize = -1;
+
+    // No network without an associated station, same as on the device
+    if (WiFi.status() != WL_CONNECTED) return HTTPC_ERROR_CONNECTION_REFUSED;
+
+    if (hostTransport) {
+        HostHTTPRequest request = {method, _host, _port, _path, payload, _connectTimeout, _timeout};
+        HostHTTPResponse response;
+        int code = hostTransport(request, response);
+        if (code > 0) {
+            _responseBody = response.body;
+            _responseSize = (int)response.body.length();
+            if (response.contentType.length() > 0) {
+                _responseHeaders.push_back({String("Content-Type"), response.contentType});
+            }
+        }
+        return code;
+    }
+
+    if (!_client->connected() || _client->hostIsSimulated()) {
+        if (!_client->connect(_host.c_str(), _port, (int32_t)_connectTimeout)) {
+            return HTTPC_ERROR_CONNECTION_REFUSED;
+        }
+        if (_client->hostIsSimulated()) return HTTPC_ERROR_NOT_CONNECTED;
+    }
+    int fd = _client->fd();
+
+    String request = String(method) + " " + _path + " HTTP/1.1\r\n";
+    request += "Host: " + _host + "\r\n";
+    request += "User-Agent: ESP32HTTPClient\r\n";
+    request += "Connection: close\r\n";
+    for (size_t i = 0; i < _requestHeaders.size(); i++) {
+        request += _requestHeaders[i].name + ": " + _requestHeaders[i].value + "\r\n";
+    }
+    if (payload.length() > 0 || strcmp(method, "GET") != 0) {
+        request += "Content-Length: " + String(payload.length()) + "\r\n";
+    }
+    request += "\r\n";
+
+    if (!sendAll(*_client, request.c_str(), request.length())) {
+        _client->stop();
+        return HTTPC_ERROR_SEND_HEADER_FAILED;
+    }
+    if (payload.length() > 0 && !sendAll(*_client, payload.c_str(), payload.length())) {
+        _client->stop();
+        return HTTPC_ERROR_SEND_PAYLOAD_FAILED;
+    }
+
+    // Read until the server closes the connection or the body is complete
+    String raw;
+    int headerEnd = -1;
+    int contentLength = -1;
+    char buf[512];
+    for (;;) {
+        struct pollfd pfd = {fd, POLLIN, 0};
+        int ready = poll(&pfd, 1, (int)_timeout);
+        if (ready <= 0) {
+            _client->stop();
+            return HTTPC_ERROR_READ_TIMEOUT;
+        }
+        ssize_t n = recv(fd, buf, sizeof(buf), 0);
+        if (n < 0) {
+            _client->stop();
+            return HTTPC_ERROR_CONNECTION_LOST;
+        }
+        if (n == 0) break;
+        raw.concat(buf, (unsigned int)n);
+
+        if (headerEnd < 0) {
+            headerEnd = raw.indexOf("\r\n\r\n");
+            if (headerEnd >= 0) {
+                int clPos = -1;
+                String lower;
+                for (unsigned int i = 0; i < (unsigned int)headerEnd; i++) {
+                    lower += (char)tolower(raw[i]);
+                }
+                clPos = lower.indexOf("content-length:");
+                if (clPos >= 0) contentLength = raw.substring(clPos + 15).toInt();
+            }
+        }
+        if (headerEnd >= 0 && contentLength >= 0 &&
+            (int)raw.length() >= headerEnd + 4 + contentLength) {
+            break;
+        }
+    }
+    _client->stop();
+
+    if (headerEnd < 0 || !raw.startsWith("HTTP/1.")) {
+        return HTTPC_ERROR_NO_HTTP_SERVER;
+    }
+
+    int statusCode = raw.substring(9, 12).toInt();
+    if (statusCode <= 0) return HTTPC_ERROR_NO_HTTP_SERVER;
+
+    // Parse response headers
+    int lineStart = raw.indexOf("\r\n") + 2;
+    while (lineStart < headerEnd) {
+        int lineEnd = raw.indexOf("\r\n", lineStart);
+        String line = raw.substring(lineStart, lineEnd);
+        int colon = line.indexOf(':');
+        if (colon > 0) {
+            String value = line.substring(colon + 1);
+            while (value.length() > 0 && value[0] == ' ') value = value.substring(1);
+            _responseHeaders.push_back({line.substring(0, colon), value});
+        }
+        lineStart = lineEnd + 2;
+    }
+
+    _responseBody = raw.substring(headerEnd + 4);
+    if (contentLength >= 0 && (int)_responseBody.length() > contentLength) {
+        _responseBody = _responseBody.substring(0, contentLength);
+    }
+    _responseSize = contentLength;
+    return statusCode;
+}
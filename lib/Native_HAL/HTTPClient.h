@@ -0,0 +1,92 @@
+#ifndef HTTPCLIENT_H
+#define HTTPCLIENT_H
+
+#include <vector>
+#include "Arduino.h"
+#include "WiFiClient.h"
+
+// Error codes, same values as the ESP32 HTTPClient
+#define HTTPC_ERROR_CONNECTION_REFUSED  (-1)
+#define HTTPC_ERROR_SEND_HEADER_FAILED  (-2)
+#define HTTPC_ERROR_SEND_PAYLOAD_FAILED (-3)
+#define HTTPC_ERROR_NOT_CONNECTED       (-4)
+#define HTTPC_ERROR_CONNECTION_LOST     (-5)
+#define HTTPC_ERROR_NO_STREAM           (-6)
+#define HTTPC_ERROR_NO_HTTP_SERVER      (-7)
+#define HTTPC_ERROR_TOO_LESS_RAM        (-8)
+#define HTTPC_ERROR_ENCODING            (-9)
+#define HTTPC_ERROR_STREAM_WRITE        (-10)
+#define HTTPC_ERROR_READ_TIMEOUT        (-11)
+
+#define HTTPCLIENT_DEFAULT_TCP_TIMEOUT 5000
+
+// Request handed to an in-process transport (see HTTPClient::hostSetTransport)
+struct HostHTTPRequest {
+    const char* method;
+    String host;
+    uint16_t port;
+    String path;
+    String body;
+    unsigned long connectTimeoutMs;
+    unsigned long timeoutMs;
+};
+
+struct HostHTTPResponse {
+    String body;
+    String contentType;
+};
+
+// Returns an HTTP status code or one of the HTTPC_ERROR_* codes
+typedef int (*HostHTTPTransport)(const HostHTTPRequest& request, HostHTTPResponse& response);
+
+// Host stand-in for the ESP32 HTTPClient, speaking plain HTTP/1.1 over a
+// WiFiClient. One request per connection (Connection: close); a client
+// passed to begin() that is already connected is used as is.
+class HTTPClient {
+private:
+    struct Header {
+        String name;
+        String value;
+    };
+
+    String _host;
+    uint16_t _port;
+    String _path;
+    std::vector<Header> _requestHeaders;
+    std::vector<Header> _responseHeaders;
+    String _responseBody;
+    int _responseSize;
+    unsigned long _connectTimeout;
+    unsigned long _timeout;
+    WiFiClient _ownClient;
+    WiFiClient* _client;
+
+    int sendRequest(const char* method, const String& payload);
+
+public:
+    HTTPClient();
+
+    bool begin(const String& url);
+    bool begin(WiFiClient& client, const String& url);
+    void end();
+    void addHeader(const String& name, const String& value);
+    void setTimeout(uint16_t timeout);
+    void setConnectTimeout(int32_t connectTimeout);
+
+    int GET();
+    int PUT(const String& payload);
+    int POST(const String& payload);
+
+    String getString();
+    int getSize();
+    String header(const char* name);
+
+    // Host-side redirection, see WiFiClient::hostAddRemap
+    static void hostAddRemap(const char* host, const char* target) { WiFiClient::hostAddRemap(host, target); }
+
+    // Host-side replacement of the socket transport, e.g. an in-process
+    // Mezzo simulator running on virtual time. nullptr restores sockets.
+    static void hostSetTransport(HostHTTPTransport transport);
+};
+
+#endif // HTTPCLIENT_H
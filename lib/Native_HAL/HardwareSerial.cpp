@@ -0,0 +1,162 @@
+#include "HardwareSerial.h"
+#include "Native_Clock.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+
+// ESP32 UART driver default RX buffer size
+#define HOST_UART_RX_BUFFER_SIZE 256
+
+HardwareSerial Serial(0);
+
+// Constructor
+HardwareSerial::HardwareSerial(int uartNum)
+    : _uartNum(uartNum), _baudRate(0), _rxBuffer(HOST_UART_RX_BUFFER_SIZE),
+      _rxHead(0), _rxCount(0), _rxOverruns(0), _rxPeak(0), _txUnflushed(0), _fd(-1), _console(stdout) {
+}
+
+// Initialization
+void HardwareSerial::begin(unsigned long baudRate, uint32_t config, int8_t rxPin, int8_t txPin,
+                           bool invert, unsigned long timeoutMs, uint8_t rxfifoFullThreshold) {
+    (void)config; (void)rxPin; (void)txPin; (void)invert; (void)timeoutMs; (void)rxfifoFullThreshold;
+    _baudRate = baudRate;
+    _rxHead = 0;
+    _rxCount = 0;
+    if (_uartNum == 0) {
+        setvbuf(stdout, nullptr, _IOLBF, 0); // Console output shows up line by line
+        // Lines typed in the terminal arrive as USB serial input
+        if (_fd < 0 && isatty(STDIN_FILENO)) _fd = STDIN_FILENO;
+        return;
+    }
+
+    char envName[16];
+    snprintf(envName, sizeof(envName), "NATIVE_UART%d", _uartNum);
+    const char* device = getenv(envName);
+    if (device != nullptr && _fd < 0) {
+        _fd = open(device, O_RDWR | O_NOCTTY | O_NONBLOCK);
+        if (_fd < 0) {
+            fprintf(stderr, "HardwareSerial(%d): cannot open %s\n", _uartNum, device);
+            return;
+        }
+        struct termios tio;
+        if (tcgetattr(_fd, &tio) == 0) {
+            cfmakeraw(&tio);
+            tcsetattr(_fd, TCSANOW, &tio);
+        }
+    }
+}
+
+void HardwareSerial::end() {
+    _baudRate = 0;
+    if (_fd > STDIN_FILENO) {
+        close(_fd);
+        _fd = -1;
+    }
+}
+
+size_t HardwareSerial::setRxBufferSize(size_t size) {
+    if (size == 0) return 0;
+    _rxBuffer.assign(size, 0);
+    _rxHead = 0;
+    _rxCount = 0;
+    return size;
+}
+
+void HardwareSerial::updateBaudRate(unsigned long baudRate) {
+    _baudRate = baudRate;
+}
+
+// Move whatever the attached tty has into the RX ring
+void HardwareSerial::pumpDevice() {
+    if (_fd < 0) return;
+    uint8_t buf[256];
+    while (_rxCount < _rxBuffer.size()) {
+        struct pollfd pfd = {_fd, POLLIN, 0};
+        if (poll(&pfd, 1, 0) <= 0) break;
+        size_t space = _rxBuffer.size() - _rxCount;
+        ssize_t n = ::read(_fd, buf, space < sizeof(buf) ? space : sizeof(buf));
+        if (n <= 0) break;
+        hostInjectRx(buf, (size_t)n);
+    }
+}
+
+// Stream interface
+int HardwareSerial::available() {
+    pumpDevice();
+    return (int)_rxCount;
+}
+
+int HardwareSerial::read() {
+    if (_rxCount == 0) pumpDevice();
+    if (_rxCount == 0) return -1;
+    uint8_t c = _rxBuffer[_rxHead];
+    _rxHead = (_rxHead + 1) % _rxBuffer.size();
+    _rxCount--;
+    return c;
+}
+
+int HardwareSerial::peek() {
+    if (_rxCount == 0) pumpDevice();
+    if (_rxCount == 0) return -1;
+    return _rxBuffer[_rxHead];
+}
+
+void HardwareSerial::flush() {
+    if (_uartNum == 0 && _console) fflush(_console);
+    if (_uartNum != 0 && _baudRate > 0 && _txUnflushed > 0) {
+        uint64_t wireUs = (uint64_t)_txUnflushed * 10 * 1000000 / _baudRate;
+        _txUnflushed = 0;
+        hostAdvanceTime(wireUs);
+    }
+}
+
+size_t HardwareSerial::write(uint8_t c) {
+    return write(&c, 1);
+}
+
+size_t HardwareSerial::write(const uint8_t* buffer, size_t size) {
+    if (_uartNum == 0) {
+        return _console ? fwrite(buffer, 1, size, _console) : size;
+    }
+    _txUnflushed += size;
+    if (_fd >= 0) {
+        size_t written = 0;
+        while (written < size) {
+            ssize_t n = ::write(_fd, buffer + written, size - written);
+            if (n < 0 && errno == EAGAIN) continue; // Blocking TX, like a full UART FIFO
+            if (n <= 0) break;
+            written += n;
+        }
+        return written;
+    }
+    _txBuffer.insert(_txBuffer.end(), buffer, buffer + size);
+    return size;
+}
+
+// Host-side access to the simulated wire
+size_t HardwareSerial::hostInjectRx(const uint8_t* data, size_t length) {
+    size_t accepted = 0;
+    for (size_t i = 0; i < length; i++) {
+        if (_rxCount == _rxBuffer.size()) {
+            // Driver buffer full: the byte is lost, as on the real UART
+            _rxOverruns++;
+            continue;
+        }
+        _rxBuffer[(_rxHead + _rxCount) % _rxBuffer.size()] = data[i];
+        _rxCount++;
+        accepted++;
+    }
+    if (_rxCount > _rxPeak) _rxPeak = _rxCount;
+    return accepted;
+}
+
+size_t HardwareSerial::hostTakeTx(std::vector<uint8_t>& out) {
+    size_t n = _txBuffer.size();
+    out.insert(out.end(), _txBuffer.begin(), _txBuffer.end());
+    _txBuffer.clear();
+    return n;
+}
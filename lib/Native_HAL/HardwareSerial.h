@@ -0,0 +1,67 @@
+#ifndef HARDWARESERIAL_H
+#define HARDWARESERIAL_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <vector>
+#include "Print.h"
+
+#define SERIAL_8N1 0x800001c
+
+// Host stand-in for the ESP32 HardwareSerial class.
+// UART 0 is the console and maps to stdout. UART n is attached to the tty
+// named by NATIVE_UART<n> (e.g. the DMT emulator's pty) when set, otherwise it
+// is an in-memory port whose RX side is fed and TX side drained by host code.
+// Writes are instant; flush() waits the wire time of what was written since
+// the last flush (10 bits per byte), so rate changes show up in timings.
+class HardwareSerial : public Stream {
+private:
+    int _uartNum;
+    unsigned long _baudRate;
+    std::vector<uint8_t> _rxBuffer;    // RX ring, same bound as the UART driver buffer
+    size_t _rxHead;
+    size_t _rxCount;
+    unsigned long _rxOverruns;
+    size_t _rxPeak;                    // Most bytes ever waiting in the RX ring
+    std::vector<uint8_t> _txBuffer;
+    size_t _txUnflushed;               // Bytes written since the last flush()
+    int _fd;                           // Attached tty, or -1
+    FILE* _console;                    // UART 0 output stream, nullptr discards
+
+    void pumpDevice();
+
+public:
+    // Constructor
+    HardwareSerial(int uartNum);
+
+    // Initialization
+    void begin(unsigned long baudRate, uint32_t config = SERIAL_8N1,
+               int8_t rxPin = -1, int8_t txPin = -1, bool invert = false,
+               unsigned long timeoutMs = 20000UL, uint8_t rxfifoFullThreshold = 112);
+    void end();
+    size_t setRxBufferSize(size_t size);
+    void updateBaudRate(unsigned long baudRate);
+    unsigned long baudRate() const { return _baudRate; }
+
+    // Stream interface
+    int available() override;
+    int read() override;
+    int peek() override;
+    void flush() override;
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t* buffer, size_t size) override;
+    using Print::write;
+    operator bool() const { return true; }
+
+    // Host-side access to the simulated wire
+    size_t hostInjectRx(const uint8_t* data, size_t length);
+    size_t hostTakeTx(std::vector<uint8_t>& out);
+    unsigned long hostRxOverruns() const { return _rxOverruns; }
+    size_t hostRxPeak() const { return _rxPeak; }
+    void hostSetConsole(FILE* stream) { _console = stream; }
+};
+
+extern HardwareSerial Serial;
+
+#endif // HARDWARESERIAL_H
@@ -0,0 +1,31 @@
+#ifndef IPADDRESS_H
+#define IPADDRESS_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include "Print.h"
+#include "WString.h"
+
+// Host stand-in for the Arduino IPAddress class (IPv4 only)
+class IPAddress : public Printable {
+private:
+    uint8_t _octets[4];
+
+public:
+    IPAddress() : _octets{0, 0, 0, 0} {}
+    IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d) : _octets{a, b, c, d} {}
+
+    uint8_t operator[](int index) const { return _octets[index & 3]; }
+
+    String toString() const {
+        char buf[16];
+        snprintf(buf, sizeof(buf), "%u.%u.%u.%u", _octets[0], _octets[1], _octets[2], _octets[3]);
+        return String(buf);
+    }
+
+    size_t printTo(Print& p) const override {
+        return p.print(toString());
+    }
+};
+
+#endif // IPADDRESS_H
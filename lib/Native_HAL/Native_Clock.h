@@ -0,0 +1,20 @@
+#ifndef NATIVE_CLOCK_H
+#define NATIVE_CLOCK_H
+
+#include <stdint.h>
+
+// Time base behind millis()/micros()/delay() on the host.
+// Real time by default. In virtual mode time only moves when delay(), a
+// simulated network call or the harness advances it, so an hour of firmware
+// operation can run in seconds.
+
+void hostUseVirtualTime(bool enable);
+bool hostIsVirtualTime();
+uint64_t hostMicros64();
+
+// Advance virtual time; the hook sees every step of at most 1 ms so
+// simulated peripherals can deliver data while the firmware is blocked.
+void hostAdvanceTime(uint64_t us);
+void hostSetTimeHook(void (*hook)(uint64_t nowUs));
+
+#endif // NATIVE_CLOCK_H
@@ -0,0 +1,102 @@
+#include "Print.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+size_t Print::write(const uint8_t* buffer, size_t size) {
+    size_t n = 0;
+    while (size--) {
+        n += write(*buffer++);
+    }
+    return n;
+}
+
+size_t Print::write(const char* str) {
+    if (str == nullptr) return 0;
+    return write((const uint8_t*)str, strlen(str));
+}
+
+// Print functions
+size_t Print::print(const char* str) {
+    return write(str);
+}
+
+size_t Print::print(const String& str) {
+    return write((const uint8_t*)str.c_str(), str.length());
+}
+
+size_t Print::print(char c) {
+    return write((uint8_t)c);
+}
+
+size_t Print::print(int value, int base) {
+    return print(String(value, (unsigned char)base));
+}
+
+size_t Print::print(unsigned int value, int base) {
+    return print(String(value, (unsigned char)base));
+}
+
+size_t Print::print(long value, int base) {
+    return print(String(value, (unsigned char)base));
+}
+
+size_t Print::print(unsigned long value, int base) {
+    return print(String(value, (unsigned char)base));
+}
+
+size_t Print::print(double value, int digits) {
+    return print(String(value, (unsigned int)digits));
+}
+
+size_t Print::print(const Printable& printable) {
+    return printable.printTo(*this);
+}
+
+size_t Print::println() {
+    return write((const uint8_t*)"\r\n", 2);
+}
+
+size_t Print::println(const char* str) { return print(str) + println(); }
+size_t Print::println(const String& str) { return print(str) + println(); }
+size_t Print::println(char c) { return print(c) + println(); }
+size_t Print::println(int value, int base) { return print(value, base) + println(); }
+size_t Print::println(unsigned int value, int base) { return print(value, base) + println(); }
+size_t Print::println(long value, int base) { return print(value, base) + println(); }
+size_t Print::println(unsigned long value, int base) { return print(value, base) + println(); }
+size_t Print::println(double value, int digits) { return print(value, digits) + println(); }
+size_t Print::println(const Printable& printable) { return print(printable) + println(); }
+
+// Same as the ESP32 core: a 64-byte stack buffer, then a heap buffer for longer lines
+size_t Print::printf(const char* format, ...) {
+    char stackBuffer[64];
+    va_list args;
+    va_start(args, format);
+    int len = vsnprintf(stackBuffer, sizeof(stackBuffer), format, args);
+    va_end(args);
+    if (len < 0) return 0;
+
+    if ((size_t)len < sizeof(stackBuffer)) {
+        return write((const uint8_t*)stackBuffer, len);
+    }
+
+    char* heapBuffer = (char*)malloc(len + 1);
+    if (heapBuffer == nullptr) return 0;
+    va_start(args, format);
+    vsnprintf(heapBuffer, len + 1, format, args);
+    va_end(args);
+    size_t n = write((const uint8_t*)heapBuffer, len);
+    free(heapBuffer);
+    return n;
+}
+
+size_t Stream::readBytes(uint8_t* buffer, size_t length) {
+    size_t count = 0;
+    while (count < length) {
+        int c = read();
+        if (c < 0) break;
+        buffer[count++] = (uint8_t)c;
+    }
+    return count;
+}
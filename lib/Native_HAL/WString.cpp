@@ -0,0 +1,106 @@
+#include "WString.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// Number formatting helper shared by the integer constructors
+static std::string formatInteger(unsigned long long magnitude, bool negative, unsigned char base) {
+    if (base < 2 || base > 36) base = 10;
+    char digits[72];
+    int pos = sizeof(digits) - 1;
+    digits[pos] = '\0';
+    do {
+        int d = (int)(magnitude % base);
+        digits[--pos] = (char)(d < 10 ? '0' + d : 'a' + d - 10);
+        magnitude /= base;
+    } while (magnitude > 0 && pos > 1);
+    if (negative) digits[--pos] = '-';
+    return std::string(&digits[pos]);
+}
+
+// Constructors
+String::String(int value, unsigned char base)
+    : _buffer(base == 10 ? formatInteger(value < 0 ? -(long long)value : value, value < 0, base)
+                         : formatInteger((unsigned int)value, false, base)) {
+}
+
+String::String(unsigned int value, unsigned char base)
+    : _buffer(formatInteger(value, false, base)) {
+}
+
+String::String(long value, unsigned char base)
+    : _buffer(base == 10 ? formatInteger(value < 0 ? -(long long)value : value, value < 0, base)
+                         : formatInteger((unsigned long)value, false, base)) {
+}
+
+String::String(unsigned long value, unsigned char base)
+    : _buffer(formatInteger(value, false, base)) {
+}
+
+String::String(float value, unsigned int decimalPlaces)
+    : String((double)value, decimalPlaces) {
+}
+
+String::String(double value, unsigned int decimalPlaces) {
+    char buf[64];
+    snprintf(buf, sizeof(buf), "%.*f", (int)decimalPlaces, value);
+    _buffer = buf;
+}
+
+// Search and substrings
+String String::substring(unsigned int beginIndex) const {
+    return substring(beginIndex, length());
+}
+
+String String::substring(unsigned int beginIndex, unsigned int endIndex) const {
+    if (beginIndex > endIndex) {
+        unsigned int tmp = beginIndex;
+        beginIndex = endIndex;
+        endIndex = tmp;
+    }
+    if (beginIndex >= _buffer.length()) return String();
+    if (endIndex > _buffer.length()) endIndex = _buffer.length();
+    return String(_buffer.substr(beginIndex, endIndex - beginIndex));
+}
+
+int String::indexOf(char c, unsigned int fromIndex) const {
+    size_t pos = _buffer.find(c, fromIndex);
+    return pos == std::string::npos ? -1 : (int)pos;
+}
+
+int String::indexOf(const char* str, unsigned int fromIndex) const {
+    size_t pos = _buffer.find(str ? str : "", fromIndex);
+    return pos == std::string::npos ? -1 : (int)pos;
+}
+
+bool String::startsWith(const char* prefix) const {
+    if (prefix == nullptr) return false;
+    return _buffer.compare(0, strlen(prefix), prefix) == 0;
+}
+
+int String::toInt() const {
+    return atoi(_buffer.c_str());
+}
+
+float String::toFloat() const {
+    return (float)atof(_buffer.c_str());
+}
+
+// Concatenation
+String operator+(const String& lhs, const String& rhs) {
+    String result(lhs);
+    result += rhs;
+    return result;
+}
+
+String operator+(const String& lhs, const char* rhs) {
+    String result(lhs);
+    result += rhs;
+    return result;
+}
+
+String operator+(const char* lhs, const String& rhs) {
+    String result(lhs);
+    result += rhs;
+    return result;
+}
@@ -0,0 +1,62 @@
+#ifndef WSTRING_H
+#define WSTRING_H
+
+#include <string>
+#include <stddef.h>
+
+// Host stand-in for the Arduino String class (subset used by the firmware)
+class String {
+private:
+    std::string _buffer;
+
+public:
+    // Constructors
+    String() = default;
+    String(const char* cstr) : _buffer(cstr ? cstr : "") {}
+    String(const std::string& str) : _buffer(str) {}
+    String(char c) : _buffer(1, c) {}
+    explicit String(int value, unsigned char base = 10);
+    explicit String(unsigned int value, unsigned char base = 10);
+    explicit String(long value, unsigned char base = 10);
+    explicit String(unsigned long value, unsigned char base = 10);
+    explicit String(float value, unsigned int decimalPlaces = 2);
+    explicit String(double value, unsigned int decimalPlaces = 2);
+
+    // Access
+    const char* c_str() const { return _buffer.c_str(); }
+    unsigned int length() const { return (unsigned int)_buffer.length(); }
+    char charAt(unsigned int index) const { return index < _buffer.length() ? _buffer[index] : 0; }
+    char operator[](unsigned int index) const { return charAt(index); }
+    bool isEmpty() const { return _buffer.empty(); }
+    bool reserve(unsigned int size) { _buffer.reserve(size); return true; }
+
+    // Modification
+    String& operator+=(const String& rhs) { _buffer += rhs._buffer; return *this; }
+    String& operator+=(const char* rhs) { if (rhs) _buffer += rhs; return *this; }
+    String& operator+=(char c) { _buffer += c; return *this; }
+    bool concat(const char* cstr) { if (cstr) _buffer += cstr; return true; }
+    bool concat(const char* cstr, unsigned int length) { _buffer.append(cstr, length); return true; }
+    void clear() { _buffer.clear(); }
+
+    // Search and substrings
+    String substring(unsigned int beginIndex) const;
+    String substring(unsigned int beginIndex, unsigned int endIndex) const;
+    int indexOf(char c, unsigned int fromIndex = 0) const;
+    int indexOf(const char* str, unsigned int fromIndex = 0) const;
+    bool startsWith(const char* prefix) const;
+    int toInt() const;
+    float toFloat() const;
+
+    // Comparison
+    bool equals(const char* cstr) const { return _buffer == (cstr ? cstr : ""); }
+    bool operator==(const String& rhs) const { return _buffer == rhs._buffer; }
+    bool operator==(const char* rhs) const { return equals(rhs); }
+    bool operator!=(const String& rhs) const { return !(*this == rhs); }
+    bool operator!=(const char* rhs) const { return !equals(rhs); }
+};
+
+String operator+(const String& lhs, const String& rhs);
+String operator+(const String& lhs, const char* rhs);
+String operator+(const char* lhs, const String& rhs);
+
+#endif // WSTRING_H
@@ -0,0 +1,110 @@
+#include "WiFi.h"
+
+WiFiClass WiFi;
+
+WiFiClass::WiFiClass()
+    : _mode(WIFI_OFF), _status(WL_IDLE_STATUS), _rssi(-55), _linkUp(true), _connecting(false),
+      _visibleSSIDs(nullptr), _numVisibleSSIDs(-1) {
+}
+
+bool WiFiClass::isVisible(const char* ssid) const {
+    if (_numVisibleSSIDs < 0) return true; // No restriction configured
+    for (int i = 0; i < _numVisibleSSIDs; i++) {
+        if (strcmp(_visibleSSIDs[i], ssid) == 0) return true;
+    }
+    return false;
+}
+
+// Station API used by the firmware
+bool WiFiClass::mode(wifi_mode_t mode) {
+    _mode = mode;
+    return true;
+}
+
+wl_status_t WiFiClass::begin(const char* ssid, const char* passphrase) {
+    (void)passphrase;
+    _ssid = ssid ? ssid : "";
+    _connecting = true;
+    _status = WL_DISCONNECTED;
+    return status();
+}
+
+bool WiFiClass::disconnect(bool wifiOff) {
+    if (wifiOff) _mode = WIFI_OFF;
+    _connecting = false;
+    _status = WL_DISCONNECTED;
+    return true;
+}
+
+wl_status_t WiFiClass::status() {
+    if (_connecting && _linkUp) {
+        if (isVisible(_ssid.c_str())) {
+            _status = WL_CONNECTED;
+            _connecting = false;
+        } else {
+            _status = WL_NO_SSID_AVAIL;
+        }
+    }
+    return _status;
+}
+
+IPAddress WiFiClass::localIP() {
+    return _status == WL_CONNECTED ? IPAddress(127, 0, 0, 1) : IPAddress();
+}
+
+String WiFiClass::macAddress() {
+    return String("02:00:00:00:00:01");
+}
+
+uint8_t* WiFiClass::macAddress(uint8_t* mac) {
+    static const uint8_t address[6] = {0x02, 0x00, 0x00, 0x00, 0x00, 0x01};
+    memcpy(mac, address, sizeof(address));
+    return mac;
+}
+
+String WiFiClass::SSID() {
+    return _status == WL_CONNECTED ? _ssid : String();
+}
+
+int8_t WiFiClass::RSSI() {
+    return _status == WL_CONNECTED ? (int8_t)_rssi : 0;
+}
+
+// Scan API
+int16_t WiFiClass::scanNetworks() {
+    return _numVisibleSSIDs < 0 ? 0 : (int16_t)_numVisibleSSIDs;
+}
+
+String WiFiClass::SSID(uint8_t networkItem) {
+    if (_numVisibleSSIDs < 0 || networkItem >= _numVisibleSSIDs) return String();
+    return String(_visibleSSIDs[networkItem]);
+}
+
+int32_t WiFiClass::RSSI(uint8_t networkItem) {
+    (void)networkItem;
+    return _rssi;
+}
+
+wifi_auth_mode_t WiFiClass::encryptionType(uint8_t networkItem) {
+    (void)networkItem;
+    return WIFI_AUTH_WPA2_PSK;
+}
+
+// Host-side controls
+void WiFiClass::hostSetLinkUp(bool up) {
+    _linkUp = up;
+    if (!up && _status == WL_CONNECTED) {
+        // The station drops and keeps retrying in the background
+        _status = WL_CONNECTION_LOST;
+        _connecting = true;
+    }
+}
+
+void WiFiClass::hostSetRSSI(int rssi) {
+    _rssi = rssi;
+}
+
+void WiFiClass::hostSetVisibleNetworks(const char* const* ssids, int numSSIDs) {
+    _visibleSSIDs = ssids;
+    _numVisibleSSIDs = ssids ? numSSIDs : -1;
+}
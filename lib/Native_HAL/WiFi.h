@@ -0,0 +1,82 @@
+#ifndef WIFI_H
+#define WIFI_H
+
+#include <stdint.h>
+#include "Arduino.h"
+#include "IPAddress.h"
+#include "WiFiClient.h"
+#include "WiFiServer.h"
+#include "WiFiUdp.h"
+
+typedef enum {
+    WL_NO_SHIELD = 255,
+    WL_IDLE_STATUS = 0,
+    WL_NO_SSID_AVAIL = 1,
+    WL_SCAN_COMPLETED = 2,
+    WL_CONNECTED = 3,
+    WL_CONNECT_FAILED = 4,
+    WL_CONNECTION_LOST = 5,
+    WL_DISCONNECTED = 6
+} wl_status_t;
+
+typedef enum {
+    WIFI_OFF = 0,
+    WIFI_STA = 1,
+    WIFI_AP = 2,
+    WIFI_AP_STA = 3
+} wifi_mode_t;
+
+typedef enum {
+    WIFI_AUTH_OPEN = 0,
+    WIFI_AUTH_WEP,
+    WIFI_AUTH_WPA_PSK,
+    WIFI_AUTH_WPA2_PSK,
+    WIFI_AUTH_WPA_WPA2_PSK
+} wifi_auth_mode_t;
+
+// Host stand-in for the ESP32 WiFi class.
+// The station "connects" to any SSID unless the host has marked the link down
+// or restricted the set of visible networks. As on the device, a begin() that
+// cannot complete keeps trying and succeeds once the link comes back.
+class WiFiClass {
+private:
+    wifi_mode_t _mode;
+    wl_status_t _status;
+    String _ssid;
+    int _rssi;
+    bool _linkUp;
+    bool _connecting;
+    const char* const* _visibleSSIDs;
+    int _numVisibleSSIDs;
+
+    bool isVisible(const char* ssid) const;
+
+public:
+    WiFiClass();
+
+    // Station API used by the firmware
+    bool mode(wifi_mode_t mode);
+    wl_status_t begin(const char* ssid, const char* passphrase = nullptr);
+    bool disconnect(bool wifiOff = false);
+    wl_status_t status();
+    IPAddress localIP();
+    String macAddress();
+    uint8_t* macAddress(uint8_t* mac);
+    String SSID();
+    int8_t RSSI();
+
+    // Scan API
+    int16_t scanNetworks();
+    String SSID(uint8_t networkItem);
+    int32_t RSSI(uint8_t networkItem);
+    wifi_auth_mode_t encryptionType(uint8_t networkItem);
+
+    // Host-side controls
+    void hostSetLinkUp(bool up);
+    void hostSetRSSI(int rssi);
+    void hostSetVisibleNetworks(const char* const* ssids, int numSSIDs);
+};
+
+extern WiFiClass WiFi;
+
+#endif // WIFI_H
@@ -0,0 +1,221 @@
+#include "WiFiClient.h"
+#include "WiFi.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <vector>
+
+#define HOST_DEFAULT_CONNECT_TIMEOUT 3000
+
+struct HostRemap {
+    String from;
+    String target;
+};
+
+static std::vector<HostRemap> hostRemaps;
+static bool remapsLoaded = false;
+static HostConnectHook connectHook = nullptr;
+
+static void loadRemapsFromEnvironment() {
+    remapsLoaded = true;
+    const char* env = getenv("NATIVE_HTTP_REMAP");
+    if (env == nullptr) return;
+
+    String spec(env);
+    unsigned int start = 0;
+    while (start < spec.length()) {
+        int comma = spec.indexOf(',', start);
+        String entry = spec.substring(start, comma < 0 ? spec.length() : comma);
+        int eq = entry.indexOf('=');
+        if (eq > 0) {
+            hostRemaps.push_back({entry.substring(0, eq), entry.substring(eq + 1)});
+        }
+        if (comma < 0) break;
+        start = comma + 1;
+    }
+}
+
+void WiFiClient::hostAddRemap(const char* host, const char* target) {
+    if (!remapsLoaded) loadRemapsFromEnvironment();
+    hostRemaps.push_back({String(host), String(target)});
+}
+
+// "host:port" entries win over plain "host" entries
+void WiFiClient::hostResolve(String& host, uint16_t& port) {
+    if (!remapsLoaded) loadRemapsFromEnvironment();
+    String hostPort = host + ":" + String((unsigned int)port);
+    const HostRemap* match = nullptr;
+    for (size_t i = 0; i < hostRemaps.size(); i++) {
+        if (hostRemaps[i].from == hostPort) {
+            match = &hostRemaps[i];
+            break;
+        }
+        if (match == nullptr && hostRemaps[i].from == host) match = &hostRemaps[i];
+    }
+    if (match == nullptr) return;
+
+    int colon = match->target.indexOf(':');
+    if (colon >= 0) {
+        host = match->target.substring(0, colon);
+        port = (uint16_t)match->target.substring(colon + 1).toInt();
+    } else {
+        host = match->target;
+    }
+}
+
+void WiFiClient::hostSetConnectHook(HostConnectHook hook) {
+    connectHook = hook;
+}
+
+WiFiClient::Socket::~Socket() {
+    if (fd >= 0) close(fd);
+}
+
+WiFiClient::WiFiClient() : _peeked(-1) {
+}
+
+WiFiClient::WiFiClient(int fd) : _socket(new Socket{fd, false}), _peeked(-1) {
+}
+
+// Connection
+int WiFiClient::connect(IPAddress ip, uint16_t port) {
+    return connect(ip, port, HOST_DEFAULT_CONNECT_TIMEOUT);
+}
+
+int WiFiClient::connect(IPAddress ip, uint16_t port, int32_t timeoutMs) {
+    char host[16];
+    snprintf(host, sizeof(host), "%u.%u.%u.%u", ip[0], ip[1], ip[2], ip[3]);
+    return connect(host, port, timeoutMs);
+}
+
+int WiFiClient::connect(const char* host, uint16_t port) {
+    return connect(host, port, HOST_DEFAULT_CONNECT_TIMEOUT);
+}
+
+int WiFiClient::connect(const char* host, uint16_t port, int32_t timeoutMs) {
+    stop();
+    // No network without an associated station, same as on the device
+    if (WiFi.status() != WL_CONNECTED) return 0;
+
+    if (connectHook) {
+        int hooked = connectHook(host, port, timeoutMs);
+        if (hooked >= 0) {
+            if (hooked > 0) _socket.reset(new Socket{-1, true});
+            return hooked;
+        }
+    }
+
+    String target(host);
+    hostResolve(target, port);
+
+    struct addrinfo hints;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    struct addrinfo* result = nullptr;
+    char portStr[8];
+    snprintf(portStr, sizeof(portStr), "%u", port);
+    if (getaddrinfo(target.c_str(), portStr, &hints, &result) != 0 || result == nullptr) {
+        return 0;
+    }
+
+    int fd = socket(result->ai_family, result->ai_socktype, result->ai_protocol);
+    if (fd < 0) {
+        freeaddrinfo(result);
+        return 0;
+    }
+
+    // Non-blocking connect so the timeout is honoured
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+    int rc = ::connect(fd, result->ai_addr, result->ai_addrlen);
+    freeaddrinfo(result);
+    if (rc < 0 && errno != EINPROGRESS) {
+        close(fd);
+        return 0;
+    }
+    if (rc < 0) {
+        struct pollfd pfd = {fd, POLLOUT, 0};
+        int err = 0;
+        socklen_t errLen = sizeof(err);
+        if (poll(&pfd, 1, (int)timeoutMs) <= 0 ||
+            getsockopt(fd, SOL_SOCKET, SO_ERROR, &err, &errLen) < 0 || err != 0) {
+            close(fd);
+            return 0;
+        }
+    }
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) & ~O_NONBLOCK);
+    _socket.reset(new Socket{fd, false});
+    return 1;
+}
+
+void WiFiClient::stop() {
+    _socket.reset();
+    _peeked = -1;
+}
+
+uint8_t WiFiClient::connected() {
+    if (!_socket) return 0;
+    if (_socket->simulated) return 1;
+    if (_peeked >= 0) return 1;
+
+    // A readable socket with nothing to read has been closed by the peer
+    struct pollfd pfd = {_socket->fd, POLLIN, 0};
+    if (poll(&pfd, 1, 0) > 0) {
+        uint8_t c;
+        if (recv(_socket->fd, &c, 1, MSG_PEEK | MSG_DONTWAIT) <= 0) return 0;
+    }
+    return 1;
+}
+
+// Stream interface
+int WiFiClient::available() {
+    if (fd() < 0) return 0;
+    int pending = 0;
+    if (ioctl(_socket->fd, FIONREAD, &pending) < 0) pending = 0;
+    return pending + (_peeked >= 0 ? 1 : 0);
+}
+
+int WiFiClient::read() {
+    uint8_t c;
+    return read(&c, 1) == 1 ? c : -1;
+}
+
+int WiFiClient::read(uint8_t* buffer, size_t size) {
+    if (size == 0) return 0;
+    size_t got = 0;
+    if (_peeked >= 0) {
+        buffer[got++] = (uint8_t)_peeked;
+        _peeked = -1;
+    }
+    if (fd() < 0 || got == size) return got > 0 ? (int)got : -1;
+    ssize_t n = recv(_socket->fd, buffer + got, size - got, MSG_DONTWAIT);
+    if (n > 0) got += (size_t)n;
+    return got > 0 ? (int)got : -1;
+}
+
+int WiFiClient::peek() {
+    if (_peeked < 0) {
+        uint8_t c;
+        if (fd() >= 0 && recv(_socket->fd, &c, 1, MSG_DONTWAIT) == 1) _peeked = c;
+    }
+    return _peeked;
+}
+
+size_t WiFiClient::write(uint8_t c) {
+    return write(&c, 1);
+}
+
+size_t WiFiClient::write(const uint8_t* buffer, size_t size) {
+    if (fd() < 0) return 0;
+    size_t written = 0;
+    while (written < size) {
+        ssize_t n = send(_socket->fd, buffer + written, size - written, MSG_NOSIGNAL);
+        if (n <= 0) break;
+        written += (size_t)n;
+    }
+    return written;
+}
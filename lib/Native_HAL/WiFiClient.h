@@ -0,0 +1,59 @@
+#ifndef WIFICLIENT_H
+#define WIFICLIENT_H
+
+#include <stdint.h>
+#include <memory>
+#include "Arduino.h"
+#include "IPAddress.h"
+
+// Host replacement for connect(): 1 = connected (simulated, no socket),
+// 0 = failed, -1 = fall through to a real socket
+typedef int (*HostConnectHook)(const char* host, uint16_t port, int32_t timeoutMs);
+
+// Host stand-in for the ESP32 WiFiClient: a TCP socket. Copies share the
+// connection, as on the device.
+class WiFiClient : public Stream {
+private:
+    struct Socket {
+        int fd;
+        bool simulated;
+        ~Socket();
+    };
+    std::shared_ptr<Socket> _socket;
+    int _peeked;
+
+public:
+    WiFiClient();
+    explicit WiFiClient(int fd);
+
+    // Connection
+    int connect(IPAddress ip, uint16_t port);
+    int connect(IPAddress ip, uint16_t port, int32_t timeoutMs);
+    int connect(const char* host, uint16_t port);
+    int connect(const char* host, uint16_t port, int32_t timeoutMs);
+    void stop();
+    uint8_t connected();
+    operator bool() { return connected(); }
+
+    // Stream interface
+    int available() override;
+    int read() override;
+    int read(uint8_t* buffer, size_t size);
+    int peek() override;
+    void flush() override {}
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t* buffer, size_t size) override;
+    using Print::write;
+
+    // Host-side access
+    int fd() const { return _socket ? _socket->fd : -1; }
+    bool hostIsSimulated() const { return _socket && _socket->simulated; }
+    static void hostSetConnectHook(HostConnectHook hook);
+
+    // Redirect host[:port] to target[:port], e.g. the Mezzo IP to a local
+    // simulator. Also read from NATIVE_HTTP_REMAP="host=target[:port],..."
+    static void hostAddRemap(const char* host, const char* target);
+    static void hostResolve(String& host, uint16_t& port);
+};
+
+#endif // WIFICLIENT_H
@@ -0,0 +1,77 @@
+#include "WiFiServer.h"
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <stdlib.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+static int portOffset = -1;     // -1 until set or read from the environment
+static bool listening = true;
+
+void WiFiServer::hostSetPortOffset(int offset) {
+    portOffset = offset;
+}
+
+void WiFiServer::hostSetListening(bool enabled) {
+    listening = enabled;
+}
+
+bool WiFiServer::hostIsListening() {
+    return listening;
+}
+
+uint16_t WiFiServer::hostMapPort(uint16_t port) {
+    if (portOffset < 0) {
+        const char* env = getenv("NATIVE_SERVER_PORT_OFFSET");
+        portOffset = env ? atoi(env) : 0;
+    }
+    return (uint16_t)(port + portOffset);
+}
+
+WiFiServer::WiFiServer(uint16_t port, uint8_t maxClients) : _port(port), _fd(-1), _noDelay(false) {
+    (void)maxClients;
+}
+
+WiFiServer::~WiFiServer() {
+    end();
+}
+
+void WiFiServer::begin(uint16_t port) {
+    end();
+    if (port != 0) _port = port;
+    if (!listening) return;
+
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) return;
+    int one = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port = htons(hostPort());
+    if (bind(fd, (struct sockaddr*)&addr, sizeof(addr)) < 0 || listen(fd, 4) < 0) {
+        close(fd);
+        return;
+    }
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+    _fd = fd;
+}
+
+void WiFiServer::end() {
+    if (_fd >= 0) close(_fd);
+    _fd = -1;
+}
+
+WiFiClient WiFiServer::available() {
+    if (_fd < 0) return WiFiClient();
+    int fd = ::accept(_fd, nullptr, nullptr);
+    if (fd < 0) return WiFiClient();
+    if (_noDelay) {
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+    }
+    return WiFiClient(fd);
+}
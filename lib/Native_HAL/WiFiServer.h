@@ -0,0 +1,37 @@
+#ifndef WIFISERVER_H
+#define WIFISERVER_H
+
+#include <stdint.h>
+#include "WiFiClient.h"
+
+// Host stand-in for the ESP32 WiFiServer: a non-blocking listening TCP
+// socket. The host port is the device port plus an offset (hostSetPortOffset()
+// or NATIVE_SERVER_PORT_OFFSET), so port 80 needs no privileges; a port that
+// cannot be bound leaves the server without clients. WiFiUDP follows the same
+// offset and listening switch.
+class WiFiServer {
+private:
+    uint16_t _port;
+    int _fd;
+    bool _noDelay;
+
+public:
+    WiFiServer(uint16_t port = 80, uint8_t maxClients = 4);
+    ~WiFiServer();
+
+    void begin(uint16_t port = 0);
+    void end();
+    void setNoDelay(bool noDelay) { _noDelay = noDelay; }
+    WiFiClient available();     // A newly accepted client, or an unconnected one
+    WiFiClient accept() { return available(); }
+    operator bool() const { return _fd >= 0; }
+
+    // Host-side controls
+    static void hostSetPortOffset(int offset);
+    static void hostSetListening(bool listening);   // false: begin() binds nothing
+    static bool hostIsListening();
+    static uint16_t hostMapPort(uint16_t port);
+    uint16_t hostPort() const { return hostMapPort(_port); }
+};
+
+#endif // WIFISERVER_H
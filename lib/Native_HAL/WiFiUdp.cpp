@@ -0,0 +1,170 @@
+#include "WiFiUdp.h"
+#include "WiFi.h"
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+WiFiUDP::WiFiUDP()
+    : _fd(-1), _rxLength(0), _rxOffset(0), _remoteAddr(0), _remotePort(0),
+      _txLength(0), _txAddr(0), _txPort(0) {
+}
+
+WiFiUDP::~WiFiUDP() {
+    stop();
+}
+
+bool WiFiUDP::openSocket() {
+    if (_fd >= 0) return true;
+    _fd = socket(AF_INET, SOCK_DGRAM, 0);
+    if (_fd < 0) return false;
+    fcntl(_fd, F_SETFL, fcntl(_fd, F_GETFL, 0) | O_NONBLOCK);
+    return true;
+}
+
+// Receiving
+uint8_t WiFiUDP::begin(uint16_t port) {
+    stop();
+    if (!WiFiServer::hostIsListening() || !openSocket()) return 0;
+    int one = 1;
+    setsockopt(_fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port = htons(WiFiServer::hostMapPort(port));
+    if (bind(_fd, (struct sockaddr*)&addr, sizeof(addr)) < 0) {
+        stop();
+        return 0;
+    }
+    return 1;
+}
+
+// Several host processes may join the same group and port
+uint8_t WiFiUDP::beginMulticast(IPAddress multicast, uint16_t port) {
+    stop();
+    if (!WiFiServer::hostIsListening() || !openSocket()) return 0;
+    int one = 1;
+    setsockopt(_fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    setsockopt(_fd, SOL_SOCKET, SO_REUSEPORT, &one, sizeof(one));
+
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port = htons(WiFiServer::hostMapPort(port));
+
+    struct ip_mreq membership;
+    uint8_t octets[4] = {multicast[0], multicast[1], multicast[2], multicast[3]};
+    memcpy(&membership.imr_multiaddr.s_addr, octets, 4);
+    membership.imr_interface.s_addr = htonl(INADDR_ANY);
+    unsigned char loop = 1;
+    if (bind(_fd, (struct sockaddr*)&addr, sizeof(addr)) < 0 ||
+        setsockopt(_fd, IPPROTO_IP, IP_ADD_MEMBERSHIP, &membership, sizeof(membership)) < 0) {
+        stop();
+        return 0;
+    }
+    setsockopt(_fd, IPPROTO_IP, IP_MULTICAST_LOOP, &loop, sizeof(loop));
+    return 1;
+}
+
+void WiFiUDP::stop() {
+    if (_fd >= 0) close(_fd);
+    _fd = -1;
+    _rxLength = 0;
+    _rxOffset = 0;
+}
+
+int WiFiUDP::parsePacket() {
+    if (_rxOffset < _rxLength) return 0;
+    _rxLength = 0;
+    _rxOffset = 0;
+    if (_fd < 0) return 0;
+    struct sockaddr_in from;
+    socklen_t fromLength = sizeof(from);
+    ssize_t n = recvfrom(_fd, _rx, sizeof(_rx), MSG_DONTWAIT, (struct sockaddr*)&from, &fromLength);
+    if (n <= 0) return 0;
+    _rxLength = (size_t)n;
+    _remoteAddr = from.sin_addr.s_addr;
+    _remotePort = ntohs(from.sin_port);
+    return (int)n;
+}
+
+IPAddress WiFiUDP::remoteIP() const {
+    const uint8_t* octets = (const uint8_t*)&_remoteAddr;
+    return IPAddress(octets[0], octets[1], octets[2], octets[3]);
+}
+
+// Sending
+int WiFiUDP::beginPacket(IPAddress ip, uint16_t port) {
+    uint8_t octets[4] = {ip[0], ip[1], ip[2], ip[3]};
+    memcpy(&_txAddr, octets, 4);
+    _txPort = port;
+    _txLength = 0;
+    return openSocket() ? 1 : 0;
+}
+
+int WiFiUDP::beginPacket(const char* host, uint16_t port) {
+    struct addrinfo hints;
+    memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_DGRAM;
+    struct addrinfo* result = nullptr;
+    if (getaddrinfo(host, nullptr, &hints, &result) != 0 || result == nullptr) return 0;
+    _txAddr = ((struct sockaddr_in*)result->ai_addr)->sin_addr.s_addr;
+    freeaddrinfo(result);
+    _txPort = port;
+    _txLength = 0;
+    return openSocket() ? 1 : 0;
+}
+
+int WiFiUDP::endPacket() {
+    if (_fd < 0 || WiFi.status() != WL_CONNECTED || !WiFiServer::hostIsListening()) return 0;
+    struct sockaddr_in to;
+    memset(&to, 0, sizeof(to));
+    to.sin_family = AF_INET;
+    to.sin_addr.s_addr = _txAddr;
+    // Group members bound the mapped port; unicast peers are real hosts
+    bool multicast = (((const uint8_t*)&_txAddr)[0] & 0xF0) == 0xE0;
+    to.sin_port = htons(multicast ? WiFiServer::hostMapPort(_txPort) : _txPort);
+    ssize_t n = sendto(_fd, _tx, _txLength, 0, (struct sockaddr*)&to, sizeof(to));
+    _txLength = 0;
+    return n >= 0 ? 1 : 0;
+}
+
+// Stream interface
+int WiFiUDP::read() {
+    return _rxOffset < _rxLength ? _rx[_rxOffset++] : -1;
+}
+
+int WiFiUDP::read(uint8_t* buffer, size_t length) {
+    size_t n = _rxLength - _rxOffset;
+    if (n > length) n = length;
+    memcpy(buffer, _rx + _rxOffset, n);
+    _rxOffset += n;
+    return (int)n;
+}
+
+void WiFiUDP::flush() {
+    _rxLength = 0;
+    _rxOffset = 0;
+}
+
+int WiFiUDP::peek() {
+    return _rxOffset < _rxLength ? _rx[_rxOffset] : -1;
+}
+
+size_t WiFiUDP::write(uint8_t c) {
+    return write(&c, 1);
+}
+
+size_t WiFiUDP::write(const uint8_t* buffer, size_t size) {
+    size_t room = sizeof(_tx) - _txLength;
+    if (size > room) size = room;
+    memcpy(_tx + _txLength, buffer, size);
+    _txLength += size;
+    return size;
+}
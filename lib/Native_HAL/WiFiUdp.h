@@ -0,0 +1,60 @@
+#ifndef WIFIUDP_H
+#define WIFIUDP_H
+
+#include <stdint.h>
+#include "Arduino.h"
+#include "IPAddress.h"
+
+#define HOST_UDP_PACKET_SIZE 1472
+
+// Host stand-in for the ESP32 WiFiUDP: a non-blocking datagram socket.
+// parsePacket() takes one datagram into an internal buffer that read() drains.
+// Like the ESP32 core, it returns 0 while bytes of the previous datagram are
+// unread, until they are read or flush() drops them. beginPacket()/write()/
+// endPacket() send one. Bound ports follow WiFiServer's
+// host port offset, and nothing is bound or sent while it is not listening.
+class WiFiUDP : public Stream {
+private:
+    int _fd;
+    uint8_t _rx[HOST_UDP_PACKET_SIZE];
+    size_t _rxLength;
+    size_t _rxOffset;
+    uint32_t _remoteAddr;       // Network byte order
+    uint16_t _remotePort;
+    uint8_t _tx[HOST_UDP_PACKET_SIZE];
+    size_t _txLength;
+    uint32_t _txAddr;
+    uint16_t _txPort;
+
+    bool openSocket();
+
+public:
+    WiFiUDP();
+    ~WiFiUDP();
+
+    // Receiving
+    uint8_t begin(uint16_t port);
+    uint8_t beginMulticast(IPAddress multicast, uint16_t port);   // Loops back to this host
+    void stop();
+    int parsePacket();          // Size of the next datagram, 0 if none or the last one is unread
+    IPAddress remoteIP() const;
+    uint16_t remotePort() const { return _remotePort; }
+
+    // Sending
+    int beginPacket(IPAddress ip, uint16_t port);
+    int beginPacket(const char* host, uint16_t port);
+    int endPacket();
+
+    // Stream interface
+    int available() override { return (int)(_rxLength - _rxOffset); }
+    int read() override;
+    int read(uint8_t* buffer, size_t length);
+    int read(char* buffer, size_t length) { return read((uint8_t*)buffer, length); }
+    int peek() override;
+    void flush() override;      // Drops the rest of the current datagram
+    size_t write(uint8_t c) override;
+    size_t write(const uint8_t* buffer, size_t size) override;
+    using Print::write;
+};
+
+#endif // WIFIUDP_H
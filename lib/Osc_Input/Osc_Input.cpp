@@ -0,0 +1,145 @@
+#include "Osc_Input.h"
+
+// OSC strings are NUL-terminated and padded to a multiple of 4 bytes;
+// returns the padded length, 0 if the string runs past the end
+static size_t paddedStringLength(const uint8_t* data, const uint8_t* end) {
+    const uint8_t* nul = (const uint8_t*)memchr(data, '\0', end - data);
+    if (nul == nullptr) return 0;
+    size_t length = ((nul - data) / 4 + 1) * 4;
+    return length <= (size_t)(end - data) ? length : 0;
+}
+
+static uint32_t readBigEndian32(const uint8_t* data) {
+    return ((uint32_t)data[0] << 24) | ((uint32_t)data[1] << 16) | ((uint32_t)data[2] << 8) | data[3];
+}
+
+// Constructor
+Osc_Input::Osc_Input(uint16_t port)
+    : _port(port), _zoneCallback(nullptr), _messages(0), _rejected(0) {
+}
+
+void Osc_Input::begin() {
+    _udp.begin(_port);
+}
+
+// Drains a few datagrams per call so a flood cannot hold up loop()
+void Osc_Input::handlePackets() {
+    for (int i = 0; i < OSC_INPUT_MAX_PACKETS; i++) {
+        int size = _udp.parsePacket();
+        if (size <= 0) return;
+        if (size > OSC_INPUT_PACKET_SIZE) {
+            // The ESP32 core holds a datagram until it is read; drop it or
+            // parsePacket() returns 0 from now on
+            _rejected++;
+            _udp.flush();
+            continue;
+        }
+        int length = _udp.read(_packet, size);
+        if (length > 0) dispatchPacket(_packet, length, 0);
+    }
+}
+
+// A message, or a bundle: "#bundle", 8-byte time tag, then size-prefixed elements.
+// Time tags are ignored; every element applies on arrival.
+void Osc_Input::dispatchPacket(const uint8_t* data, size_t length, int depth) {
+    if (length >= 16 && memcmp(data, "#bundle", 8) == 0) {
+        if (depth >= OSC_INPUT_MAX_BUNDLE_DEPTH) {
+            _rejected++;
+            return;
+        }
+        size_t offset = 16;
+        while (offset + 4 <= length) {
+            uint32_t size = readBigEndian32(data + offset);
+            offset += 4;
+            if (size > length - offset || size % 4 != 0) {
+                _rejected++;
+                return;
+            }
+            dispatchPacket(data + offset, size, depth + 1);
+            offset += size;
+        }
+        return;
+    }
+
+    OscMessage message;
+    if (parseMessage(data, length, message) && dispatchMessage(message)) {
+        _messages++;
+    } else {
+        _rejected++;
+    }
+}
+
+// "/zone/<n>/gain" or "/zone/<n>/volume"
+bool Osc_Input::dispatchMessage(const OscMessage& message) {
+    if (_zoneCallback == nullptr || strncmp(message.address, "/zone/", 6) != 0) return false;
+    const char* number = message.address + 6;
+    char* rest;
+    long zoneNumber = strtol(number, &rest, 10);
+    if (rest == number) return false;
+
+    OscZoneParam param;
+    if (strcmp(rest, "/gain") == 0) {
+        param = OSC_ZONE_GAIN;
+    } else if (strcmp(rest, "/volume") == 0) {
+        param = OSC_ZONE_VOLUME;
+    } else {
+        return false;
+    }
+
+    float value;
+    if (!numberArgument(message, value)) return false;
+    return _zoneCallback((int)zoneNumber, param, value);
+}
+
+// Parsing
+bool Osc_Input::parseMessage(const uint8_t* data, size_t length, OscMessage& message) {
+    const uint8_t* end = data + length;
+    if (length < 4 || data[0] != '/' || length % 4 != 0) return false;
+    size_t addressLength = paddedStringLength(data, end);
+    if (addressLength == 0) return false;
+
+    message.address = (const char*)data;
+    message.end = end;
+    const uint8_t* tags = data + addressLength;
+
+    // Very old senders omit the type tag string
+    if (tags == end || *tags != ',') {
+        message.typeTags = "";
+        message.args = tags;
+        return true;
+    }
+    size_t tagsLength = paddedStringLength(tags, end);
+    if (tagsLength == 0) return false;
+    message.typeTags = (const char*)tags + 1;
+    message.args = tags + tagsLength;
+    return true;
+}
+
+// First argument as a float: f (float32), i (int32) or d (float64)
+bool Osc_Input::numberArgument(const OscMessage& message, float& value) {
+    size_t left = message.end - message.args;
+    switch (message.typeTags[0]) {
+        case 'f': {
+            if (left < 4) return false;
+            uint32_t bits = readBigEndian32(message.args);
+            memcpy(&value, &bits, sizeof(value));
+            break;
+        }
+        case 'i': {
+            if (left < 4) return false;
+            value = (float)(int32_t)readBigEndian32(message.args);
+            break;
+        }
+        case 'd': {
+            if (left < 8) return false;
+            uint64_t bits = ((uint64_t)readBigEndian32(message.args) << 32) | readBigEndian32(message.args + 4);
+            double d;
+            memcpy(&d, &bits, sizeof(d));
+            value = (float)d;
+            break;
+        }
+        default:
+            return false;
+    }
+    return value == value;     // NaN is refused
+}
@@ -0,0 +1,68 @@
+#ifndef OSC_INPUT_H
+#define OSC_INPUT_H
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include <WiFiUdp.h>
+
+// Largest datagram taken; bigger ones are dropped and counted as rejected
+#ifndef OSC_INPUT_PACKET_SIZE
+#define OSC_INPUT_PACKET_SIZE 512
+#endif
+
+#define OSC_INPUT_MAX_PACKETS 8        // Datagrams handled per handlePackets() call
+#define OSC_INPUT_MAX_BUNDLE_DEPTH 4
+
+enum OscZoneParam {
+    OSC_ZONE_GAIN = 0,     // /zone/<n>/gain, 0.0-1.0
+    OSC_ZONE_VOLUME        // /zone/<n>/volume, the panel's 0-100 scale
+};
+
+// One OSC message, pointing into the datagram it was parsed from
+struct OscMessage {
+    const char* address;
+    const char* typeTags;  // Tags after the ',' ("" without a type tag string)
+    const uint8_t* args;
+    const uint8_t* end;
+};
+
+// Returns false if the zone or value is refused
+typedef bool (*OscZoneCallback)(int zoneNumber, OscZoneParam param, float value);
+
+// OSC 1.0 over UDP for show control. Messages and bundles are parsed in place
+// in the received datagram; /zone/<n>/gain and /zone/<n>/volume with one
+// f, i or d argument go to the zone callback. Loop context only.
+class Osc_Input {
+private:
+    WiFiUDP _udp;
+    uint16_t _port;
+    uint8_t _packet[OSC_INPUT_PACKET_SIZE];
+    OscZoneCallback _zoneCallback;
+    uint32_t _messages;            // Accepted by the callback
+    uint32_t _rejected;            // Malformed, oversized, unknown or refused
+
+    void dispatchPacket(const uint8_t* data, size_t length, int depth);
+    bool dispatchMessage(const OscMessage& message);
+
+public:
+    // Constructor
+    Osc_Input(uint16_t port = 9000);
+
+    // Configuration
+    void setZoneCallback(OscZoneCallback callback) { _zoneCallback = callback; }
+    void begin();
+
+    // Call from loop()
+    void handlePackets();
+
+    // Parsing, usable on any buffer
+    static bool parseMessage(const uint8_t* data, size_t length, OscMessage& message);
+    static bool numberArgument(const OscMessage& message, float& value);
+
+    // Access
+    uint16_t getPort() const { return _port; }
+    uint32_t getMessages() const { return _messages; }
+    uint32_t getRejected() const { return _rejected; }
+};
+
+#endif // OSC_INPUT_H
@@ -0,0 +1,224 @@
+#include "Panel_Sync.h"
+
+#define PANEL_SYNC_VERSION 3   // Version 2 had no boot id, version 1 carried gain x 10000
+
+static void putBigEndian16(uint8_t* data, uint16_t value) {
+    data[0] = value >> 8;
+    data[1] = value & 0xFF;
+}
+
+static void putBigEndian32(uint8_t* data, uint32_t value) {
+    putBigEndian16(data, value >> 16);
+    putBigEndian16(data + 2, value & 0xFFFF);
+}
+
+static uint16_t getBigEndian16(const uint8_t* data) {
+    return (data[0] << 8) | data[1];
+}
+
+static uint32_t getBigEndian32(const uint8_t* data) {
+    return ((uint32_t)getBigEndian16(data) << 16) | getBigEndian16(data + 2);
+}
+
+// Constructor
+Panel_Sync::Panel_Sync(IPAddress group, uint16_t port)
+    : _group(group), _port(port), _nodeId(0), _bootId(0), _sequence(0), _started(false), _numPeers(0),
+      _numPending(0), _lastHeartbeatMs(0), _lastZonesMs(0), _lastJoinMs(0), _zoneCallback(nullptr),
+      _sent(0), _received(0), _duplicates(0), _rejected(0), _restarts(0) {
+}
+
+void Panel_Sync::begin(uint32_t nodeId) {
+    _nodeId = nodeId;
+    _bootId = esp_random();
+    _sequence = 0;
+    join();
+}
+
+// The group can only be joined on a connected interface
+bool Panel_Sync::join() {
+    _lastJoinMs = millis();
+    if (WiFi.status() == WL_CONNECTED) _started = _udp.beginMulticast(_group, _port) != 0;
+    return _started;
+}
+
+// Loop
+void Panel_Sync::handle() {
+    if (!_started && (millis() - _lastJoinMs < PANEL_SYNC_HEARTBEAT_MS || !join())) return;
+    for (int i = 0; i < PANEL_SYNC_MAX_PACKETS; i++) {
+        int size = _udp.parsePacket();
+        if (size <= 0) break;
+        if (size > PANEL_SYNC_PACKET_SIZE) {
+            _rejected++;
+            _udp.flush();      // Unread, it would block every later datagram on the ESP32
+            continue;
+        }
+        int length = _udp.read(_packet, size);
+        if (length > 0) receivePacket(_packet, length);
+    }
+
+    if (millis() - _lastHeartbeatMs >= PANEL_SYNC_HEARTBEAT_MS) sendHeartbeat();
+    if (_numPending > 0 && millis() - _lastZonesMs >= PANEL_SYNC_ZONE_INTERVAL_MS) sendZones();
+}
+
+void Panel_Sync::publishZone(int zoneNumber, FixedGain gain) {
+    if (!_started) return;
+    PanelSyncEntry entry = {(uint16_t)zoneNumber, gain > GAIN_UNITY ? (FixedGain)GAIN_UNITY : gain};
+    for (int i = 0; i < _numPending; i++) {
+        if (_pending[i].zoneNumber == entry.zoneNumber) {
+            _pending[i] = entry;
+            return;
+        }
+    }
+    if (_numPending == PANEL_SYNC_MAX_ENTRIES) sendZones();
+    _pending[_numPending++] = entry;
+}
+
+// Sending
+void Panel_Sync::sendHeartbeat() {
+    _lastHeartbeatMs = millis();
+    _packet[PANEL_SYNC_HEADER_SIZE] = isLeader() ? 0x01 : 0x00;
+    sendPacket(PANEL_SYNC_HEARTBEAT, 1);
+}
+
+void Panel_Sync::sendZones() {
+    _lastZonesMs = millis();
+    uint8_t* payload = _packet + PANEL_SYNC_HEADER_SIZE;
+    payload[0] = (uint8_t)_numPending;
+    for (int i = 0; i < _numPending; i++) {
+        putBigEndian16(payload + 1 + i * PANEL_SYNC_ENTRY_SIZE, _pending[i].zoneNumber);
+        putBigEndian32(payload + 3 + i * PANEL_SYNC_ENTRY_SIZE, _pending[i].gain);
+    }
+    sendPacket(PANEL_SYNC_ZONES, 1 + _numPending * PANEL_SYNC_ENTRY_SIZE);
+    _numPending = 0;
+}
+
+// The payload is already in place after the header
+bool Panel_Sync::sendPacket(PanelSyncType type, size_t payloadLength) {
+    _packet[0] = 'P';
+    _packet[1] = 'S';
+    _packet[2] = PANEL_SYNC_VERSION;
+    _packet[3] = (uint8_t)type;
+    putBigEndian32(_packet + 4, _nodeId);
+    putBigEndian32(_packet + 8, _bootId);
+    putBigEndian32(_packet + 12, ++_sequence);
+    if (!_udp.beginPacket(_group, _port)) return false;
+    _udp.write(_packet, PANEL_SYNC_HEADER_SIZE + payloadLength);
+    if (!_udp.endPacket()) return false;
+    _sent++;
+    return true;
+}
+
+// Receiving
+void Panel_Sync::receivePacket(const uint8_t* data, size_t length) {
+    if (length < PANEL_SYNC_HEADER_SIZE + 1 || data[0] != 'P' || data[1] != 'S' ||
+        data[2] != PANEL_SYNC_VERSION) {
+        _rejected++;
+        return;
+    }
+    uint32_t nodeId = getBigEndian32(data + 4);
+    uint32_t bootId = getBigEndian32(data + 8);
+    uint32_t sequence = getBigEndian32(data + 12);
+    if (nodeId == _nodeId) return;      // Our own packet, looped back
+
+    PanelSyncPeer* peer = findPeer(nodeId, true);
+    if (peer == nullptr) {
+        _rejected++;
+        return;
+    }
+    // A sender that restarted counts again from 1, whichever packet arrives first
+    if (peer->lastHeardMs != 0 && bootId != peer->bootId) {
+        peer->lastHeardMs = 0;
+        _restarts++;
+    }
+    peer->bootId = bootId;
+    if (peer->lastHeardMs != 0 && (int32_t)(sequence - peer->lastSequence) <= 0) {
+        _duplicates++;
+        return;
+    }
+    if (peer->lastHeardMs != 0 && sequence > peer->lastSequence + 1) {
+        peer->lost += sequence - peer->lastSequence - 1;
+    }
+    peer->lastSequence = sequence;
+    peer->lastHeardMs = millis() | 1;  // Never 0 once heard
+    _received++;
+
+    const uint8_t* payload = data + PANEL_SYNC_HEADER_SIZE;
+    size_t payloadLength = length - PANEL_SYNC_HEADER_SIZE;
+    switch (data[3]) {
+        case PANEL_SYNC_HEARTBEAT:
+            peer->leader = (payload[0] & 0x01) != 0;
+            break;
+        case PANEL_SYNC_ZONES: {
+            size_t count = payload[0];
+            if (payloadLength < 1 + count * PANEL_SYNC_ENTRY_SIZE) {
+                _rejected++;
+                return;
+            }
+            for (size_t i = 0; i < count && _zoneCallback != nullptr; i++) {
+                const uint8_t* entry = payload + 1 + i * PANEL_SYNC_ENTRY_SIZE;
+                uint32_t gain = getBigEndian32(entry + 2);
+                if (gain > GAIN_UNITY) continue;
+                _zoneCallback(getBigEndian16(entry), gain);
+            }
+            break;
+        }
+        default:
+            _rejected++;
+            break;
+    }
+}
+
+PanelSyncPeer* Panel_Sync::findPeer(uint32_t nodeId, bool create) {
+    expirePeers();
+    for (int i = 0; i < _numPeers; i++) {
+        if (_peers[i].nodeId == nodeId) return &_peers[i];
+    }
+    if (!create || _numPeers == PANEL_SYNC_MAX_PEERS) return nullptr;
+    _peers[_numPeers] = {nodeId, 0, 0, 0, 0, false};
+    return &_peers[_numPeers++];
+}
+
+void Panel_Sync::expirePeers() {
+    for (int i = 0; i < _numPeers; ) {
+        // Signed: lastHeardMs is 1 ahead when heard at millis() 0
+        if ((int32_t)(millis() - _peers[i].lastHeardMs) > PANEL_SYNC_PEER_TIMEOUT_MS) {
+            _peers[i] = _peers[--_numPeers];
+        } else {
+            i++;
+        }
+    }
+}
+
+// Access
+bool Panel_Sync::isLeader() {
+    expirePeers();
+    for (int i = 0; i < _numPeers; i++) {
+        if (_peers[i].nodeId < _nodeId) return false;
+    }
+    return true;
+}
+
+int Panel_Sync::getPeerCount() {
+    expirePeers();
+    return _numPeers;
+}
+
+uint32_t Panel_Sync::getLost() const {
+    uint32_t lost = 0;
+    for (int i = 0; i < _numPeers; i++) lost += _peers[i].lost;
+    return lost;
+}
+
+void Panel_Sync::printStatus(Print& out) {
+    out.printf("🔗 Sync node %08lX, %s, %d peers\n", (unsigned long)_nodeId,
+               !_started ? "off" : isLeader() ? "leader" : "follower", getPeerCount());
+    for (int i = 0; i < _numPeers; i++) {
+        const PanelSyncPeer& peer = _peers[i];
+        out.printf("  %08lX%s seq %lu lost %lu", (unsigned long)peer.nodeId, peer.leader ? " (leader)" : "",
+                   (unsigned long)peer.lastSequence, (unsigned long)peer.lost);
+        out.printf(" %lu ms ago\n", (unsigned long)(millis() - peer.lastHeardMs));
+    }
+    out.printf("  sent %lu received %lu", (unsigned long)_sent, (unsigned long)_received);
+    out.printf(" duplicates %lu rejected %lu", (unsigned long)_duplicates, (unsigned long)_rejected);
+    out.printf(" restarts %lu\n", (unsigned long)_restarts);
+}
@@ -0,0 +1,111 @@
+#ifndef PANEL_SYNC_H
+#define PANEL_SYNC_H
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include <WiFiUdp.h>
+#include "Gain_Fixed.h"
+
+#define PANEL_SYNC_PACKET_SIZE 512
+#define PANEL_SYNC_HEADER_SIZE 16
+#define PANEL_SYNC_ENTRY_SIZE 6
+#define PANEL_SYNC_MAX_ENTRIES ((PANEL_SYNC_PACKET_SIZE - PANEL_SYNC_HEADER_SIZE - 1) / PANEL_SYNC_ENTRY_SIZE)
+
+#ifndef PANEL_SYNC_MAX_PEERS
+#define PANEL_SYNC_MAX_PEERS 8
+#endif
+
+#define PANEL_SYNC_HEARTBEAT_MS 1000
+#define PANEL_SYNC_PEER_TIMEOUT_MS 5000    // A peer not heard from for this long is gone
+#define PANEL_SYNC_ZONE_INTERVAL_MS 50     // Zone changes gathered into one packet
+#define PANEL_SYNC_MAX_PACKETS 8           // Datagrams received per handle() call
+
+enum PanelSyncType {
+    PANEL_SYNC_HEARTBEAT = 1,   // Payload: flags (bit 0: sender is leader)
+    PANEL_SYNC_ZONES = 2        // Payload: count, then count x {zone number, gain in millionths}
+};
+
+struct PanelSyncPeer {
+    uint32_t nodeId;
+    uint32_t bootId;            // Changes when the peer restarts
+    uint32_t lastSequence;
+    unsigned long lastHeardMs;
+    uint32_t lost;              // Sequence numbers skipped
+    bool leader;                // As last claimed by the peer
+};
+
+struct PanelSyncEntry {
+    uint16_t zoneNumber;
+    FixedGain gain;             // 0-GAIN_UNITY
+};
+
+// Receives a zone gain published by another controller
+typedef void (*PanelSyncZoneCallback)(int zoneNumber, FixedGain gain);
+
+// Zone state shared between the controllers of one site over UDP multicast.
+// Packets are a 16-byte header ("PS", version, type, node id, boot id,
+// sequence, all big-endian) and a payload. Every controller sends a heartbeat each second;
+// the lowest node id heard in the last 5 s leads: it polls the Mezzo and
+// publishes what it reads, while every controller publishes its own writes.
+// A sequence number per sender drops duplicates and counts losses; a new
+// boot id, drawn at each begin(), starts the sender's sequence afresh.
+class Panel_Sync {
+private:
+    WiFiUDP _udp;
+    IPAddress _group;
+    uint16_t _port;
+    uint32_t _nodeId;
+    uint32_t _bootId;
+    uint32_t _sequence;
+    bool _started;
+    PanelSyncPeer _peers[PANEL_SYNC_MAX_PEERS];
+    int _numPeers;
+    PanelSyncEntry _pending[PANEL_SYNC_MAX_ENTRIES];
+    int _numPending;
+    unsigned long _lastHeartbeatMs;
+    unsigned long _lastZonesMs;
+    unsigned long _lastJoinMs;
+    uint8_t _packet[PANEL_SYNC_PACKET_SIZE];
+    PanelSyncZoneCallback _zoneCallback;
+    uint32_t _sent;
+    uint32_t _received;
+    uint32_t _duplicates;       // Repeated or reordered, dropped
+    uint32_t _rejected;         // Malformed or another version
+    uint32_t _restarts;         // Peers seen with a new boot id
+
+    bool join();
+    void sendHeartbeat();
+    void sendZones();
+    bool sendPacket(PanelSyncType type, size_t payloadLength);
+    void receivePacket(const uint8_t* data, size_t length);
+    PanelSyncPeer* findPeer(uint32_t nodeId, bool create);
+    void expirePeers();
+
+public:
+    // Constructor
+    Panel_Sync(IPAddress group, uint16_t port);
+
+    // Configuration; the group is joined once WiFi is up
+    void setZoneCallback(PanelSyncZoneCallback callback) { _zoneCallback = callback; }
+    void begin(uint32_t nodeId);
+
+    // Call from loop(): receive, heartbeat, send gathered zone changes
+    void handle();
+
+    // Publish a zone's gain with the next zone packet (newest value per zone)
+    void publishZone(int zoneNumber, FixedGain gain);
+
+    // Access
+    bool isLeader();
+    uint32_t getNodeId() const { return _nodeId; }
+    int getPeerCount();
+    uint32_t getSent() const { return _sent; }
+    uint32_t getReceived() const { return _received; }
+    uint32_t getDuplicates() const { return _duplicates; }
+    uint32_t getRejected() const { return _rejected; }
+    uint32_t getRestarts() const { return _restarts; }
+    uint32_t getLost() const;
+    void printStatus(Print& out);
+};
+
+#endif // PANEL_SYNC_H
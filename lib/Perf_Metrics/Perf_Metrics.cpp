@@ -0,0 +1,132 @@
+#include "Perf_Metrics.h"
+
+Perf_Metrics perfMetrics;
+
+static const char* const histogramNames[PERF_HIST_COUNT] = {
+    "put_connect", "put_build", "put_request",
+    "get_connect", "get_request", "get_parse",
+    "uart_dispatch", "loop", "http_serve"
+};
+
+static const char* const counterNames[PERF_COUNTER_COUNT] = {
+    "put_requests", "put_failures", "put_timeouts",
+    "get_requests", "get_failures", "get_timeouts",
+    "connect_failures", "coalesced_updates",
+    "frames_received", "frames_dropped", "vp_deferred",
+    "json_arena_failures"
+};
+
+// Constructor
+Perf_Metrics::Perf_Metrics() {
+    reset();
+}
+
+// Recording
+void Perf_Metrics::record(PerfHistogramId id, uint32_t us) {
+    PerfHistogram& h = _histograms[id];
+    // Bucket = bit length of the value, clamped to the last bucket
+    int bucket = us == 0 ? 0 : 32 - __builtin_clz(us);
+    if (bucket >= PERF_HIST_BUCKETS) bucket = PERF_HIST_BUCKETS - 1;
+    h.buckets[bucket]++;
+    h.count++;
+    h.totalUs += us;
+    if (us > h.maxUs) h.maxUs = us;
+}
+
+void Perf_Metrics::reset() {
+    memset(_histograms, 0, sizeof(_histograms));
+    memset(_counters, 0, sizeof(_counters));
+    _sinceMs = millis();
+}
+
+// Access
+uint32_t Perf_Metrics::bucketUpperUs(int bucket) {
+    if (bucket <= 0) return 0;
+    if (bucket >= 32) return UINT32_MAX;
+    return (1UL << bucket) - 1;
+}
+
+uint32_t Perf_Metrics::percentileUs(PerfHistogramId id, uint8_t percent) const {
+    const PerfHistogram& h = _histograms[id];
+    if (h.count == 0) return 0;
+    uint32_t rank = (uint32_t)(((uint64_t)h.count * percent + 99) / 100);
+    if (rank == 0) rank = 1;
+    uint32_t seen = 0;
+    for (int i = 0; i < PERF_HIST_BUCKETS; i++) {
+        seen += h.buckets[i];
+        if (seen >= rank) {
+            // Never report more than the largest value actually seen
+            uint32_t upper = i == PERF_HIST_BUCKETS - 1 ? h.maxUs : bucketUpperUs(i);
+            return upper < h.maxUs ? upper : h.maxUs;
+        }
+    }
+    return h.maxUs;
+}
+
+const char* Perf_Metrics::histogramName(PerfHistogramId id) {
+    return id < PERF_HIST_COUNT ? histogramNames[id] : "";
+}
+
+const char* Perf_Metrics::counterName(PerfCounterId id) {
+    return id < PERF_COUNTER_COUNT ? counterNames[id] : "";
+}
+
+// Reports (each printf stays below the 64-byte stack buffer of Print::printf)
+void Perf_Metrics::printReport(Print& out) const {
+    out.printf("📈 Metrics over %lu s\n", (millis() - _sinceMs) / 1000);
+    for (int i = 0; i < PERF_COUNTER_COUNT; i++) {
+        out.printf("  %-20s %lu\n", counterNames[i], (unsigned long)_counters[i]);
+    }
+    out.printf("  %-13s%10s%9s%9s%9s%9s\n", "us", "count", "p50", "p90", "p99", "max");
+    for (int i = 0; i < PERF_HIST_COUNT; i++) {
+        PerfHistogramId id = (PerfHistogramId)i;
+        out.printf("  %-13s%10lu", histogramNames[i], (unsigned long)_histograms[i].count);
+        out.printf("%9lu%9lu", (unsigned long)percentileUs(id, 50), (unsigned long)percentileUs(id, 90));
+        out.printf("%9lu%9lu\n", (unsigned long)percentileUs(id, 99), (unsigned long)_histograms[i].maxUs);
+    }
+}
+
+void Perf_Metrics::printSummary(Print& out) const {
+    out.printf("📈 PUT %lu/%lu fail, p99 %lu us", (unsigned long)_counters[PERF_COUNT_PUT_FAILURES],
+               (unsigned long)_counters[PERF_COUNT_PUT_REQUESTS],
+               (unsigned long)percentileUs(PERF_HIST_PUT_REQUEST, 99));
+    out.printf(", loop max %lu us", (unsigned long)_histograms[PERF_HIST_LOOP].maxUs);
+    out.printf(", frames %lu/%lu dropped\n", (unsigned long)_counters[PERF_COUNT_FRAMES_DROPPED],
+               (unsigned long)_counters[PERF_COUNT_FRAMES_RECEIVED]);
+}
+
+// Prometheus text format. Bucket i holds values up to 2^i - 1 us; every
+// second bound is enough for a log2 histogram and halves the scrape size.
+void Perf_Metrics::printPrometheus(Print& out) const {
+    for (int i = 0; i < PERF_COUNTER_COUNT; i++) {
+        out.printf("# TYPE panel_%s_total counter\n", counterNames[i]);
+        out.printf("panel_%s_total %lu\n", counterNames[i], (unsigned long)_counters[i]);
+    }
+
+    out.println("# TYPE panel_latency_seconds histogram");
+    for (int i = 0; i < PERF_HIST_COUNT; i++) {
+        const PerfHistogram& h = _histograms[i];
+        uint32_t cumulative = h.buckets[0] + h.buckets[1];
+        for (int bucket = 2; bucket < PERF_HIST_BUCKETS - 1; bucket += 2) {
+            cumulative += h.buckets[bucket];
+            uint32_t upper = bucketUpperUs(bucket);
+            out.printf("panel_latency_seconds_bucket{op=\"%s\",", histogramNames[i]);
+            out.printf("le=\"%lu.%06lu\"} %lu\n", (unsigned long)(upper / 1000000),
+                       (unsigned long)(upper % 1000000), (unsigned long)cumulative);
+            cumulative += h.buckets[bucket + 1];
+        }
+        out.printf("panel_latency_seconds_bucket{op=\"%s\",", histogramNames[i]);
+        out.printf("le=\"+Inf\"} %lu\n", (unsigned long)h.count);
+        out.printf("panel_latency_seconds_sum{op=\"%s\"} ", histogramNames[i]);
+        out.printf("%lu.%06lu\n", (unsigned long)(h.totalUs / 1000000), (unsigned long)(h.totalUs % 1000000));
+        out.printf("panel_latency_seconds_count{op=\"%s\"} %lu\n", histogramNames[i], (unsigned long)h.count);
+    }
+}
+
+// Scope timer
+PerfScope::PerfScope(PerfHistogramId id) : _id(id), _startUs(micros()) {
+}
+
+PerfScope::~PerfScope() {
+    perfMetrics.record(_id, micros() - _startUs);
+}
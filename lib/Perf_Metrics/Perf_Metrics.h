@@ -0,0 +1,93 @@
+#ifndef PERF_METRICS_H
+#define PERF_METRICS_H
+
+#include <Arduino.h>
+
+// Log2 buckets: bucket 0 counts 0 us, bucket i counts [2^(i-1), 2^i) us.
+// The last bucket also collects everything above ~33 s.
+#define PERF_HIST_BUCKETS 27
+
+// Latency histograms
+enum PerfHistogramId {
+    PERF_HIST_PUT_CONNECT = 0,     // TCP connect before a gain write
+    PERF_HIST_PUT_BUILD,           // JSON payload for a gain write
+    PERF_HIST_PUT_REQUEST,         // Send and wait for the response status
+    PERF_HIST_GET_CONNECT,         // TCP connect before a gain read
+    PERF_HIST_GET_REQUEST,
+    PERF_HIST_GET_PARSE,           // Read and deserialize the response body
+    PERF_HIST_UART_DISPATCH,       // First frame byte seen to callback returned
+    PERF_HIST_LOOP,                // One loop() iteration
+    PERF_HIST_HTTP_SERVE,          // Local HTTP server: request parsed to response written
+    PERF_HIST_COUNT
+};
+
+// Event counters
+enum PerfCounterId {
+    PERF_COUNT_PUT_REQUESTS = 0,
+    PERF_COUNT_PUT_FAILURES,
+    PERF_COUNT_PUT_TIMEOUTS,
+    PERF_COUNT_GET_REQUESTS,
+    PERF_COUNT_GET_FAILURES,
+    PERF_COUNT_GET_TIMEOUTS,
+    PERF_COUNT_CONNECT_FAILURES,
+    PERF_COUNT_COALESCED_UPDATES,  // Gain writes replaced by a newer value before sending
+    PERF_COUNT_FRAMES_RECEIVED,
+    PERF_COUNT_FRAMES_DROPPED,     // Bad header, oversized or truncated frames
+    PERF_COUNT_VP_DEFERRED,        // VP writes held back for a page that is not shown
+    PERF_COUNT_JSON_ARENA_FAILURES,  // JSON document allocations the arena could not serve
+    PERF_COUNTER_COUNT
+};
+
+struct PerfHistogram {
+    uint32_t buckets[PERF_HIST_BUCKETS];
+    uint32_t count;
+    uint32_t maxUs;
+    uint64_t totalUs;
+};
+
+// Fixed-size runtime metrics: no heap, O(1) record and increment.
+// Recorded from loop() context only; reports print straight to a Print.
+class Perf_Metrics {
+private:
+    PerfHistogram _histograms[PERF_HIST_COUNT];
+    uint32_t _counters[PERF_COUNTER_COUNT];
+    unsigned long _sinceMs;
+
+public:
+    // Constructor
+    Perf_Metrics();
+
+    // Recording
+    void record(PerfHistogramId id, uint32_t us);
+    void increment(PerfCounterId id, uint32_t amount = 1) { _counters[id] += amount; }
+    void reset();
+
+    // Access
+    uint32_t getCounter(PerfCounterId id) const { return _counters[id]; }
+    const PerfHistogram& getHistogram(PerfHistogramId id) const { return _histograms[id]; }
+    uint32_t percentileUs(PerfHistogramId id, uint8_t percent) const;  // Upper bound of the bucket
+    unsigned long getSinceMs() const { return _sinceMs; }
+    static uint32_t bucketUpperUs(int bucket);
+    static const char* histogramName(PerfHistogramId id);
+    static const char* counterName(PerfCounterId id);
+
+    // Reports
+    void printReport(Print& out) const;      // Counters and every histogram
+    void printSummary(Print& out) const;     // One line for the heartbeat
+    void printPrometheus(Print& out) const;  // Text exposition format, every other bucket
+};
+
+// Measures the enclosing scope into one histogram
+class PerfScope {
+private:
+    PerfHistogramId _id;
+    uint32_t _startUs;
+
+public:
+    PerfScope(PerfHistogramId id);
+    ~PerfScope();
+};
+
+extern Perf_Metrics perfMetrics;
+
+#endif // PERF_METRICS_H
@@ -0,0 +1,127 @@
+#include "Perf_Trace.h"
+
+Perf_Trace perfTrace;
+
+static const char* const traceNames[PERF_TRACE_COUNT] = {
+    "dmt_frame", "json_build", "tcp_connect", "http_put", "http_get",
+    "json_parse", "wifi_connect", "delay", "gain_refresh"
+};
+
+// Name of the begin event's argument, nullptr when the span has none
+static const char* const traceArgNames[PERF_TRACE_COUNT] = {
+    "vp", "zone", nullptr, "zone", "zone",
+    nullptr, nullptr, "ms", nullptr
+};
+
+// Constructor
+Perf_Trace::Perf_Trace()
+    : _head(0), _count(0), _lastCycles(0), _lastMs(0), _overwritten(0), _enabled(false) {
+}
+
+// Control
+void Perf_Trace::setEnabled(bool enabled) {
+    // The first event after enabling starts a new timeline
+    if (enabled && !_enabled) {
+        _lastCycles = ESP.getCycleCount();
+        _lastMs = millis();
+    }
+    _enabled = enabled;
+}
+
+void Perf_Trace::clear() {
+    _head = 0;
+    _count = 0;
+    _overwritten = 0;
+    _lastCycles = ESP.getCycleCount();
+    _lastMs = millis();
+}
+
+// Recording
+void Perf_Trace::append(PerfTraceId id, PerfTracePhase phase, uint16_t arg) {
+    uint32_t cycles = ESP.getCycleCount();
+    unsigned long nowMs = millis();
+    uint32_t delta = cycles - _lastCycles;
+
+    // Past half a counter period the cycle difference may have wrapped; millis() decides
+    uint32_t cyclesPerMs = getCpuFrequencyMhz() * 1000UL;
+    unsigned long elapsedMs = nowMs - _lastMs;
+    if (elapsedMs > UINT32_MAX / cyclesPerMs / 2) {
+        uint64_t elapsed = (uint64_t)elapsedMs * cyclesPerMs;
+        delta = elapsed > UINT32_MAX ? UINT32_MAX : (uint32_t)elapsed;
+    }
+    _lastCycles = cycles;
+    _lastMs = nowMs;
+
+    if (_count == PERF_TRACE_BUFFER_EVENTS) {
+        _head = (_head + 1) % PERF_TRACE_BUFFER_EVENTS;
+        _count--;
+        _overwritten++;
+    }
+    PerfTraceEvent& event = _ring[(_head + _count) % PERF_TRACE_BUFFER_EVENTS];
+    event.deltaCycles = delta;
+    event.id = (uint8_t)id;
+    event.phase = (uint8_t)phase;
+    event.arg = arg;
+    _count++;
+}
+
+const char* Perf_Trace::traceName(PerfTraceId id) {
+    return id < PERF_TRACE_COUNT ? traceNames[id] : "";
+}
+
+// Dump (each print stays below the 64-byte stack buffer of Print::printf).
+// End events whose begin was overwritten are left out so spans still nest.
+void Perf_Trace::dump(Print& out) const {
+    uint32_t mhz = getCpuFrequencyMhz();
+    uint64_t cycles = 0;
+    int depth = 0;
+    bool first = true;
+
+    out.println("{\"traceEvents\":[");
+    for (size_t i = 0; i < _count; i++) {
+        const PerfTraceEvent& event = _ring[(_head + i) % PERF_TRACE_BUFFER_EVENTS];
+        // The oldest event's delta points at an overwritten one
+        if (i > 0) cycles += event.deltaCycles;
+        if (event.phase == PERF_TRACE_END) {
+            if (depth == 0) continue;
+            depth--;
+        } else {
+            depth++;
+        }
+
+        PerfTraceId id = (PerfTraceId)event.id;
+        out.printf("%s{\"name\":\"%s\",\"ph\":\"%c\"", first ? "" : ",\n", traceName(id),
+                   event.phase == PERF_TRACE_END ? 'E' : 'B');
+        first = false;
+
+        uint64_t us = cycles / mhz;
+        unsigned long ns = (unsigned long)(cycles % mhz * 1000 / mhz);
+        unsigned long seconds = (unsigned long)(us / 1000000);
+        if (seconds > 0) {
+            out.printf(",\"ts\":%lu%06lu.%03lu", seconds, (unsigned long)(us % 1000000), ns);
+        } else {
+            out.printf(",\"ts\":%lu.%03lu", (unsigned long)us, ns);
+        }
+        out.print(",\"pid\":1,\"tid\":1");
+        if (event.phase == PERF_TRACE_BEGIN && traceArgNames[id] != nullptr) {
+            out.printf(",\"args\":{\"%s\":%u}", traceArgNames[id], (unsigned)event.arg);
+        }
+        out.print("}");
+    }
+    out.printf("\n],\"displayTimeUnit\":\"ms\",\"otherData\":{\"overwritten\":%lu}}\n",
+               (unsigned long)_overwritten);
+}
+
+// Scope span
+PerfTraceScope::PerfTraceScope(PerfTraceId id, uint16_t arg) : _id(id) {
+    perfTrace.begin(id, arg);
+}
+
+PerfTraceScope::~PerfTraceScope() {
+    perfTrace.end(_id);
+}
+
+void tracedDelay(unsigned long ms) {
+    PerfTraceScope scope(PERF_TRACE_DELAY, ms > 0xFFFF ? 0xFFFF : (uint16_t)ms);
+    delay(ms);
+}
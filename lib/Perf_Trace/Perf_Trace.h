@@ -0,0 +1,95 @@
+#ifndef PERF_TRACE_H
+#define PERF_TRACE_H
+
+#include <Arduino.h>
+
+// Events kept in the trace ring (8 bytes each); the oldest are overwritten
+#ifndef PERF_TRACE_BUFFER_EVENTS
+#define PERF_TRACE_BUFFER_EVENTS 1024
+#endif
+
+// Trace spans, shown by name on the timeline
+enum PerfTraceId {
+    PERF_TRACE_DMT_FRAME = 0,      // One panel frame parsed and dispatched (arg: VP address)
+    PERF_TRACE_JSON_BUILD,         // Gain payload (arg: zone number)
+    PERF_TRACE_TCP_CONNECT,
+    PERF_TRACE_HTTP_PUT,           // Send and wait for the Mezzo's status (arg: zone number)
+    PERF_TRACE_HTTP_GET,
+    PERF_TRACE_JSON_PARSE,         // Read and deserialize a GET response
+    PERF_TRACE_WIFI_CONNECT,       // WiFi_Manager::connectToWiFi()
+    PERF_TRACE_DELAY,              // Blocking delay() in WiFi_Manager (arg: ms)
+    PERF_TRACE_GAIN_REFRESH,       // Periodic gain read of every zone
+    PERF_TRACE_COUNT
+};
+
+enum PerfTracePhase {
+    PERF_TRACE_BEGIN = 0,
+    PERF_TRACE_END = 1
+};
+
+// Timestamps are CPU cycles since the previous event, so a dropped oldest
+// event costs nothing but its own span. Gaps beyond one counter period
+// (26.8 s at 160 MHz) are cut to that period.
+struct PerfTraceEvent {
+    uint32_t deltaCycles;
+    uint8_t id;
+    uint8_t phase;
+    uint16_t arg;
+};
+
+// Begin/end trace points into a RAM ring, dumped as Chrome trace-event JSON
+// (chrome://tracing, ui.perfetto.dev). Disabled by default; begin() and end()
+// are a single branch while off. Loop context only.
+class Perf_Trace {
+private:
+    PerfTraceEvent _ring[PERF_TRACE_BUFFER_EVENTS];
+    size_t _head;           // Index of the oldest event
+    size_t _count;
+    uint32_t _lastCycles;
+    unsigned long _lastMs;
+    uint32_t _overwritten;
+    bool _enabled;
+
+public:
+    // Constructor
+    Perf_Trace();
+
+    // Control
+    void setEnabled(bool enabled);
+    bool isEnabled() const { return _enabled; }
+    void clear();
+
+    // Recording
+    void begin(PerfTraceId id, uint16_t arg = 0) {
+        if (_enabled) append(id, PERF_TRACE_BEGIN, arg);
+    }
+    void end(PerfTraceId id) {
+        if (_enabled) append(id, PERF_TRACE_END, 0);
+    }
+    void append(PerfTraceId id, PerfTracePhase phase, uint16_t arg);
+
+    // Access
+    size_t getEventCount() const { return _count; }
+    uint32_t getOverwritten() const { return _overwritten; }
+    static const char* traceName(PerfTraceId id);
+
+    // {"traceEvents":[...]} with B/E events in microseconds since the oldest event
+    void dump(Print& out) const;
+};
+
+// Traces the enclosing scope as one span
+class PerfTraceScope {
+private:
+    PerfTraceId _id;
+
+public:
+    PerfTraceScope(PerfTraceId id, uint16_t arg = 0);
+    ~PerfTraceScope();
+};
+
+// delay() shown on the timeline
+void tracedDelay(unsigned long ms);
+
+extern Perf_Trace perfTrace;
+
+#endif // PERF_TRACE_H
@@ -1,13 +1,15 @@
 #include "WiFi_Manager.h"
+#include "Perf_Trace.h"
 
 // Constructor
-WiFi_Manager::WiFi_Manager(WiFiNetwork* networks, int numNetworks, DMT_Display* display)
+WiFi_Manager::WiFi_Manager(WiFiNetwork* networks, int numNetworks, DMT_Panels* display)
     : _networks(networks), _numNetworks(numNetworks), _display(display),
-      _lastWiFiCheck(0), _lastRSSIUpdate(0), _autoReconnect(false) {
+      _lastWiFiCheck(0), _lastRSSIUpdate(0), _autoReconnect(false),
+      _reconnectAttempts(0), _reconnects(0), _connectedNetwork(-1) {
 }
 
 // Configuration
-void WiFi_Manager::setDisplay(DMT_Display* display) {
+void WiFi_Manager::setDisplay(DMT_Panels* display) {
     _display = display;
 }
 
@@ -22,10 +24,11 @@ void WiFi_Manager::setRSSIUpdateInterval(unsigned long interval) {
 
 // Connection management
 bool WiFi_Manager::connectToWiFi() {
+    PerfTraceScope trace(PERF_TRACE_WIFI_CONNECT);
     Serial.println("🔄 Starting WiFi connection...");
     WiFi.mode(WIFI_STA);
     WiFi.disconnect();
-    delay(1000);
+    tracedDelay(1000);
 
     // Scan for available networks
     scanAndPrintNetworks();
@@ -44,7 +47,7 @@ bool WiFi_Manager::connectToWiFi() {
 
         int attempts = 0;
         while (WiFi.status() != WL_CONNECTED && attempts < 30) {
-            delay(500);
+            tracedDelay(500);
             Serial.print(".");
             attempts++;
             if (attempts % 10 == 0) {
@@ -64,16 +67,18 @@ bool WiFi_Manager::connectToWiFi() {
             Serial.print("  MAC Address: ");
             Serial.println(WiFi.macAddress());
 
+            _connectedNetwork = netIdx;
             showConnectionSuccess(ssid, getCurrentRSSI());
             connected = true;
             break; // Stop after first successful connection
         } else {
-            Serial.println("\n✗ WiFi Connection failed for SSID: " + String(ssid));
+            Serial.print("\n✗ WiFi Connection failed for SSID: ");
+            Serial.println(ssid);
             Serial.printf("  Final WiFi Status: %d\n", WiFi.status());
             
             showConnectionFailure(ssid);
             WiFi.disconnect();
-            delay(500);
+            tracedDelay(500);
         }
     }
 
@@ -96,22 +101,29 @@ int WiFi_Manager::getCurrentRSSI() {
     return 0;
 }
 
-String WiFi_Manager::getCurrentSSID() {
-    if (isConnected()) {
-        return WiFi.SSID();
+// The SSID comes from the network table rather than WiFi.SSID(), which builds a String
+const char* WiFi_Manager::getCurrentSSID() {
+    if (isConnected() && _connectedNetwork >= 0) {
+        return _networks[_connectedNetwork].ssid;
     }
     return "";
 }
 
-String WiFi_Manager::getLocalIP() {
+const char* WiFi_Manager::getLocalIP() {
+    _localIP.clear();
     if (isConnected()) {
-        return WiFi.localIP().toString();
+        IPAddress ip = WiFi.localIP();
+        _localIP.appendf("%u.%u.%u.%u", ip[0], ip[1], ip[2], ip[3]);
     }
-    return "";
+    return _localIP.c_str();
 }
 
-String WiFi_Manager::getMacAddress() {
-    return WiFi.macAddress();
+const char* WiFi_Manager::getMacAddress() {
+    uint8_t mac[6];
+    WiFi.macAddress(mac);
+    _macAddress.clear();
+    _macAddress.appendf("%02X:%02X:%02X:%02X:%02X:%02X", mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
+    return _macAddress.c_str();
 }
 
 // Periodic tasks (call in main loop)
@@ -122,7 +134,8 @@ void WiFi_Manager::handleAutoReconnect() {
         if (!isConnected()) {
             Serial.println("⚠️  WiFi disconnected, attempting to reconnect...");
             showDisconnected();
-            connectToWiFi();
+            _reconnectAttempts++;
+            if (connectToWiFi()) _reconnects++;
         } else {
             // Ensure WiFi icon is ON when connected
             if (_display) {
@@ -159,60 +172,62 @@ void WiFi_Manager::showConnectionAttempt(const char* ssid, const char* password)
     if (_display) {
         // Clear VP 0x3200 with 40 spaces before showing new connection message
         _display->clearText(0x3200, 40);
-        delay(50);
+        tracedDelay(50);
         
-        String connectMsg = "Connecting to " + String(ssid) + " : " + String(password);
+        Fixed_String<128> connectMsg;   // 32-byte SSID and 63-byte passphrase at most
+        connectMsg.appendf("Connecting to %s : %s", ssid, password);
         _display->showConnectionStatus(connectMsg.c_str(), 0x3200);
-        delay(100);
+        tracedDelay(100);
     }
 }
 
 void WiFi_Manager::showConnectionSuccess(const char* ssid, int rssi) {
     if (_display) {
         // Show success message with RSSI
-        String wifiMsg = "Wifi Connected RSSI = " + String(rssi);
+        Fixed_String<32> wifiMsg;
+        wifiMsg.appendf("Wifi Connected RSSI = %d", rssi);
         _display->showConnectionStatus(wifiMsg.c_str(), 0x3300);
-        delay(100);
+        tracedDelay(100);
 
         // Clear error message area
         _display->clearText(0x3400, 12);
-        delay(100);
+        tracedDelay(100);
 
         // Turn on WiFi icon
         _display->showWiFiIcon(true);
-        delay(100);
+        tracedDelay(100);
     }
 }
 
 void WiFi_Manager::showConnectionFailure(const char* ssid) {
     if (_display) {
         _display->showConnectionStatus("...", 0x3300);
-        delay(100);
+        tracedDelay(100);
         _display->showConnectionError("Wifi failed", 0x3400);
-        delay(100);
+        tracedDelay(100);
         _display->showWiFiIcon(false);
-        delay(100);
+        tracedDelay(100);
     }
 }
 
 void WiFi_Manager::showAllConnectionsFailed() {
     if (_display) {
         _display->showConnectionStatus("All Wifi failed", 0x3300);
-        delay(100);
+        tracedDelay(100);
         _display->showConnectionError("Wifi failed", 0x3400);
-        delay(100);
+        tracedDelay(100);
         _display->showWiFiIcon(false);
-        delay(100);
+        tracedDelay(100);
     }
 }
 
 void WiFi_Manager::showDisconnected() {
     if (_display) {
         _display->showWiFiIcon(false);
-        delay(100);
+        tracedDelay(100);
         _display->showConnectionStatus("...", 0x3300);
-        delay(100);
+        tracedDelay(100);
         _display->showConnectionError("Wifi failed", 0x3400);
-        delay(100);
+        tracedDelay(100);
     }
 }
@@ -3,7 +3,8 @@
 
 #include <Arduino.h>
 #include <WiFi.h>
-#include "DMT_Display.h"
+#include "DMT_Panels.h"
+#include "Fixed_String.h"
 
 struct WiFiNetwork {
     const char* ssid;
@@ -14,17 +15,22 @@ class WiFi_Manager {
 private:
     WiFiNetwork* _networks;
     int _numNetworks;
-    DMT_Display* _display;
+    DMT_Panels* _display;          // Every panel shows the WiFi status
     unsigned long _lastWiFiCheck;
     unsigned long _lastRSSIUpdate;
     bool _autoReconnect;
+    uint32_t _reconnectAttempts;   // Auto-reconnects after a lost link
+    uint32_t _reconnects;          // ... of which succeeded
+    int _connectedNetwork;         // Index into _networks, -1 before the first connection
+    Fixed_String<16> _localIP;     // Text returned by getLocalIP()
+    Fixed_String<18> _macAddress;  // Text returned by getMacAddress()
     
 public:
     // Constructor
-    WiFi_Manager(WiFiNetwork* networks, int numNetworks, DMT_Display* display = nullptr);
+    WiFi_Manager(WiFiNetwork* networks, int numNetworks, DMT_Panels* display = nullptr);
     
     // Configuration
-    void setDisplay(DMT_Display* display);
+    void setDisplay(DMT_Panels* display);
     void setAutoReconnect(bool enable, unsigned long checkInterval = 5000);
     void setRSSIUpdateInterval(unsigned long interval = 10000);
     
@@ -32,9 +38,12 @@ public:
     bool connectToWiFi();
     bool isConnected();
     int getCurrentRSSI();
-    String getCurrentSSID();
-    String getLocalIP();
-    String getMacAddress();
+    // Text valid until the next call of the same getter; "" while disconnected
+    const char* getCurrentSSID();
+    const char* getLocalIP();
+    const char* getMacAddress();
+    uint32_t getReconnectAttempts() const { return _reconnectAttempts; }
+    uint32_t getReconnects() const { return _reconnects; }
     
     // Periodic tasks (call in main loop)
     void handleAutoReconnect();
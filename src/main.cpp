@@ -6,8 +6,18 @@
 
 // Include custom libraries first
 #include "DMT_Display.h"
+#include "DMT_Panels.h"
 #include "WiFi_Manager.h"
 #include "Mezzo_Controller.h"
+#include "Perf_Metrics.h"
+#include "DMT_Capture.h"
+#include "Perf_Trace.h"
+#include "Event_Log.h"
+#include "Http_Server.h"
+#include "Osc_Input.h"
+#include "Panel_Sync.h"
+#include "Json_Arena.h"
+#include "Alloc_Trace.h"
 
 #include "message.h" // Include message arrays for DMT display
 
@@ -15,6 +25,38 @@
 #define LED_PIN 8           // Built-in LED
 #define UART_TX_PIN 21      // UART TX for DMT touchscreen
 #define UART_RX_PIN 20      // UART RX for DMT touchscreen
+#define UART2_TX_PIN 7      // UART TX for a second DMT touchscreen
+#define UART2_RX_PIN 6      // UART RX for a second DMT touchscreen
+
+// Panel UART rate: panels boot at DMT_BOOT_BAUD and are switched to DMT_BAUD_RATE
+#define DMT_BOOT_BAUD 115200
+#define DMT_BAUD_RATE 460800
+
+// Drive a second panel on UART 0; both show and control the same zones
+#define DMT_SECOND_PANEL false
+
+// Page holding the zone sliders; slider writes wait while another page is shown
+#define DMT_ZONE_PAGE 0
+#define DMT_PAGE_POLL_MS 1000
+
+// Print the metrics summary line with every heartbeat (toggle with "metrics heartbeat on|off")
+#define METRICS_IN_HEARTBEAT true
+
+// Record DGUS frames into the RAM capture ring from boot (toggle with "capture on|off")
+#define DMT_CAPTURE_AT_BOOT false
+
+// Record trace spans into the RAM trace ring from boot (toggle with "trace on|off")
+#define PERF_TRACE_AT_BOOT false
+
+// Local HTTP server (GET /metrics for Prometheus, /api/zones for cached zone state)
+#define HTTP_SERVER_PORT 80
+
+// OSC over UDP for show control (/zone/<n>/gain, /zone/<n>/volume)
+#define OSC_PORT 9000
+
+// Zone state shared with the other panels on the network; the lowest node id polls the Mezzo
+#define PANEL_SYNC_GROUP IPAddress(239, 255, 42, 99)
+#define PANEL_SYNC_PORT 5099
 
 // WiFi credentials in priority order
 WiFiNetwork wifiNetworks[] = {
@@ -39,22 +81,36 @@ const int numZones = sizeof(zones) / sizeof(zones[0]);
 
 // Create instances of our custom libraries
 HardwareSerial DMTSerial(1);
+HardwareSerial DMTSerial2(0);
 DMT_Display dmtDisplay(&DMTSerial);
-WiFi_Manager wifiManager(wifiNetworks, numWifiNetworks, &dmtDisplay);
+DMT_Display dmtDisplay2(&DMTSerial2);
+DMT_Panels dmtPanels;
+WiFi_Manager wifiManager(wifiNetworks, numWifiNetworks, &dmtPanels);
 Mezzo_Controller mezzoController(mezzoIP, mezzoPort);
+Http_Server httpServer(HTTP_SERVER_PORT);
+Osc_Input oscInput(OSC_PORT);
+Panel_Sync panelSync(PANEL_SYNC_GROUP, PANEL_SYNC_PORT);
+
+// Memory for the JSON documents of one API request, emptied after each
+static Json_Arena jsonArena;
 
 // Global variables for volume change tracking
 static unsigned long lastVolumeChangeTime = 0;
 static uint16_t pendingVPAddress = 0;
 static bool pendingGainRead = false;
+static bool metricsInHeartbeat = METRICS_IN_HEARTBEAT;
+static bool resyncRequested = false;
 
-// Callback function for VP data received from DMT
-void onVPDataReceived(uint16_t vpAddress, uint16_t vpData) {
-  uint8_t lowByte = vpData & 0xFF;
-  Serial.printf("🔊 VP: 0x%04X = 0x%04X (Vol: %d)\n", vpAddress, vpData, lowByte);
+// Callback function for VP data received from any DMT panel
+void onVPDataReceived(uint8_t panel, uint16_t vpAddress, uint16_t vpData) {
+  ELOG_DEBUG(ELOG_VP_RECEIVED, vpAddress, vpData);
+  
+  // Queue the volume for the Mezzo; a newer value for the zone replaces it until loop() sends it
+  if (!mezzoController.queueVolumeWithVPData(vpAddress, vpData)) return;
   
-  // Send volume to Mezzo controller
-  mezzoController.sendVolumeToZoneWithVPData(vpAddress, vpData);
+  // Move the slider on the other panels. The upload is word count and volume
+  // (0x01VV); slider words are written as 0xVV00
+  dmtPanels.mirrorVP(panel, vpAddress, mezzoController.mapGainToVP(mezzoController.calculateGainFromVPData(vpData)));
   
   // Schedule gain readback after 2 seconds
   lastVolumeChangeTime = millis();
@@ -62,17 +118,175 @@ void onVPDataReceived(uint16_t vpAddress, uint16_t vpData) {
   pendingGainRead = true;
 }
 
+// GET /metrics in Prometheus text format, printed straight from the counters
+void handleMetricsRequest(const HttpRequest& request, Http_Response& response) {
+  (void)request;
+  response.begin(200, "text/plain; version=0.0.4; charset=utf-8");
+  response.printf("panel_uptime_seconds %lu\n", millis() / 1000);
+  response.printf("panel_heap_free_bytes %lu\n", (unsigned long)ESP.getFreeHeap());
+  response.printf("panel_heap_min_free_bytes %lu\n", (unsigned long)ESP.getMinFreeHeap());
+  response.printf("panel_heap_max_alloc_bytes %lu\n", (unsigned long)ESP.getMaxAllocHeap());
+#ifdef ESP_PLATFORM
+  response.printf("panel_stack_min_free_bytes{task=\"loop\"} %lu\n",
+                  (unsigned long)uxTaskGetStackHighWaterMark(nullptr));
+  response.printf("panel_stack_min_free_bytes{task=\"event_log\"} %lu\n",
+                  (unsigned long)eventLog.getTaskStackFree());
+#endif
+  response.printf("panel_wifi_connected %d\n", wifiManager.isConnected() ? 1 : 0);
+  response.printf("panel_wifi_rssi_dbm %d\n", (int)WiFi.RSSI());
+  response.println("# TYPE panel_wifi_reconnect_attempts_total counter");
+  response.printf("panel_wifi_reconnect_attempts_total %lu\n", (unsigned long)wifiManager.getReconnectAttempts());
+  response.println("# TYPE panel_wifi_reconnects_total counter");
+  response.printf("panel_wifi_reconnects_total %lu\n", (unsigned long)wifiManager.getReconnects());
+  response.println("# TYPE panel_log_dropped_total counter");
+  response.printf("panel_log_dropped_total %lu\n", (unsigned long)eventLog.getDropped());
+  response.println("# TYPE panel_http_served_total counter");
+  response.printf("panel_http_served_total %lu\n", (unsigned long)httpServer.getServed());
+  response.println("# TYPE panel_http_rejected_total counter");
+  response.printf("panel_http_rejected_total %lu\n", (unsigned long)httpServer.getRejected());
+  response.println("# TYPE panel_osc_messages_total counter");
+  response.printf("panel_osc_messages_total %lu\n", (unsigned long)oscInput.getMessages());
+  response.println("# TYPE panel_osc_rejected_total counter");
+  response.printf("panel_osc_rejected_total %lu\n", (unsigned long)oscInput.getRejected());
+  response.printf("panel_json_arena_bytes %lu\n", (unsigned long)Json_Arena::getSize());
+  response.printf("panel_json_arena_peak_bytes %lu\n", (unsigned long)jsonArena.getPeak());
+  for (int i = 0; i < dmtPanels.getCount(); i++) {
+    response.printf("panel_dmt_baud{panel=\"%d\"} %lu\n", i, dmtPanels.get(i).getBaudRate());
+  }
+  response.printf("panel_sync_leader %d\n", panelSync.isLeader() ? 1 : 0);
+  response.printf("panel_sync_peers %d\n", panelSync.getPeerCount());
+  response.println("# TYPE panel_sync_sent_total counter");
+  response.printf("panel_sync_sent_total %lu\n", (unsigned long)panelSync.getSent());
+  response.println("# TYPE panel_sync_received_total counter");
+  response.printf("panel_sync_received_total %lu\n", (unsigned long)panelSync.getReceived());
+  response.println("# TYPE panel_sync_duplicates_total counter");
+  response.printf("panel_sync_duplicates_total %lu\n", (unsigned long)panelSync.getDuplicates());
+  response.println("# TYPE panel_sync_restarts_total counter");
+  response.printf("panel_sync_restarts_total %lu\n", (unsigned long)panelSync.getRestarts());
+  response.println("# TYPE panel_sync_lost_total counter");
+  response.printf("panel_sync_lost_total %lu\n", (unsigned long)panelSync.getLost());
+  perfMetrics.printPrometheus(response);
+  allocTrace.printPrometheus(response);
+  mezzoController.printPrometheus(response);
+}
+
+// Gain set from the network (REST or OSC): queued like a touch, so bursts from
+// any client coalesce into one write per zone, and mirrored on the panel's slider
+void applyRemoteGain(int zoneIdx, FixedGain gain) {
+  mezzoController.queueGain(zoneIdx, gain);
+  dmtPanels.writeVP(mezzoController.getZone(zoneIdx).vpAddr, mezzoController.mapGainToVP(gain));
+}
+
+// OSC zone input, checked like the REST API
+bool onOscZone(int zoneNumber, OscZoneParam param, float value) {
+  int zoneIdx = mezzoController.findZoneByNumber(zoneNumber);
+  if (zoneIdx < 0) return false;
+  FixedGain gain;
+  if (param == OSC_ZONE_GAIN) {
+    if (value < 0.0f || value > 1.0f) return false;
+    gain = gainFromFloat(value);
+  } else {
+    if (value < 0.0f || value > 100.0f) return false;
+    gain = gainFromVolume((int)lroundf(value));
+  }
+  applyRemoteGain(zoneIdx, gain);
+  return true;
+}
+
+// Every gain the Mezzo accepted or reported goes to the other panels
+void onZoneGain(int zoneIdx, FixedGain gain) {
+  panelSync.publishZone(mezzoController.getZone(zoneIdx).zoneNumber, gain);
+}
+
+// A gain published by another panel; a zone with a queued write keeps this panel's newer value
+void onSyncZone(int zoneNumber, FixedGain gain) {
+  int zoneIdx = mezzoController.findZoneByNumber(zoneNumber);
+  if (zoneIdx < 0 || mezzoController.getZone(zoneIdx).writePending) return;
+  mezzoController.setCachedGain(zoneIdx, gain);
+  dmtPanels.writeVP(mezzoController.getZone(zoneIdx).vpAddr, mezzoController.mapGainToVP(gain));
+}
+
+// Zone index from "/api/zones/<Mezzo zone number>", -1 if there is no such zone
+int zoneFromPath(const char* path) {
+  const char* number = path + strlen("/api/zones/");
+  char* end;
+  long zoneNumber = strtol(number, &end, 10);
+  if (end == number || *end != '\0') return -1;
+  return mezzoController.findZoneByNumber((int)zoneNumber);
+}
+
+void replyJsonError(Http_Response& response, int status, const char* message) {
+  response.begin(status, "application/json");
+  response.printf("{\"error\":\"%s\"}\n", message);
+}
+
+// GET /api/zones: cached zone state, answered without a request to the Mezzo
+void handleZonesRequest(const HttpRequest& request, Http_Response& response) {
+  (void)request;
+  response.begin(200, "application/json");
+  mezzoController.printZonesJson(response);
+}
+
+// GET /api/zones/<zone>
+void handleZoneGetRequest(const HttpRequest& request, Http_Response& response) {
+  int zoneIdx = zoneFromPath(request.path);
+  if (zoneIdx < 0) return replyJsonError(response, 404, "unknown zone");
+  response.begin(200, "application/json");
+  mezzoController.printZoneJson(response, zoneIdx);
+  response.println();
+}
+
+// PUT /api/zones/<zone> with {"gain":0.0-1.0} or {"volume":0-100} (the panel's scale)
+void handleZonePutRequest(const HttpRequest& request, Http_Response& response) {
+  int zoneIdx = zoneFromPath(request.path);
+  if (zoneIdx < 0) return replyJsonError(response, 404, "unknown zone");
+
+  JsonArenaScope arenaScope(jsonArena);
+  JsonDocument doc(&jsonArena);
+  DeserializationError error = deserializeJson(doc, request.body, request.bodyLength);
+  if (error == DeserializationError::NoMemory) return replyJsonError(response, 413, "JSON too large");
+  if (error) return replyJsonError(response, 400, "invalid JSON");
+  FixedGain gain;
+  if (doc["gain"].is<float>()) {
+    float value = doc["gain"].as<float>();
+    if (value < 0.0f || value > 1.0f) return replyJsonError(response, 400, "gain out of range");
+    gain = gainFromFloat(value);
+  } else if (doc["volume"].is<int>()) {
+    int volume = doc["volume"].as<int>();
+    if (volume < 0 || volume > 100) return replyJsonError(response, 400, "volume out of range");
+    gain = gainFromVolume(volume);
+  } else {
+    return replyJsonError(response, 400, "expected gain or volume");
+  }
+
+  applyRemoteGain(zoneIdx, gain);
+  response.begin(202, "application/json");
+  mezzoController.printZoneJson(response, zoneIdx);
+  response.println();
+}
+
 // Callback function for WiFi failure
 void onWiFiFailure() {
   Serial.println("⚠️  WiFi disconnected detected after HTTP failure");
-  dmtDisplay.showWiFiIcon(false);
-  dmtDisplay.showConnectionStatus("...", 0x3300);
-  dmtDisplay.showConnectionError("Wifi failed", 0x3400);
+  dmtPanels.showWiFiIcon(false);
+  dmtPanels.showConnectionStatus("...", 0x3300);
+  dmtPanels.showConnectionError("Wifi failed", 0x3400);
+}
+
+// Switch a panel to DMT_BAUD_RATE; it stays at its current rate if it does not answer
+void negotiatePanelBaud(int panel) {
+  DMT_Display& display = dmtPanels.get(panel);
+  if (display.negotiateBaud(DMT_BAUD_RATE)) {
+    Serial.printf("✓ Panel %d at %lu baud\n", panel, display.getBaudRate());
+  } else {
+    Serial.printf("⚠️  Panel %d stays at %lu baud\n", panel, display.getBaudRate());
+  }
 }
 
 void setup() {
   // Initialize USB CDC Serial
   Serial.begin(115200);
+  eventLog.begin(Serial);
   delay(2000); // Give time for Serial to initialize
   
   Serial.println("\n=== ESP32-C3 DMT Remote Controller ===");
@@ -81,13 +295,25 @@ void setup() {
   pinMode(LED_PIN, OUTPUT);
 
   // Initialize DMT Display
-  dmtDisplay.begin(115200, UART_RX_PIN, UART_TX_PIN);
-  dmtDisplay.setVPDataCallback(onVPDataReceived);
-  Serial.println("✓ DMT UART initialized (115200 baud, pins TX:" + String(UART_TX_PIN) + " RX:" + String(UART_RX_PIN) + ")");
+  dmtCapture.setEnabled(DMT_CAPTURE_AT_BOOT);
+  perfTrace.setEnabled(PERF_TRACE_AT_BOOT);
+  dmtDisplay.begin(DMT_BOOT_BAUD, UART_RX_PIN, UART_TX_PIN);
+  dmtPanels.add(&dmtDisplay);
+  Serial.println("✓ DMT UART initialized (" + String(DMT_BOOT_BAUD) + " baud, pins TX:" + String(UART_TX_PIN) + " RX:" + String(UART_RX_PIN) + ")");
+  if (DMT_SECOND_PANEL) {
+    dmtDisplay2.begin(DMT_BOOT_BAUD, UART2_RX_PIN, UART2_TX_PIN);
+    dmtPanels.add(&dmtDisplay2);
+    Serial.println("✓ Second DMT UART initialized (pins TX:" + String(UART2_TX_PIN) + " RX:" + String(UART2_RX_PIN) + ")");
+  }
+  dmtPanels.setVPDataCallback(onVPDataReceived);
+  for (int i = 0; i < dmtPanels.getCount(); i++) negotiatePanelBaud(i);
+  for (int i = 0; i < numZones; i++) dmtPanels.bindWidgetPage(zones[i].vpAddr, DMT_ZONE_PAGE);
+  dmtPanels.requestPage();
 
   // Initialize Mezzo Controller
   mezzoController.setZones(zones, numZones);
   mezzoController.setWiFiFailureCallback(onWiFiFailure);
+  mezzoController.setZoneGainCallback(onZoneGain);
 
   // Initialize WiFi Manager
   wifiManager.setAutoReconnect(true, 5000);  // Auto reconnect every 5 seconds
@@ -96,23 +322,35 @@ void setup() {
   Serial.println("✓ Hardware initialization complete");
 
   // Show booting message
-  dmtDisplay.showBootMessage("Booting...");
+  dmtPanels.showBootMessage("Booting...");
   delay(100);
 
   // Start WiFi connection
   if (wifiManager.connectToWiFi()) {
     Serial.println("🔄 Initial volume update after WiFi connection...");
     // Update all zones with current gain values
-    for (int i = 0; i < numZones; i++) {
-      float currentGain = mezzoController.readGainFromZone(zones[i].vpAddr);
-      if (currentGain > 0.0f) {
+    for (int i = 0; i < mezzoController.getNumZones(); i++) {
+      uint16_t vpAddr = mezzoController.getZone(i).vpAddr;
+      FixedGain currentGain = mezzoController.readGainFromZone(vpAddr);
+      if (currentGain > 0) {
         uint16_t vpData = mezzoController.mapGainToVP(currentGain);
-        dmtDisplay.writeVP(zones[i].vpAddr, vpData);
+        dmtPanels.writeVP(vpAddr, vpData);
         delay(200);
       }
     }
   }
 
+  // Serve /metrics, the zone API and OSC; the sockets start listening once WiFi is up
+  httpServer.on("GET", "/metrics", handleMetricsRequest);
+  httpServer.on("GET", "/api/zones", handleZonesRequest);
+  httpServer.on("GET", "/api/zones/*", handleZoneGetRequest);
+  httpServer.on("PUT", "/api/zones/*", handleZonePutRequest);
+  httpServer.begin();
+  oscInput.setZoneCallback(onOscZone);
+  oscInput.begin();
+  panelSync.setZoneCallback(onSyncZone);
+  panelSync.begin((uint32_t)(ESP.getEfuseMac() >> 16));
+
   Serial.println("=== System Ready ===\n");
 }
 
@@ -149,7 +387,7 @@ void connectToWiFi() {
     const char* password = tryNetworks[netIdx].password;
 
     String connectMsg = "Connecting to " + String(ssid) + " : " + String(password);
-    dmtDisplay.writeText(0x3200, connectMsg.c_str());
+    dmtPanels.writeText(0x3200, connectMsg.c_str());
     delay(50);
 
     Serial.print(">>> Attempting to connect to: ");
@@ -178,9 +416,9 @@ void connectToWiFi() {
       Serial.print("  MAC Address: ");
       Serial.println(WiFi.macAddress());
 
-      dmtDisplay.writeText(0x3300, "Wifi Connected");
+      dmtPanels.writeText(0x3300, "Wifi Connected");
       delay(50);
-      dmtDisplay.writeText(0x3400, "            ");
+      dmtPanels.writeText(0x3400, "            ");
       delay(50);
       uint8_t wifiOnCommand[] = {
         0x5A, 0xA5,
@@ -194,9 +432,9 @@ void connectToWiFi() {
     } else {
       Serial.println("\n✗ WiFi Connection failed for this network!");
       Serial.printf("  Final WiFi Status: %d\n", WiFi.status());
-      dmtDisplay.writeText(0x3300, "...");
+      dmtPanels.writeText(0x3300, "...");
       delay(50);
-      dmtDisplay.writeText(0x3400, "Wifi failed");
+      dmtPanels.writeText(0x3400, "Wifi failed");
       delay(50);
       uint8_t wifiOffCommand[] = {
         0x5A, 0xA5,
@@ -214,9 +452,9 @@ void connectToWiFi() {
 
   if (!connected) {
     Serial.println("\n✗ All WiFi attempts failed!");
-    dmtDisplay.writeText(0x3300, "...");
+    dmtPanels.writeText(0x3300, "...");
     delay(50);
-    dmtDisplay.writeText(0x3400, "Wifi failed");
+    dmtPanels.writeText(0x3400, "Wifi failed");
     delay(50);
     uint8_t wifiOffCommand[] = {
       0x5A, 0xA5,
@@ -313,9 +551,9 @@ void checkWiFiAfterHTTPFailure() {
     delay(100);
     
     // Show disconnection message
-    dmtDisplay.writeText(0x3300, "...");
+    dmtPanels.writeText(0x3300, "...");
     delay(100);
-    dmtDisplay.writeText(0x3400, "Wifi failed");
+    dmtPanels.writeText(0x3400, "Wifi failed");
     delay(100);
   }
 }
@@ -868,7 +1106,179 @@ void handleDMTData() {
 }
 */
 
+// Wire time at each panel rate: a burst of 100 slider frames, one refresh of
+// every zone, and a register read round trip. Sliders are rewritten with the
+// words in the panel's VP shadow, so they keep what they show; zones without a
+// shadow entry are left alone. Ends back at DMT_BAUD_RATE.
+void runBaudBenchmark() {
+  static const unsigned long rates[] = {115200, 230400, 460800, 921600};
+  DMT_Display& display = dmtPanels.get(0);
+  int numZones = mezzoController.getNumZones();
+  uint16_t value;
+  int shown = 0;
+  for (int i = 0; i < numZones; i++) {
+    if (display.getShadowVP(mezzoController.getZone(i).vpAddr, value)) shown++;
+  }
+  if (shown == 0) {
+    Serial.println("⚠️  No slider in the VP shadow yet");
+    return;
+  }
+  Serial.println("   baud  frames/s  refresh ms  round trip ms");
+  for (size_t r = 0; r < sizeof(rates) / sizeof(rates[0]); r++) {
+    if (!display.negotiateBaud(rates[r])) {
+      Serial.printf("%7lu  no answer\n", rates[r]);
+      continue;
+    }
+    uint32_t start = micros();
+    for (int n = 0, i = 0; n < 100; i = (i + 1) % numZones) {
+      uint16_t vpAddr = mezzoController.getZone(i).vpAddr;
+      if (!display.getShadowVP(vpAddr, value)) continue;
+      display.writeVP(vpAddr, value);
+      n++;
+    }
+    display.flush();
+    uint32_t burstUs = micros() - start;
+
+    start = micros();
+    for (int i = 0; i < numZones; i++) {
+      uint16_t vpAddr = mezzoController.getZone(i).vpAddr;
+      if (display.getShadowVP(vpAddr, value)) display.writeVP(vpAddr, value);
+    }
+    display.flush();
+    uint32_t refreshUs = micros() - start;
+
+    start = micros();
+    bool answered = display.ping();
+    uint32_t roundTripUs = micros() - start;
+    Serial.printf("%7lu  %8lu  %10.2f", rates[r], burstUs > 0 ? 100000000UL / burstUs : 0UL, refreshUs / 1000.0f);
+    if (answered) Serial.printf("  %13.2f\n", roundTripUs / 1000.0f);
+    else Serial.println("  no answer");
+  }
+  if (display.getDeferredCount() > 0) Serial.println("⚠️  Sliders not shown, writes were deferred");
+  negotiatePanelBaud(0);
+}
+
+// Short system counters for the "stats" command
+void printStats() {
+  Serial.printf("⏱  Uptime %lu s, loop max %lu us\n", millis() / 1000,
+                (unsigned long)perfMetrics.getHistogram(PERF_HIST_LOOP).maxUs);
+  Serial.printf("🧠 Heap free %lu, min %lu bytes\n", (unsigned long)ESP.getFreeHeap(),
+                (unsigned long)ESP.getMinFreeHeap());
+  Serial.printf("🧱 Allocs %lu, %lu in no-alloc regions\n", (unsigned long)allocTrace.getAllocations(),
+                (unsigned long)allocTrace.getViolations());
+  Serial.printf("📶 WiFi %s, RSSI %d dBm\n", wifiManager.isConnected() ? "up" : "down", (int)WiFi.RSSI());
+  Serial.printf("📝 Log %s, %lu pending, %lu dropped\n", Event_Log::levelName(eventLog.getLevel()),
+                (unsigned long)eventLog.getPending(), (unsigned long)eventLog.getDropped());
+  Serial.printf("⏺  Capture %lu frames, trace %lu events\n", (unsigned long)dmtCapture.getRecordCount(),
+                (unsigned long)perfTrace.getEventCount());
+  perfMetrics.printSummary(Serial);
+}
+
+// Runtime log threshold; levels compiled out by EVENT_LOG_LEVEL cannot be enabled
+void setLogLevel(const char* name) {
+  for (uint8_t level = EVENT_LOG_LEVEL_NONE; level <= EVENT_LOG_LEVEL_DEBUG; level++) {
+    if (strcmp(name, Event_Log::levelName(level)) == 0) {
+      eventLog.setLevel(level);
+      if (eventLog.getLevel() != level) {
+        Serial.printf("⚠️  Built with log level %s\n", Event_Log::levelName(EVENT_LOG_LEVEL));
+      }
+      Serial.printf("📝 Log level %s\n", Event_Log::levelName(eventLog.getLevel()));
+      return;
+    }
+  }
+  Serial.printf("❓ Unknown log level: %s\n", name);
+}
+
+// USB serial console commands, parsed one line at a time from loop(); see "help"
+void handleConsoleCommand(const char* command) {
+  if (strcmp(command, "help") == 0) {
+    Serial.println("stats | metrics [reset] | metrics heartbeat on|off | heap [reset]");
+    Serial.println("zones | vp | discover | resync | sync | baud [bench]");
+    Serial.println("log level none|error|warn|info|debug");
+    Serial.println("capture on|off|dump|clear | trace on|off|dump|clear");
+  } else if (strcmp(command, "stats") == 0) {
+    printStats();
+  } else if (strcmp(command, "zones") == 0) {
+    mezzoController.printZones(Serial);
+  } else if (strcmp(command, "vp") == 0) {
+    dmtPanels.printShadow(Serial);
+  } else if (strcmp(command, "discover") == 0) {
+    // Blocks for a few seconds per endpoint; only ever run on request
+    mezzoController.discoverEndpoints();
+  } else if (strcmp(command, "resync") == 0) {
+    resyncRequested = true;
+    Serial.println("🔄 Gain refresh scheduled");
+  } else if (strcmp(command, "baud") == 0) {
+    for (int i = 0; i < dmtPanels.getCount(); i++) {
+      Serial.printf("🔌 Panel %d at %lu baud\n", i, dmtPanels.get(i).getBaudRate());
+    }
+  } else if (strcmp(command, "baud bench") == 0) {
+    runBaudBenchmark();
+  } else if (strcmp(command, "sync") == 0) {
+    panelSync.printStatus(Serial);
+  } else if (strcmp(command, "log") == 0) {
+    Serial.printf("📝 Log level %s\n", Event_Log::levelName(eventLog.getLevel()));
+  } else if (strncmp(command, "log level ", 10) == 0) {
+    setLogLevel(command + 10);
+  } else if (strcmp(command, "metrics") == 0) {
+    perfMetrics.printReport(Serial);
+  } else if (strcmp(command, "metrics reset") == 0) {
+    perfMetrics.reset();
+    Serial.println("📈 Metrics reset");
+  } else if (strcmp(command, "heap") == 0) {
+    allocTrace.printReport(Serial);
+  } else if (strcmp(command, "heap reset") == 0) {
+    allocTrace.reset();
+    Serial.println("🧱 Allocation counts reset");
+  } else if (strcmp(command, "metrics heartbeat on") == 0) {
+    metricsInHeartbeat = true;
+  } else if (strcmp(command, "metrics heartbeat off") == 0) {
+    metricsInHeartbeat = false;
+  } else if (strcmp(command, "capture on") == 0) {
+    dmtCapture.setEnabled(true);
+    Serial.println("⏺  DMT capture on");
+  } else if (strcmp(command, "capture off") == 0) {
+    dmtCapture.setEnabled(false);
+    Serial.printf("⏹  DMT capture off, %lu frames\n", (unsigned long)dmtCapture.getRecordCount());
+  } else if (strcmp(command, "capture dump") == 0) {
+    dmtCapture.dump(Serial);
+  } else if (strcmp(command, "capture clear") == 0) {
+    dmtCapture.clear();
+  } else if (strcmp(command, "trace on") == 0) {
+    perfTrace.setEnabled(true);
+    Serial.println("⏺  Trace on");
+  } else if (strcmp(command, "trace off") == 0) {
+    perfTrace.setEnabled(false);
+    Serial.printf("⏹  Trace off, %lu events\n", (unsigned long)perfTrace.getEventCount());
+  } else if (strcmp(command, "trace dump") == 0) {
+    perfTrace.dump(Serial);
+  } else if (strcmp(command, "trace clear") == 0) {
+    perfTrace.clear();
+  } else if (command[0] != '\0') {
+    Serial.printf("❓ Unknown command: %s\n", command);
+  }
+}
+
+// Non-blocking line reader for the USB serial port
+void handleConsoleInput() {
+  static char line[32];
+  static int lineLength = 0;
+  while (Serial.available()) {
+    char c = (char)Serial.read();
+    if (c == '\r' || c == '\n') {
+      line[lineLength] = '\0';
+      handleConsoleCommand(line);
+      lineLength = 0;
+    } else if (lineLength < (int)sizeof(line) - 1) {
+      line[lineLength++] = c;
+    }
+  }
+}
+
 void loop() {
+  PerfScope loopScope(PERF_HIST_LOOP);
+  AllocRegionScope allocScope(ALLOC_REGION_LOOP);
+  
   // Blink LED to show system is running
   static unsigned long lastBlink = 0;
   if (millis() - lastBlink > 1000) {
@@ -883,47 +1293,92 @@ void loop() {
   wifiManager.updateRSSIDisplay();
   
   // Handle incoming DMT data
-  dmtDisplay.handleIncomingData();
+  dmtPanels.handleIncomingData();
+  
+  // Follow page changes made on the panel; the reply arrives through handleIncomingData()
+  static unsigned long lastPagePoll = 0;
+  if (millis() - lastPagePoll >= DMT_PAGE_POLL_MS) {
+    dmtPanels.requestPage();
+    lastPagePoll = millis();
+  }
+  
+  // A panel that stopped answering at the fast rate has probably restarted at its boot rate
+  for (int i = 0; i < dmtPanels.getCount(); i++) {
+    DMT_Display& display = dmtPanels.get(i);
+    if (display.isLinkLost() && display.getBaudRate() != DMT_BOOT_BAUD) {
+      display.setBaud(DMT_BOOT_BAUD);
+      negotiatePanelBaud(i);
+    }
+  }
+  
+  // Handle commands typed on the USB serial port
+  handleConsoleInput();
+  
+  // Print queued log records (the ESP32 does this from a background task)
+  eventLog.poll();
+  
+  // Serve at most one request from the local HTTP server
+  httpServer.handleClient();
+  
+  // Take a few OSC datagrams
+  oscInput.handlePackets();
+  
+  // Exchange zone state with the other panels
+  panelSync.handle();
+  
+  // Send the newest queued gain of one zone to the Mezzo
+  mezzoController.service();
   
   // Non-blocking gain readback after volume changes
   if (pendingGainRead && (millis() - lastVolumeChangeTime >= 2000)) {
-    float actualGain = mezzoController.readGainFromZone(pendingVPAddress);
-    if (actualGain > 0.0f) {
+    FixedGain actualGain = mezzoController.readGainFromZone(pendingVPAddress);
+    if (actualGain > 0) {
       uint16_t actualVPData = mezzoController.mapGainToVP(actualGain);
-      dmtDisplay.writeVP(pendingVPAddress, actualVPData);
+      dmtPanels.writeVP(pendingVPAddress, actualVPData);
     }
     pendingGainRead = false;
   }
   
+  // Largest free block and fragmentation, every ALLOC_TRACE_SAMPLE_MS
+  allocTrace.poll();
+  
   // Show system heartbeat every 60 seconds
   static unsigned long lastHeartbeat = 0;
   if (millis() - lastHeartbeat > 60000) {
     Serial.printf("💓 System Heartbeat - Uptime: %lu seconds, Free Heap: %d bytes\n", 
                   millis() / 1000, ESP.getFreeHeap());
+    if (metricsInHeartbeat) perfMetrics.printSummary(Serial);
     lastHeartbeat = millis();
   }
   
-  // Periodically read current gain from Mezzo and update DMT display
+  // Periodically read current gain from Mezzo and update DMT display; only the
+  // sync leader polls, the other panels take its readings from panelSync
   static unsigned long lastGainUpdate = 0;
-  if (millis() - lastGainUpdate > 15000) { // Every 15 seconds
-    if (wifiManager.isConnected()) {
-      // Read and update all zones
-      for (int i = 0; i < numZones; i++) {
-        float currentGain = mezzoController.readGainFromZone(zones[i].vpAddr);
-        if (currentGain > 0.0f) {
+  if (resyncRequested || millis() - lastGainUpdate > 15000) { // Every 15 seconds or on "resync"
+    if (wifiManager.isConnected() && (resyncRequested || panelSync.isLeader())) {
+      PerfTraceScope trace(PERF_TRACE_GAIN_REFRESH);
+      // Read and update all zones; touches keep being queued in between, and a
+      // zone with a queued write keeps the panel's newer value
+      for (int i = 0; i < mezzoController.getNumZones(); i++) {
+        uint16_t vpAddr = mezzoController.getZone(i).vpAddr;
+        FixedGain currentGain = mezzoController.readGainFromZone(vpAddr);
+        dmtPanels.handleIncomingData();
+        if (currentGain > 0 && !mezzoController.getZone(i).writePending) {
           uint16_t vpData = mezzoController.mapGainToVP(currentGain);
-          dmtDisplay.writeVP(zones[i].vpAddr, vpData);
+          dmtPanels.writeVP(vpAddr, vpData);
           delay(100);
+          dmtPanels.handleIncomingData();
         }
       }
     }
     lastGainUpdate = millis();
+    resyncRequested = false;
   }
   
   // Optional: Send command to read VP address 0x1000 every 60 seconds for testing
   static unsigned long lastVPRead = 0;
   if (millis() - lastVPRead > 60000) {
-    dmtDisplay.readVP(0x1000);
+    dmtPanels.readVP(0x1000);
     lastVPRead = millis();
   }
 }